@@ -84,6 +84,11 @@ void WiFiManager::addParameter(WiFiManagerParameter *p) {
   DEBUG_WM(p->getID());
 }
 
+void WiFiManager::removeParameters() {
+  _paramsCount = 0;
+  _params[0] = NULL;
+}
+
 void WiFiManager::setupConfigPortal() {
   dnsServer.reset(new DNSServer());
   server.reset(new ESP8266WebServer(80));
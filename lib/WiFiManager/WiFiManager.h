@@ -115,6 +115,8 @@ class WiFiManager
     void          setSaveConfigCallback( void (*func)(void) );
     //adds a custom parameter
     void          addParameter(WiFiManagerParameter *p);
+    //forgets all custom parameters, they are owned (and freed) by the caller
+    void          removeParameters();
     //if this is set, it will exit after config, even if connection is unsuccessful.
     void          setBreakAfterConfig(boolean shouldBreak);
     //if this is set, try WPS setup when starting (this will delay config portal for up to 2 mins)
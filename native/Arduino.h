@@ -0,0 +1,105 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Host (Linux) stand-in for the ESP8266 Arduino core, used by the "native" PlatformIO
+  environment. Only what the firmware sources compiled there use is provided, with the
+  behaviour of core 2.4. Pins go nowhere, time comes from the host clock or from a manual
+  clock driven by the tests (see native.hpp).
+*/
+
+#pragma once
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#define F_CPU 80000000L
+#define ICACHE_FLASH_ATTR
+#define ICACHE_RAM_ATTR
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x00
+#define INPUT_PULLUP 0x02
+#define OUTPUT 0x01
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+void interrupts(void);
+void noInterrupts(void);
+
+char* dtostrf(double number, signed char width, unsigned char prec, char *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+// NodeMCU pin names
+static const uint8_t D0 = 16;
+static const uint8_t D1 = 5;
+static const uint8_t D2 = 4;
+static const uint8_t D3 = 0;
+static const uint8_t D4 = 2;
+static const uint8_t D5 = 14;
+static const uint8_t D6 = 12;
+static const uint8_t D7 = 13;
+static const uint8_t D8 = 15;
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <functional>
+#include "pgmspace.h"
+
+using std::min;
+using std::max;
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+#include "WString.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+#include "Updater.h"
+#include "debug.h"
+#endif
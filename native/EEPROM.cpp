@@ -0,0 +1,94 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "EEPROM.h"
+#include "Esp.h"
+
+EEPROMClass EEPROM;
+
+extern "C" uint32_t _SPIFFS_end;
+
+namespace {
+const size_t c_sector_size = 4096;
+const uint32_t c_flash_mapped_at = 0x40200000;
+
+// the sector after SPIFFS, as in the device's flash layout
+uint32_t sector()
+{
+  return ((uint32_t) (uintptr_t) &_SPIFFS_end - c_flash_mapped_at) / c_sector_size;
+}
+}
+
+void EEPROMClass::begin(size_t size)
+{
+  if (size == 0)
+    return;
+  if (size > c_sector_size)
+    size = c_sector_size;
+  size = (size + 3) & ~3;
+
+  m_data.resize(size);
+  ESP.flashRead(sector() * c_sector_size, (uint32_t*) m_data.data(), size);
+  m_size = size;
+  m_dirty = false;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+  if (address < 0 || (size_t) address >= m_size)
+    return 0;
+  return m_data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+  if (address < 0 || (size_t) address >= m_size)
+    return;
+  if (m_data[address] != value) {
+    m_data[address] = value;
+    m_dirty = true;
+  }
+}
+
+bool EEPROMClass::commit()
+{
+  if (m_size == 0)
+    return false;
+  if (!m_dirty)
+    return true;
+  if (!ESP.flashEraseSector(sector()) || !ESP.flashWrite(sector() * c_sector_size, (uint32_t*) m_data.data(), m_size))
+    return false;
+  m_dirty = false;
+  return true;
+}
+
+void EEPROMClass::end()
+{
+  if (m_size == 0)
+    return;
+  commit();
+  m_data.clear();
+  m_data.shrink_to_fit();
+  m_size = 0;
+}
+
+void EEPROMClass::erase()
+{
+  ESP.flashEraseSector(sector());
+}
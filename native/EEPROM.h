@@ -0,0 +1,70 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  EEPROM emulation of the core: begin() copies the stored bytes from their flash sector (after
+  SPIFFS, see Esp.cpp) to RAM, commit() and end() erase the sector and write them back.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+class EEPROMClass
+{
+public:
+  EEPROMClass() : m_size(0), m_dirty(false) {}
+
+  void begin(size_t size);
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  bool commit();
+  void end();
+
+  uint8_t* getDataPtr() { m_dirty = true; return m_data.data(); }
+  const uint8_t* getConstDataPtr() const { return m_data.data(); }
+  size_t length() { return m_size; }
+
+  template<typename T> T& get(int address, T& t)
+  {
+    if (address >= 0 && address + sizeof(T) <= m_size)
+      memcpy((uint8_t*) &t, m_data.data() + address, sizeof(T));
+    return t;
+  }
+
+  template<typename T> const T& put(int address, const T& t)
+  {
+    if (address >= 0 && address + sizeof(T) <= m_size) {
+      memcpy(m_data.data() + address, (const uint8_t*) &t, sizeof(T));
+      m_dirty = true;
+    }
+    return t;
+  }
+
+  // host only, erases the stored bytes
+  void erase();
+private:
+  std::vector<uint8_t> m_data;
+  size_t m_size;
+  bool m_dirty;
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,103 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "ESP8266HTTPClient.h"
+#include <strings.h>
+
+bool HTTPClient::begin(const String& url)
+{
+  const String scheme = "http://";
+  if (url.indexOf(scheme) != 0)
+    return false;
+  const int path_start = url.indexOf('/', scheme.length());
+  const String host_port = url.substring(scheme.length(), path_start == -1 ? url.length() : path_start);
+  m_path = (path_start == -1) ? String("/") : url.substring(path_start);
+  const int colon = host_port.indexOf(':');
+  m_host = (colon == -1) ? host_port : host_port.substring(0, colon);
+  m_port = (colon == -1) ? 80 : host_port.substring(colon + 1).toInt();
+  m_headers = "";
+  m_size = -1;
+  return true;
+}
+
+void HTTPClient::end()
+{
+  m_client.stop();
+}
+
+void HTTPClient::addHeader(const String& name, const String& value)
+{
+  m_headers += name + ": " + value + "\r\n";
+}
+
+void HTTPClient::collectHeaders(const char *header_keys[], const size_t count)
+{
+  m_collected.clear();
+  for (size_t i=0;i<count;++i)
+    m_collected.push_back(Header{header_keys[i], ""});
+}
+
+bool HTTPClient::readLine(String& line)
+{
+  line = "";
+  int c;
+  while ((c = m_client.read()) != -1) {
+    if (c == '\n')
+      return true;
+    if (c != '\r')
+      line += (char) c;
+  }
+  return false;
+}
+
+int HTTPClient::GET()
+{
+  if (!m_client.connect(m_host.c_str(), m_port))
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  m_client.print("GET " + m_path + " HTTP/1.1\r\nHost: " + m_host + "\r\nUser-Agent: " + m_user_agent + "\r\n" +
+    m_headers + "Connection: close\r\n\r\n");
+
+  // "HTTP/1.1 200 OK", then headers up to an empty line; the body is left in the stream
+  String line;
+  if (!readLine(line) || line.indexOf(' ') == -1)
+    return HTTPC_ERROR_READ_TIMEOUT;
+  const int code = line.substring(line.indexOf(' ') + 1).toInt();
+  while (readLine(line) && line.length() > 0) {
+    const int colon = line.indexOf(':');
+    if (colon == -1)
+      continue;
+    String name = line.substring(0, colon);
+    String value = line.substring(colon + 1);
+    value.trim();
+    if (name.equalsIgnoreCase("Content-Length"))
+      m_size = value.toInt();
+    for (Header& header : m_collected)
+      if (name.equalsIgnoreCase(header.name))
+        header.value = value;
+  }
+  return code;
+}
+
+String HTTPClient::header(const char *name)
+{
+  for (const Header& header : m_collected)
+    if (strcasecmp(header.name.c_str(), name) == 0)
+      return header.value;
+  return "";
+}
@@ -0,0 +1,69 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  HTTPClient of the core (ESP8266HTTPClient), the subset used by the firmware download. It
+  talks HTTP/1.1 to WiFiClient's fake server, so the responses queued there are raw HTTP.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "WString.h"
+#include "ESP8266WiFi.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_MODIFIED 304
+
+class HTTPClient
+{
+public:
+  HTTPClient() : m_port(80), m_size(-1) {}
+
+  bool begin(const String& url); // http:// only
+  void end();
+  void setTimeout(uint16_t timeout) { (void) timeout; }
+  void setUserAgent(const String& user_agent) { m_user_agent = user_agent; }
+  void addHeader(const String& name, const String& value);
+  void collectHeaders(const char *header_keys[], const size_t count);
+
+  int GET();
+  int getSize() { return m_size; } // Content-Length, -1 if not sent
+  String header(const char *name);
+  WiFiClient* getStreamPtr() { return &m_client; }
+private:
+  struct Header {
+    String name;
+    String value;
+  };
+  bool readLine(String& line);
+
+  String m_host;
+  uint16_t m_port;
+  String m_path;
+  String m_user_agent;
+  String m_headers; // request headers, as sent
+  std::vector<Header> m_collected; // response headers asked for by collectHeaders()
+  int m_size;
+  WiFiClient m_client;
+};
@@ -0,0 +1,102 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "ESP8266WiFi.h"
+#include <string.h>
+#include <queue>
+
+ESP8266WiFiClass WiFi;
+
+namespace {
+std::queue<std::vector<uint8_t>> g_responses;
+std::vector<String> g_requests;
+}
+
+void WiFiClient::serve(const String& response)
+{
+  serve(std::vector<uint8_t>(response.c_str(), response.c_str() + response.length()));
+}
+
+void WiFiClient::serve(const std::vector<uint8_t>& response)
+{
+  g_responses.push(response);
+}
+
+std::vector<String>& WiFiClient::getRequests()
+{
+  return g_requests;
+}
+
+void WiFiClient::reset()
+{
+  g_responses = std::queue<std::vector<uint8_t>>();
+  g_requests.clear();
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+  stop();
+  if (g_responses.empty())
+    return 0;
+  m_response = std::move(g_responses.front());
+  g_responses.pop();
+  m_read = 0;
+  m_connected = true;
+  g_requests.push_back(String(host) + ":" + String(port) + "\n");
+  return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+  if (!m_connected)
+    return 0;
+  g_requests.back().concat((const char*) buffer, size);
+  return size;
+}
+
+int WiFiClient::available()
+{
+  return m_connected ? m_response.size() - m_read : 0;
+}
+
+int WiFiClient::read()
+{
+  return available() > 0 ? m_response[m_read++] : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+  const size_t length = std::min(size, (size_t) available());
+  memcpy(buffer, m_response.data() + m_read, length);
+  m_read += length;
+  return length;
+}
+
+// the server closes the connection after its response, data already received can still be read
+uint8_t WiFiClient::connected()
+{
+  return available() > 0;
+}
+
+void WiFiClient::stop()
+{
+  m_connected = false;
+  m_response.clear();
+  m_read = 0;
+}
@@ -0,0 +1,67 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  WiFi of the core (ESP8266WiFi): the station is always connected. Every WiFiClient connection
+  goes to a fake server, which answers with the next response queued by WiFiClient::serve()
+  and closes the connection; with nothing queued the server is unreachable. What the firmware
+  sends is kept per connection, see getRequests().
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "WString.h"
+#include "Print.h"
+
+class WiFiClient : public Print
+{
+public:
+  WiFiClient() : m_connected(false), m_read(0) {}
+
+  int connect(const char *host, uint16_t port);
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override;
+  int available();
+  int read();
+  int read(uint8_t *buffer, size_t size);
+  uint8_t connected();
+  void stop();
+
+  // host only
+  static void serve(const String& response);
+  static void serve(const std::vector<uint8_t>& response);
+  static std::vector<String>& getRequests(); // "host:port" and what was sent, per connection
+  static void reset(); // drops queued responses and requests
+private:
+  bool m_connected;
+  std::vector<uint8_t> m_response;
+  size_t m_read;
+};
+
+class ESP8266WiFiClass
+{
+public:
+  String macAddress() { return "5C:CF:7F:00:00:01"; }
+  String softAPmacAddress() { return "5E:CF:7F:00:00:01"; }
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,173 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "Esp.h"
+#include "native.hpp"
+#include "MD5Builder.h"
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+EspClass ESP;
+
+/* The linker script of the device defines these around the SPIFFS area, ParameterStore keeps
+   its log in the first sectors. Same size as in the 4M (1M SPIFFS) layout of a NodeMCU. */
+asm(".pushsection .bss\n"
+  ".balign 4096\n"
+  ".globl _SPIFFS_start\n"
+  "_SPIFFS_start:\n"
+  ".skip 0xFB000\n"
+  ".globl _SPIFFS_end\n"
+  "_SPIFFS_end:\n"
+  ".popsection\n");
+
+namespace {
+const uint32_t c_sector_size = 4096;
+const size_t c_rtc_user_memory = 512;
+
+std::map<uint32_t, std::vector<uint8_t>> g_flash; // by sector, erased sectors are missing
+uint32_t g_sketch_size = 0;
+bool g_power_cut = false;
+bool g_power_lost = false; // a write hit the cut, nothing reaches the flash anymore
+uint32_t g_flash_bytes_left = 0;
+uint32_t g_restarts = 0;
+uint8_t g_rtc_memory[c_rtc_user_memory] = {};
+
+bool isAligned(const uint32_t offset, const size_t size)
+{
+  return (offset % 4) == 0 && (size % 4) == 0;
+}
+}
+
+namespace Native {
+void setSketch(const uint8_t *data, const uint32_t size)
+{
+  for (uint32_t sector=0;sector*c_sector_size<size;++sector)
+    g_flash.erase(sector);
+  for (uint32_t i=0;i<size;++i) {
+    auto& sector = g_flash[i / c_sector_size];
+    sector.resize(c_sector_size, 0xFF);
+    sector[i % c_sector_size] = data[i];
+  }
+  g_sketch_size = size;
+}
+
+void eraseFlash()
+{
+  g_flash.clear();
+  g_sketch_size = 0;
+  powerOn();
+}
+
+void cutPowerAfterFlashBytes(const uint32_t bytes)
+{
+  g_power_cut = true;
+  g_power_lost = false;
+  g_flash_bytes_left = bytes;
+}
+
+void powerOn()
+{
+  g_power_cut = false;
+  g_power_lost = false;
+}
+
+uint32_t getRestarts()
+{
+  return g_restarts;
+}
+}
+
+void EspClass::restart()
+{
+  ++g_restarts;
+}
+
+uint32_t EspClass::getSketchSize()
+{
+  return g_sketch_size;
+}
+
+String EspClass::getSketchMD5()
+{
+  MD5Builder md5;
+  md5.begin();
+  uint32_t buffer[64];
+  for (uint32_t offset=0;offset<g_sketch_size;offset+=sizeof(buffer)) {
+    const uint32_t length = std::min((uint32_t) sizeof(buffer), g_sketch_size - offset);
+    flashRead(offset, buffer, sizeof(buffer));
+    md5.add((const uint8_t*) buffer, length);
+  }
+  md5.calculate();
+  return md5.toString();
+}
+
+bool EspClass::flashEraseSector(uint32_t sector)
+{
+  if (g_power_lost)
+    return false;
+  g_flash.erase(sector);
+  return true;
+}
+
+bool EspClass::flashWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+  if (!isAligned(offset, size))
+    return false;
+  const uint8_t *bytes = (const uint8_t*) data;
+  for (size_t i=0;i<size;++i) {
+    if (g_power_lost || (g_power_cut && g_flash_bytes_left-- == 0)) {
+      g_power_lost = true;
+      return false;
+    }
+    auto& sector = g_flash[(offset + i) / c_sector_size];
+    sector.resize(c_sector_size, 0xFF);
+    sector[(offset + i) % c_sector_size] &= bytes[i];
+  }
+  return true;
+}
+
+bool EspClass::flashRead(uint32_t offset, uint32_t *data, size_t size)
+{
+  if (!isAligned(offset, size))
+    return false;
+  uint8_t *bytes = (uint8_t*) data;
+  for (size_t i=0;i<size;++i) {
+    const auto sector = g_flash.find((offset + i) / c_sector_size);
+    bytes[i] = (sector == g_flash.end()) ? 0xFF : sector->second[(offset + i) % c_sector_size];
+  }
+  return true;
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+{
+  if (offset * 4 + size > c_rtc_user_memory)
+    return false;
+  memcpy(data, g_rtc_memory + offset * 4, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+  if (offset * 4 + size > c_rtc_user_memory)
+    return false;
+  memcpy(g_rtc_memory + offset * 4, data, size);
+  return true;
+}
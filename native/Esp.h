@@ -0,0 +1,61 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  ESP class of the core. Flash is emulated in RAM, sector by sector as it's touched: erased
+  sectors read as 0xFF and writes can only clear bits, like on the chip. Reads and writes
+  have to be 4 byte aligned, as the SDK requires. The running sketch is at flash offset 0,
+  it can be set with Native::setSketch(). RTC user memory lives as long as the process, so it
+  survives restart() like on the device.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+class EspClass
+{
+public:
+  void wdtFeed() {}
+  void restart();
+
+  // the host heap isn't limited, a typical free heap of the device is reported
+  uint32_t getFreeHeap() { return 40000; }
+  uint32_t getChipId() { return 0x00c0ffee; }
+  const char* getSdkVersion() { return "native"; }
+  String getResetReason() { return "External System"; }
+  String getResetInfo() { return "External System"; }
+
+  uint32_t getSketchSize();
+  String getSketchMD5();
+  uint32_t getFreeSketchSpace() { return 1024 * 1024 - 4096 - getSketchSize(); }
+  uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+  uint32_t getFlashChipRealSize() { return getFlashChipSize(); }
+
+  // offset in 4 byte blocks, 512 bytes of user memory
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+
+  bool flashEraseSector(uint32_t sector);
+  bool flashWrite(uint32_t offset, uint32_t *data, size_t size);
+  bool flashRead(uint32_t offset, uint32_t *data, size_t size);
+};
+
+extern EspClass ESP;
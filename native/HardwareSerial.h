@@ -0,0 +1,48 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Serial port, written to stdout (unless muted, see Native::setSerialOutput()).
+*/
+
+#pragma once
+#include "Print.h"
+
+class HardwareSerial : public Print
+{
+public:
+  HardwareSerial() : m_output(true) {}
+
+  void begin(unsigned long baud) { (void) baud; }
+  void end() {}
+  void setDebugOutput(bool enabled) { (void) enabled; }
+  int available() { return 0; }
+  int read() { return -1; }
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+
+  void setOutput(const bool output) { m_output = output; }
+private:
+  bool m_output;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,114 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "MD5Builder.h"
+#include <string.h>
+
+namespace {
+const uint32_t c_sines[64] = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+const uint8_t c_shifts[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+uint32_t rotateLeft(const uint32_t x, const uint8_t n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+}
+
+void MD5Builder::begin()
+{
+  m_state[0] = 0x67452301;
+  m_state[1] = 0xefcdab89;
+  m_state[2] = 0x98badcfe;
+  m_state[3] = 0x10325476;
+  m_length = 0;
+  memset(m_digest, 0, sizeof(m_digest));
+}
+
+void MD5Builder::transform(const uint8_t *block)
+{
+  uint32_t words[16];
+  for (uint8_t i=0;i<16;++i)
+    words[i] = block[i*4] | (block[i*4+1] << 8) | (block[i*4+2] << 16) | ((uint32_t) block[i*4+3] << 24);
+
+  uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+  for (uint8_t i=0;i<64;++i) {
+    uint32_t f;
+    uint8_t g;
+    if (i < 16) { f = (b & c) | (~b & d); g = i; }
+    else if (i < 32) { f = (d & b) | (~d & c); g = (5*i + 1) % 16; }
+    else if (i < 48) { f = b ^ c ^ d; g = (3*i + 5) % 16; }
+    else { f = c ^ (b | ~d); g = (7*i) % 16; }
+    const uint32_t rotated = rotateLeft(a + f + c_sines[i] + words[g], c_shifts[(i / 16) * 4 + i % 4]);
+    a = d;
+    d = c;
+    c = b;
+    b += rotated;
+  }
+  m_state[0] += a;
+  m_state[1] += b;
+  m_state[2] += c;
+  m_state[3] += d;
+}
+
+void MD5Builder::add(const uint8_t *data, const uint16_t length)
+{
+  for (uint16_t i=0;i<length;++i) {
+    m_buffer[m_length % 64] = data[i];
+    ++m_length;
+    if (m_length % 64 == 0)
+      transform(m_buffer);
+  }
+}
+
+void MD5Builder::calculate()
+{
+  const uint64_t bits = m_length * 8;
+  const uint8_t pad = 0x80, zero = 0;
+  add(&pad, 1);
+  while (m_length % 64 != 56)
+    add(&zero, 1);
+  for (uint8_t i=0;i<8;++i) {
+    const uint8_t byte = (uint8_t) (bits >> (8*i));
+    add(&byte, 1);
+  }
+  for (uint8_t i=0;i<16;++i)
+    m_digest[i] = (uint8_t) (m_state[i / 4] >> (8 * (i % 4)));
+}
+
+void MD5Builder::getBytes(uint8_t *output) const
+{
+  memcpy(output, m_digest, sizeof(m_digest));
+}
+
+String MD5Builder::toString() const
+{
+  char hex[33];
+  for (uint8_t i=0;i<16;++i)
+    sprintf(hex + i*2, "%02x", m_digest[i]);
+  return String(hex);
+}
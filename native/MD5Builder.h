@@ -0,0 +1,44 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  MD5Builder of the core (RFC 1321).
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+class MD5Builder
+{
+public:
+  void begin();
+  void add(const uint8_t *data, const uint16_t length);
+  void calculate();
+  void getBytes(uint8_t *output) const;
+  String toString() const;
+private:
+  void transform(const uint8_t *block);
+
+  uint32_t m_state[4];
+  uint64_t m_length;
+  uint8_t m_buffer[64];
+  uint8_t m_digest[16];
+};
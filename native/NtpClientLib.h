@@ -0,0 +1,38 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  NtpClientLib 2.0 subset, formatting the time of TimeLib. There is no NTP on the host, set
+  the time with setTime().
+*/
+
+#pragma once
+#include "WString.h"
+#include "TimeLib.h"
+
+class NTPClient
+{
+public:
+  String getTimeStr(time_t moment);
+  String getDateStr(time_t moment);
+  // "hh:mm:ss dd/mm/yyyy", or "Time not set"
+  String getTimeDateString(time_t moment = now());
+};
+
+extern NTPClient NTP;
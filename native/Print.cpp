@@ -0,0 +1,67 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "Print.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (size--)
+    n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  va_list arg;
+  va_start(arg, format);
+  const size_t len = vprintf(format, arg);
+  va_end(arg);
+  return len;
+}
+
+size_t Print::printf_P(PGM_P format, ...)
+{
+  va_list arg;
+  va_start(arg, format);
+  const size_t len = vprintf(format, arg);
+  va_end(arg);
+  return len;
+}
+
+// formats into a stack buffer, or a heap one for long lines (as the core does)
+size_t Print::vprintf(const char *format, va_list arg)
+{
+  va_list copy;
+  va_copy(copy, arg);
+  char temp[64];
+  char *buffer = temp;
+  size_t len = vsnprintf(temp, sizeof(temp), format, arg);
+  if (len > sizeof(temp) - 1) {
+    buffer = new char[len + 1];
+    vsnprintf(buffer, len + 1, format, copy);
+  }
+  va_end(copy);
+  len = write((const uint8_t*) buffer, len);
+  if (buffer != temp)
+    delete[] buffer;
+  return len;
+}
@@ -0,0 +1,65 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Arduino Print, the subset used by the firmware and the U8g2 library.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print
+{
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) { return str ? write((const uint8_t *) str, strlen(str)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *) buffer, size); }
+  virtual void flush() {}
+
+  size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+  size_t printf_P(PGM_P format, ...) __attribute__ ((format (printf, 2, 3)));
+
+  size_t print(const __FlashStringHelper *str) { return write(reinterpret_cast<const char*>(str)); }
+  size_t print(const String& str) { return write((const uint8_t *) str.c_str(), str.length()); }
+  size_t print(const char str[]) { return write(str); }
+  size_t print(char c) { return write((uint8_t) c); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long) value, base); }
+  size_t print(int value, int base = DEC) { return print((long) value, base); }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long) value, base); }
+  size_t print(long value, int base = DEC) { return print(String(value, (unsigned char) base)); }
+  size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char) base)); }
+  size_t print(double value, int digits = 2) { return print(String(value, (unsigned char) digits)); }
+
+  template <typename T> size_t println(const T& value) { return print(value) + println(); }
+  template <typename T> size_t println(const T& value, int format) { return print(value, format) + println(); }
+  size_t println() { return write("\r\n"); }
+private:
+  size_t vprintf(const char *format, va_list arg);
+};
@@ -0,0 +1,53 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "SPI.h"
+#include <clib/u8x8.h>
+
+SPIClass SPI;
+
+namespace {
+u8x8_msg_cb g_byte_cb = nullptr;
+Native::BusCounters g_bus_counters = {};
+
+uint8_t countingByteCallback(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  if (msg == U8X8_MSG_BYTE_START_TRANSFER)
+    ++g_bus_counters.transfers;
+  else if (msg == U8X8_MSG_BYTE_SEND)
+    g_bus_counters.bytes += arg_int;
+  return g_byte_cb(u8x8, msg, arg_int, arg_ptr);
+}
+}
+
+namespace Native {
+void countBus(u8x8_struct *u8x8)
+{
+  if (u8x8->byte_cb != countingByteCallback) {
+    g_byte_cb = u8x8->byte_cb;
+    u8x8->byte_cb = countingByteCallback;
+  }
+  g_bus_counters = BusCounters{};
+}
+
+BusCounters& getBusCounters()
+{
+  return g_bus_counters;
+}
+}
@@ -0,0 +1,70 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  SPI bus stub, for the hardware SPI drivers of U8g2. Nothing is transferred, but what a U8g2
+  display sends over its bus (hardware or software SPI, I2C) can be counted.
+*/
+
+#pragma once
+#include <stdint.h>
+
+struct u8x8_struct;
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x01
+#define SPI_MODE2 0x10
+#define SPI_MODE3 0x11
+
+#define SPI_CLOCK_DIV2 0
+#define SPI_CLOCK_DIV4 1
+#define SPI_CLOCK_DIV8 2
+
+class SPISettings
+{
+public:
+  SPISettings(uint32_t clock, uint8_t bit_order, uint8_t data_mode)
+  { (void) clock; (void) bit_order; (void) data_mode; }
+};
+
+class SPIClass
+{
+public:
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings settings) { (void) settings; }
+  void endTransaction() {}
+  void setBitOrder(uint8_t bit_order) { (void) bit_order; }
+  void setDataMode(uint8_t data_mode) { (void) data_mode; }
+  void setClockDivider(uint32_t divider) { (void) divider; }
+  uint8_t transfer(uint8_t data) { (void) data; return 0; }
+};
+
+extern SPIClass SPI;
+
+namespace Native {
+struct BusCounters {
+  uint32_t transfers; // START_TRANSFER .. END_TRANSFER of the byte callback
+  uint32_t bytes;
+};
+
+// wraps the byte callback of the display, one display at a time
+void countBus(u8x8_struct *u8x8);
+BusCounters& getBusCounters();
+}
@@ -0,0 +1,64 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "Ticker.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+std::vector<Ticker*> g_tickers;
+bool g_running = false; // callbacks may delay() or yield() themselves
+}
+
+Ticker::Ticker() : m_period_us(0), m_next_at(0), m_repeat(false), m_active(false)
+{
+  g_tickers.push_back(this);
+}
+
+Ticker::~Ticker()
+{
+  g_tickers.erase(std::remove(g_tickers.begin(), g_tickers.end(), this), g_tickers.end());
+}
+
+void Ticker::start(const uint32_t period_us, callback_function_t callback, const bool repeat)
+{
+  m_callback = callback;
+  m_period_us = period_us;
+  m_next_at = micros() + period_us;
+  m_repeat = repeat;
+  m_active = true;
+}
+
+void Ticker::runDue()
+{
+  if (g_running)
+    return;
+  g_running = true;
+  for (size_t i=0;i<g_tickers.size();++i) {
+    Ticker *ticker = g_tickers[i];
+    const uint32_t now = micros();
+    if (!ticker->m_active || (int32_t)(now - ticker->m_next_at) < 0)
+      continue;
+    ticker->m_next_at = now + ticker->m_period_us;
+    ticker->m_active = ticker->m_repeat;
+    ticker->m_callback();
+  }
+  g_running = false;
+}
@@ -0,0 +1,54 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Ticker of the core. There are no timer interrupts on the host, due tickers are run from
+  delay() and yield() instead, which is where the main context gives up the CPU.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <functional>
+
+class Ticker
+{
+public:
+  typedef std::function<void(void)> callback_function_t;
+
+  Ticker();
+  ~Ticker();
+
+  void attach(float seconds, callback_function_t callback) { start(seconds * 1000000, callback, true); }
+  void attach_ms(uint32_t milliseconds, callback_function_t callback) { start(milliseconds * 1000, callback, true); }
+  void once(float seconds, callback_function_t callback) { start(seconds * 1000000, callback, false); }
+  void once_ms(uint32_t milliseconds, callback_function_t callback) { start(milliseconds * 1000, callback, false); }
+  void detach() { m_active = false; }
+  bool active() const { return m_active; }
+
+  // runs the callbacks of all due tickers
+  static void runDue();
+private:
+  void start(const uint32_t period_us, callback_function_t callback, const bool repeat);
+
+  callback_function_t m_callback;
+  uint32_t m_period_us;
+  uint32_t m_next_at;
+  bool m_repeat;
+  bool m_active;
+};
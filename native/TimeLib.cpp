@@ -0,0 +1,84 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "TimeLib.h"
+#include "NtpClientLib.h"
+#include <Arduino.h>
+
+NTPClient NTP;
+
+namespace {
+bool g_time_set = false;
+time_t g_time_at_sync = 0;
+unsigned long g_millis_at_sync = 0;
+
+struct tm breakTime(const time_t t)
+{
+  struct tm parts;
+  gmtime_r(&t, &parts);
+  return parts;
+}
+}
+
+time_t now()
+{
+  return g_time_at_sync + (millis() - g_millis_at_sync) / 1000;
+}
+
+void setTime(time_t t)
+{
+  g_time_at_sync = t;
+  g_millis_at_sync = millis();
+  g_time_set = true;
+}
+
+timeStatus_t timeStatus()
+{
+  return g_time_set ? timeSet : timeNotSet;
+}
+
+int hour(time_t t) { return breakTime(t).tm_hour; }
+int minute(time_t t) { return breakTime(t).tm_min; }
+int second(time_t t) { return breakTime(t).tm_sec; }
+int day(time_t t) { return breakTime(t).tm_mday; }
+int month(time_t t) { return breakTime(t).tm_mon + 1; }
+int year(time_t t) { return breakTime(t).tm_year + 1900; }
+
+String NTPClient::getTimeStr(time_t moment)
+{
+  const struct tm parts = breakTime(moment);
+  char buffer[16];
+  strftime(buffer, sizeof(buffer), "%H:%M:%S", &parts);
+  return buffer;
+}
+
+String NTPClient::getDateStr(time_t moment)
+{
+  const struct tm parts = breakTime(moment);
+  char buffer[16];
+  strftime(buffer, sizeof(buffer), "%d/%m/%Y", &parts);
+  return buffer;
+}
+
+String NTPClient::getTimeDateString(time_t moment)
+{
+  if (timeStatus() == timeNotSet)
+    return "Time not set";
+  return getTimeStr(moment) + " " + getDateStr(moment);
+}
@@ -0,0 +1,104 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "Updater.h"
+#include "MD5Builder.h"
+#include <string.h>
+#include <algorithm>
+
+UpdaterClass Update;
+
+namespace {
+const size_t c_max_sketch_size = 1024 * 1024 - 4096; // update partition of the 4M layout
+}
+
+void UpdaterClass::reset()
+{
+  m_size = 0;
+  m_expected_md5 = "";
+  m_image.clear();
+}
+
+bool UpdaterClass::begin(size_t size, int command)
+{
+  if (m_size > 0 || command != U_FLASH)
+    return false;
+  m_error = UPDATE_ERROR_OK;
+  if (size == 0) {
+    m_error = UPDATE_ERROR_SIZE;
+    return false;
+  }
+  if (size > c_max_sketch_size) {
+    m_error = UPDATE_ERROR_SPACE;
+    return false;
+  }
+  m_size = size;
+  m_expected_md5 = "";
+  m_image.clear();
+  return true;
+}
+
+bool UpdaterClass::setMD5(const char *expected_md5)
+{
+  if (strlen(expected_md5) != 32)
+    return false;
+  m_expected_md5 = expected_md5;
+  return true;
+}
+
+size_t UpdaterClass::write(uint8_t *data, size_t length)
+{
+  if (hasError() || !isRunning())
+    return 0;
+  if (length > remaining()) {
+    m_error = UPDATE_ERROR_SPACE;
+    return 0;
+  }
+  m_image.insert(m_image.end(), data, data + length);
+  return length;
+}
+
+bool UpdaterClass::end(bool even_if_remaining)
+{
+  if (m_size == 0)
+    return false;
+  if (hasError() || (remaining() > 0 && !even_if_remaining)) {
+    if (!hasError())
+      m_error = UPDATE_ERROR_ABORT;
+    reset();
+    return false;
+  }
+
+  if (m_expected_md5.length() > 0) {
+    MD5Builder md5;
+    md5.begin();
+    for (size_t offset=0;offset<m_image.size();offset+=0x8000)
+      md5.add(m_image.data() + offset, std::min(m_image.size() - offset, (size_t) 0x8000));
+    md5.calculate();
+    if (!md5.toString().equalsIgnoreCase(m_expected_md5)) {
+      m_error = UPDATE_ERROR_MD5;
+      reset();
+      return false;
+    }
+  }
+
+  m_installed = m_image;
+  reset();
+  return true;
+}
@@ -0,0 +1,70 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Updater of the core. The image is written to RAM instead of the update partition, end()
+  verifies its size and MD5 like the device does, see getImage().
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "WString.h"
+
+#define UPDATE_ERROR_OK (0)
+#define UPDATE_ERROR_WRITE (1)
+#define UPDATE_ERROR_SIZE (4)
+#define UPDATE_ERROR_SPACE (5)
+#define UPDATE_ERROR_MD5 (8)
+#define UPDATE_ERROR_ABORT (12)
+
+#define U_FLASH 0
+#define U_SPIFFS 100
+
+class UpdaterClass
+{
+public:
+  UpdaterClass() : m_error(UPDATE_ERROR_OK), m_size(0) {}
+
+  bool begin(size_t size, int command = U_FLASH);
+  size_t write(uint8_t *data, size_t length);
+  bool end(bool even_if_remaining = false);
+  bool setMD5(const char *expected_md5);
+
+  uint8_t getError() { return m_error; }
+  bool hasError() { return m_error != UPDATE_ERROR_OK; }
+  bool isRunning() { return m_size > 0; }
+  size_t size() { return m_size; }
+  size_t progress() { return m_image.size(); }
+  size_t remaining() { return m_size - m_image.size(); }
+
+  // the last image that passed end()
+  const std::vector<uint8_t>& getImage() { return m_installed; }
+private:
+  void reset();
+
+  uint8_t m_error;
+  size_t m_size;
+  String m_expected_md5;
+  std::vector<uint8_t> m_image;
+  std::vector<uint8_t> m_installed;
+};
+
+extern UpdaterClass Update;
@@ -0,0 +1,468 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <Arduino.h>
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <algorithm>
+
+namespace {
+// like itoa/utoa of the core, with bases 2 to 36
+void formatUnsigned(char *buffer, unsigned long value, unsigned char base)
+{
+  if (base < 2 || base > 36)
+    base = 10;
+  char digits[8 * sizeof(value) + 1];
+  int i = 0;
+  do {
+    const unsigned long digit = value % base;
+    digits[i++] = (char) (digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value > 0);
+  while (i > 0)
+    *buffer++ = digits[--i];
+  *buffer = '\0';
+}
+
+void formatSigned(char *buffer, long value, unsigned char base)
+{
+  if (value < 0 && base == 10) {
+    *buffer++ = '-';
+    formatUnsigned(buffer, 0ul - (unsigned long) value, base);
+  } else {
+    formatUnsigned(buffer, (unsigned long) value, base);
+  }
+}
+}
+
+String::String(const char *cstr) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  if (cstr)
+    copy(cstr, strlen(cstr));
+}
+
+String::String(const String& str) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  *this = str;
+}
+
+String::String(String&& str) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  move(str);
+}
+
+String::String(const __FlashStringHelper *str) : String(reinterpret_cast<const char*>(str))
+{}
+
+String::String(char c) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  const char buffer[2] = { c, '\0' };
+  *this = buffer;
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long) value, base)
+{}
+
+String::String(int value, unsigned char base) : String((long) value, base)
+{}
+
+String::String(unsigned int value, unsigned char base) : String((unsigned long) value, base)
+{}
+
+String::String(long value, unsigned char base) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  char buffer[2 + 8 * sizeof(long)];
+  formatSigned(buffer, value, base);
+  *this = buffer;
+}
+
+String::String(unsigned long value, unsigned char base) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  char buffer[1 + 8 * sizeof(unsigned long)];
+  formatUnsigned(buffer, value, base);
+  *this = buffer;
+}
+
+String::String(float value, unsigned char decimals) : String((double) value, decimals)
+{}
+
+String::String(double value, unsigned char decimals) : m_buffer(nullptr), m_capacity(0), m_len(0)
+{
+  char buffer[33];
+  *this = dtostrf(value, decimals + 2, std::min<unsigned char>(decimals, 20), buffer);
+}
+
+String::~String()
+{
+  free(m_buffer);
+}
+
+void String::invalidate()
+{
+  free(m_buffer);
+  m_buffer = nullptr;
+  m_capacity = m_len = 0;
+}
+
+bool String::reserve(unsigned int size)
+{
+  if (m_buffer && m_capacity >= size)
+    return true;
+  if (changeBuffer(size)) {
+    if (m_len == 0)
+      m_buffer[0] = '\0';
+    return true;
+  }
+  return false;
+}
+
+bool String::changeBuffer(unsigned int max_length)
+{
+  char *buffer = (char*) realloc(m_buffer, max_length + 1);
+  if (!buffer)
+    return false;
+  m_buffer = buffer;
+  m_capacity = max_length;
+  return true;
+}
+
+String& String::copy(const char *cstr, unsigned int length)
+{
+  if (!reserve(length)) {
+    invalidate();
+    return *this;
+  }
+  m_len = length;
+  memmove(m_buffer, cstr, length);
+  m_buffer[length] = '\0';
+  return *this;
+}
+
+void String::move(String& rhs)
+{
+  if (this == &rhs)
+    return;
+  free(m_buffer);
+  m_buffer = rhs.m_buffer;
+  m_capacity = rhs.m_capacity;
+  m_len = rhs.m_len;
+  rhs.m_buffer = nullptr;
+  rhs.m_capacity = rhs.m_len = 0;
+}
+
+String& String::operator=(const String& rhs)
+{
+  if (this == &rhs)
+    return *this;
+  if (rhs.m_buffer)
+    copy(rhs.m_buffer, rhs.m_len);
+  else
+    invalidate();
+  return *this;
+}
+
+String& String::operator=(String&& rhs)
+{
+  move(rhs);
+  return *this;
+}
+
+String& String::operator=(const char *cstr)
+{
+  if (cstr)
+    copy(cstr, strlen(cstr));
+  else
+    invalidate();
+  return *this;
+}
+
+String& String::operator=(const __FlashStringHelper *str)
+{
+  return *this = reinterpret_cast<const char*>(str);
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+  const unsigned int new_length = m_len + length;
+  if (!cstr)
+    return false;
+  if (length == 0)
+    return true;
+  if (!reserve(new_length))
+    return false;
+  memmove(m_buffer + m_len, cstr, length);
+  m_len = new_length;
+  m_buffer[m_len] = '\0';
+  return true;
+}
+
+bool String::concat(const String& str)
+{
+  return concat(str.c_str(), str.length());
+}
+
+bool String::concat(const char *cstr)
+{
+  return cstr && concat(cstr, strlen(cstr));
+}
+
+bool String::concat(const __FlashStringHelper *str)
+{
+  return concat(reinterpret_cast<const char*>(str));
+}
+
+bool String::concat(char c)
+{
+  return concat(&c, 1);
+}
+
+bool String::concat(unsigned char value)
+{
+  return concat((unsigned long) value);
+}
+
+bool String::concat(int value)
+{
+  return concat((long) value);
+}
+
+bool String::concat(unsigned int value)
+{
+  return concat((unsigned long) value);
+}
+
+bool String::concat(long value)
+{
+  char buffer[2 + 8 * sizeof(long)];
+  formatSigned(buffer, value, 10);
+  return concat(buffer);
+}
+
+bool String::concat(unsigned long value)
+{
+  char buffer[1 + 8 * sizeof(unsigned long)];
+  formatUnsigned(buffer, value, 10);
+  return concat(buffer);
+}
+
+bool String::concat(float value)
+{
+  return concat((double) value);
+}
+
+bool String::concat(double value)
+{
+  char buffer[20];
+  return concat(dtostrf(value, 4, 2, buffer));
+}
+
+int String::compareTo(const String& s) const
+{
+  return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String& s) const
+{
+  return length() == s.length() && compareTo(s) == 0;
+}
+
+bool String::equals(const char *cstr) const
+{
+  return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const
+{
+  return length() == s.length() && strcasecmp(c_str(), s.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const
+{
+  return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const
+{
+  if (offset > length() || prefix.length() > length() - offset)
+    return false;
+  return strncmp(c_str() + offset, prefix.c_str(), prefix.length()) == 0;
+}
+
+bool String::endsWith(const String& suffix) const
+{
+  if (suffix.length() > length())
+    return false;
+  return strcmp(c_str() + length() - suffix.length(), suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const
+{
+  return (index < length()) ? m_buffer[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+  if (index < length())
+    m_buffer[index] = c;
+}
+
+char& String::operator[](unsigned int index)
+{
+  static char dummy_writable_char;
+  if (index >= length()) {
+    dummy_writable_char = '\0';
+    return dummy_writable_char;
+  }
+  return m_buffer[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+  if (!bufsize || !buf)
+    return;
+  if (index >= length()) {
+    buf[0] = 0;
+    return;
+  }
+  const unsigned int n = std::min(bufsize - 1, length() - index);
+  memcpy(buf, c_str() + index, n);
+  buf[n] = 0;
+}
+
+int String::indexOf(char ch, unsigned int from_index) const
+{
+  if (from_index >= length())
+    return -1;
+  const char *found = strchr(c_str() + from_index, ch);
+  return found ? (int) (found - c_str()) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int from_index) const
+{
+  if (from_index >= length())
+    return -1;
+  const char *found = strstr(c_str() + from_index, str.c_str());
+  return found ? (int) (found - c_str()) : -1;
+}
+
+int String::lastIndexOf(char ch, unsigned int from_index) const
+{
+  if (length() == 0)
+    return -1;
+  for (int i = (int) std::min(from_index, length() - 1); i >= 0; --i) {
+    if (m_buffer[i] == ch)
+      return i;
+  }
+  return -1;
+}
+
+int String::lastIndexOf(const String& str, unsigned int from_index) const
+{
+  if (str.length() == 0 || str.length() > length())
+    return -1;
+  for (int i = (int) std::min(from_index, length() - str.length()); i >= 0; --i) {
+    if (strncmp(m_buffer + i, str.c_str(), str.length()) == 0)
+      return i;
+  }
+  return -1;
+}
+
+String String::substring(unsigned int begin_index, unsigned int end_index) const
+{
+  if (begin_index > end_index)
+    std::swap(begin_index, end_index);
+  String out;
+  if (begin_index >= length())
+    return out;
+  end_index = std::min(end_index, length());
+  out.copy(m_buffer + begin_index, end_index - begin_index);
+  return out;
+}
+
+void String::replace(char find, char replace)
+{
+  for (unsigned int i=0;i<length();++i) {
+    if (m_buffer[i] == find)
+      m_buffer[i] = replace;
+  }
+}
+
+void String::replace(const String& find, const String& replace)
+{
+  if (length() == 0 || find.length() == 0)
+    return;
+  String out;
+  int from = 0, found;
+  while ((found = indexOf(find, from)) >= 0) {
+    out.concat(m_buffer + from, found - from);
+    out.concat(replace);
+    from = found + find.length();
+  }
+  if (from == 0)
+    return;
+  out.concat(m_buffer + from, length() - from);
+  move(out);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+  if (index >= length() || count == 0)
+    return;
+  count = std::min(count, length() - index);
+  memmove(m_buffer + index, m_buffer + index + count, length() - index - count + 1);
+  m_len -= count;
+}
+
+void String::toLowerCase()
+{
+  for (unsigned int i=0;i<length();++i)
+    m_buffer[i] = (char) tolower((unsigned char) m_buffer[i]);
+}
+
+void String::toUpperCase()
+{
+  for (unsigned int i=0;i<length();++i)
+    m_buffer[i] = (char) toupper((unsigned char) m_buffer[i]);
+}
+
+void String::trim()
+{
+  if (length() == 0)
+    return;
+  unsigned int begin = 0, end = length();
+  while (begin < end && isspace((unsigned char) m_buffer[begin]))
+    ++begin;
+  while (end > begin && isspace((unsigned char) m_buffer[end - 1]))
+    --end;
+  m_len = end - begin;
+  if (begin > 0)
+    memmove(m_buffer, m_buffer + begin, m_len);
+  m_buffer[m_len] = '\0';
+}
+
+long String::toInt() const
+{
+  return m_buffer ? atol(m_buffer) : 0;
+}
+
+float String::toFloat() const
+{
+  return m_buffer ? (float) atof(m_buffer) : 0;
+}
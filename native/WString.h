@@ -0,0 +1,141 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Arduino String, with the allocation behaviour of the ESP8266 core 2.4 (no small string
+  optimization, the buffer is grown with realloc), so that allocation counts measured on
+  the host match the device.
+*/
+
+#pragma once
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
+#include "pgmspace.h"
+
+class __FlashStringHelper;
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper *>(pstr_pointer))
+#define F(string_literal) (FPSTR(PSTR(string_literal)))
+
+class String
+{
+public:
+  String(const char *cstr = "");
+  String(const String& str);
+  String(String&& str);
+  String(const __FlashStringHelper *str);
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned char decimals = 2);
+  explicit String(double value, unsigned char decimals = 2);
+  ~String();
+
+  // returns false if the memory couldn't be allocated, the string is unchanged then
+  bool reserve(unsigned int size);
+  unsigned int length() const { return m_buffer ? m_len : 0; }
+
+  String& operator=(const String& rhs);
+  String& operator=(String&& rhs);
+  String& operator=(const char *cstr);
+  String& operator=(const __FlashStringHelper *str);
+
+  bool concat(const String& str);
+  bool concat(const char *cstr);
+  bool concat(const char *cstr, unsigned int length);
+  bool concat(const __FlashStringHelper *str);
+  bool concat(char c);
+  bool concat(unsigned char value);
+  bool concat(int value);
+  bool concat(unsigned int value);
+  bool concat(long value);
+  bool concat(unsigned long value);
+  bool concat(float value);
+  bool concat(double value);
+
+  template <typename T> String& operator+=(const T& rhs) { concat(rhs); return *this; }
+
+  int compareTo(const String& s) const;
+  bool equals(const String& s) const;
+  bool equals(const char *cstr) const;
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char *cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char *cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+  bool operator>(const String& rhs) const { return compareTo(rhs) > 0; }
+  bool operator<=(const String& rhs) const { return compareTo(rhs) <= 0; }
+  bool operator>=(const String& rhs) const { return compareTo(rhs) >= 0; }
+  bool equalsIgnoreCase(const String& s) const;
+  bool startsWith(const String& prefix) const;
+  bool startsWith(const String& prefix, unsigned int offset) const;
+  bool endsWith(const String& suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index);
+  void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const
+  { getBytes((unsigned char *) buf, bufsize, index); }
+  const char* c_str() const { return m_buffer ? m_buffer : ""; }
+
+  int indexOf(char ch) const { return indexOf(ch, 0); }
+  int indexOf(char ch, unsigned int from_index) const;
+  int indexOf(const String& str) const { return indexOf(str, 0); }
+  int indexOf(const String& str, unsigned int from_index) const;
+  int lastIndexOf(char ch) const { return lastIndexOf(ch, length() - 1); }
+  int lastIndexOf(char ch, unsigned int from_index) const;
+  int lastIndexOf(const String& str) const { return lastIndexOf(str, length() - str.length()); }
+  int lastIndexOf(const String& str, unsigned int from_index) const;
+  String substring(unsigned int begin_index) const { return substring(begin_index, length()); }
+  String substring(unsigned int begin_index, unsigned int end_index) const;
+
+  void replace(char find, char replace);
+  void replace(const String& find, const String& replace);
+  void remove(unsigned int index) { remove(index, (unsigned int) -1); }
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+private:
+  bool changeBuffer(unsigned int max_length);
+  void invalidate();
+  String& copy(const char *cstr, unsigned int length);
+  void move(String& rhs);
+
+  char *m_buffer;
+  unsigned int m_capacity;
+  unsigned int m_len;
+};
+
+// the left operand is taken by value, so chained temporaries are appended to in place
+// (as with StringSumHelper on the device)
+template <typename T> String operator+(String lhs, const T& rhs) { lhs.concat(rhs); return lhs; }
+inline String operator+(String lhs, const char *rhs) { lhs.concat(rhs); return lhs; }
+inline String operator+(const char *lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+inline String operator+(const __FlashStringHelper *lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+inline bool operator==(const char *lhs, const String& rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char *lhs, const String& rhs) { return !rhs.equals(lhs); }
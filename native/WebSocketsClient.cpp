@@ -0,0 +1,118 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "WebSocketsClient.h"
+
+namespace {
+WebSocketsClient *g_last_client = nullptr;
+}
+
+WebSocketsClient::WebSocketsClient()
+  : m_callback(nullptr), m_connect_pending(false), m_connected(false)
+{
+  g_last_client = this;
+}
+
+WebSocketsClient::~WebSocketsClient()
+{
+  if (g_last_client == this)
+    g_last_client = nullptr;
+}
+
+WebSocketsClient* WebSocketsClient::getLast()
+{
+  return g_last_client;
+}
+
+void WebSocketsClient::begin(const String& host, uint16_t port, const String& url, const String& protocol)
+{
+  (void) protocol;
+  m_url = "ws://" + host + ":" + String(port) + url;
+  m_connect_pending = true;
+}
+
+void WebSocketsClient::beginSSL(const String& host, uint16_t port, const String& url, const String& fingerprint,
+  const String& protocol)
+{
+  (void) fingerprint;
+  (void) protocol;
+  m_url = "wss://" + host + ":" + String(port) + url;
+  m_connect_pending = true;
+}
+
+void WebSocketsClient::event(const WStype_t type, uint8_t *payload, const size_t length)
+{
+  if (m_callback)
+    m_callback(type, payload, length);
+}
+
+void WebSocketsClient::loop()
+{
+  if (m_connect_pending) {
+    m_connect_pending = false;
+    m_connected = true;
+    String url = m_url;
+    event(WStype_CONNECTED, (uint8_t*) url.c_str(), url.length());
+  }
+
+  while (!m_received.empty()) {
+    Frame frame = std::move(m_received.front());
+    m_received.pop();
+    if (frame.type == WStype_DISCONNECTED) {
+      m_connected = false;
+      event(WStype_DISCONNECTED, nullptr, 0);
+      continue;
+    }
+    if (!m_connected)
+      continue;
+    frame.payload.push_back(0); // the library NUL terminates text payloads
+    event(frame.type, frame.payload.data(), frame.payload.size() - 1);
+  }
+}
+
+void WebSocketsClient::disconnect()
+{
+  m_connect_pending = false;
+  if (!m_connected)
+    return;
+  m_connected = false;
+  event(WStype_DISCONNECTED, nullptr, 0);
+}
+
+bool WebSocketsClient::sendTXT(const char *payload, size_t length)
+{
+  if (!m_connected)
+    return false;
+  if (length == 0)
+    length = strlen(payload);
+  String text;
+  text.concat(payload, length);
+  m_sent.push_back(text);
+  return true;
+}
+
+void WebSocketsClient::receive(const WStype_t type, const uint8_t *payload, const size_t length)
+{
+  m_received.push(Frame{type, std::vector<uint8_t>(payload, payload + length)});
+}
+
+void WebSocketsClient::dropConnection()
+{
+  m_received.push(Frame{WStype_DISCONNECTED, {}});
+}
@@ -0,0 +1,85 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Fake of WebSocketsClient (links2004/WebSockets 2.0.x). Nothing goes to the network: begin()
+  "connects" on the next loop(), frames queued with receive() are delivered from loop() like
+  the real client does, and sent texts are kept for inspection.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "WString.h"
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+} WStype_t;
+
+class WebSocketsClient
+{
+public:
+  typedef std::function<void (WStype_t type, uint8_t *payload, size_t length)> WebSocketClientEvent;
+
+  WebSocketsClient();
+  ~WebSocketsClient();
+
+  void begin(const String& host, uint16_t port, const String& url = "/", const String& protocol = "arduino");
+  void beginSSL(const String& host, uint16_t port, const String& url = "/", const String& fingerprint = "",
+    const String& protocol = "arduino");
+  void loop();
+  void disconnect();
+  void onEvent(WebSocketClientEvent callback) { m_callback = callback; }
+
+  bool sendTXT(const char *payload, size_t length = 0);
+  bool sendTXT(const String& payload) { return sendTXT(payload.c_str(), payload.length()); }
+
+  // host only
+  static WebSocketsClient* getLast(); // the most recently created client
+  bool isConnected() { return m_connected; }
+  const String& getURL() { return m_url; }
+  void receive(const WStype_t type, const uint8_t *payload, const size_t length);
+  void receiveText(const String& text) { receive(WStype_TEXT, (const uint8_t*) text.c_str(), text.length()); }
+  void dropConnection(); // as if the server went away, reported from the next loop()
+  std::vector<String>& getSent() { return m_sent; }
+private:
+  struct Frame {
+    WStype_t type;
+    std::vector<uint8_t> payload;
+  };
+  void event(const WStype_t type, uint8_t *payload, const size_t length);
+
+  WebSocketClientEvent m_callback;
+  bool m_connect_pending;
+  bool m_connected;
+  String m_url;
+  std::queue<Frame> m_received;
+  std::vector<String> m_sent;
+};
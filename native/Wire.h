@@ -0,0 +1,40 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  I2C bus stub, for the hardware I2C drivers of U8g2. Nothing is transferred.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+class TwoWire
+{
+public:
+  void begin() {}
+  void begin(int sda, int scl) { (void) sda; (void) scl; }
+  void setClock(uint32_t frequency) { (void) frequency; }
+  void beginTransmission(uint8_t address) { (void) address; }
+  uint8_t endTransmission() { return 0; }
+  size_t write(uint8_t data) { (void) data; return 1; }
+  size_t write(const uint8_t *data, size_t length) { (void) data; return length; }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,261 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Core functions: clock, pins, serial, random and the heap operators.
+*/
+
+#include <Arduino.h>
+#include <Ticker.h>
+#include "native.hpp"
+#include <chrono>
+#include <thread>
+#include <new>
+
+HardwareSerial Serial;
+
+namespace {
+const uint8_t c_pins = 17;
+
+bool g_manual_clock = false;
+uint32_t g_manual_micros = 0;
+uint8_t g_pins[c_pins] = {};
+uint32_t g_random = 2463534242u;
+
+uint64_t hostMicros()
+{
+  static const auto s_started_at = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_started_at).count();
+}
+}
+
+namespace Native {
+void setMicros(const uint32_t now)
+{
+  g_manual_clock = true;
+  g_manual_micros = now;
+}
+
+void advanceMicros(const uint32_t us)
+{
+  g_manual_micros += us;
+}
+
+void useHostClock()
+{
+  g_manual_clock = false;
+}
+
+uint8_t getPin(const uint8_t pin)
+{
+  return (pin < c_pins) ? g_pins[pin] : LOW;
+}
+}
+
+unsigned long micros(void)
+{
+  return g_manual_clock ? g_manual_micros : (uint32_t) hostMicros();
+}
+
+unsigned long millis(void)
+{
+  return g_manual_clock ? g_manual_micros / 1000 : (uint32_t) (hostMicros() / 1000);
+}
+
+// the manual clock is stepped by a millisecond, so that tickers run on time
+void delay(unsigned long ms)
+{
+  if (g_manual_clock) {
+    for (unsigned long i=0;i<ms;++i) {
+      g_manual_micros += 1000;
+      Ticker::runDue();
+    }
+  } else {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    Ticker::runDue();
+  }
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  if (g_manual_clock)
+    g_manual_micros += us;
+}
+
+void yield(void)
+{
+  Ticker::runDue();
+}
+
+void interrupts(void) {}
+void noInterrupts(void) {}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  (void) pin;
+  (void) mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if (pin < c_pins)
+    g_pins[pin] = val;
+}
+
+int digitalRead(uint8_t pin)
+{
+  return (pin < c_pins) ? g_pins[pin] : LOW;
+}
+
+// xorshift, seeded the same on every run
+long random(long howbig)
+{
+  if (howbig <= 0)
+    return 0;
+  g_random ^= g_random << 13;
+  g_random ^= g_random >> 17;
+  g_random ^= g_random << 5;
+  return g_random % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+  if (howsmall >= howbig)
+    return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0)
+    g_random = seed;
+}
+
+// as in the core (core_esp8266_noniso.c), which rounds and prints digits by itself, unlike printf
+char* dtostrf(double number, signed char width, unsigned char prec, char *s)
+{
+  if (isnan(number)) {
+    strcpy(s, "nan");
+    return s;
+  }
+  if (isinf(number)) {
+    strcpy(s, "inf");
+    return s;
+  }
+
+  char *out = s;
+  int fillme = width;
+  if (prec > 0)
+    fillme -= (prec+1);
+
+  bool negative = false;
+  if (number < 0.0) {
+    negative = true;
+    fillme--;
+    number = -number;
+  }
+
+  double rounding = 0.5;
+  for (uint8_t i=0;i<prec;++i)
+    rounding /= 10.0;
+  number += rounding;
+
+  double tenpow = 1.0;
+  int digitcount = 1;
+  while (number >= 10.0 * tenpow) {
+    tenpow *= 10.0;
+    digitcount++;
+  }
+  number /= tenpow;
+  fillme -= digitcount;
+
+  while (fillme-- > 0)
+    *out++ = ' ';
+  if (negative)
+    *out++ = '-';
+
+  digitcount += prec;
+  while (digitcount-- > 0) {
+    int8_t digit = (int8_t) number;
+    if (digit > 9)
+      digit = 9;
+    *out++ = (char) ('0' | digit);
+    if ((digitcount == prec) && (prec > 0))
+      *out++ = '.';
+    number -= digit;
+    number *= 10.0;
+  }
+  *out = 0;
+  return s;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (m_output)
+    fputc(c, stdout);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  if (m_output)
+    fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+void HardwareSerial::flush()
+{
+  fflush(stdout);
+}
+
+void hexdump(const void *mem, uint32_t len, uint8_t cols)
+{
+  const uint8_t *src = (const uint8_t*) mem;
+  Serial.printf("\n[HEXDUMP] Address: %p len: 0x%X (%u)", src, len, len);
+  for (uint32_t i=0;i<len;++i) {
+    if (i % cols == 0)
+      Serial.printf("\n[%p] 0x%08X: ", src, i);
+    Serial.printf("%02X ", *src++);
+  }
+  Serial.printf("\n");
+}
+
+// through malloc(), as in the core, so that AllocCounter counts them
+void* operator new(size_t size)
+{
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  free(ptr);
+}
@@ -0,0 +1,155 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Benchmark runner of the native environment ("pio run -e native", then run the program):
+  times the firmware's subsystems on the host, per operation and with heap allocations, and
+  runs the end-to-end price ingest scenarios of Benchmark. "-v" keeps the serial log.
+  "--simulate <WxH> <script> [out_dir]" runs the headless simulator instead, see simulator.hpp.
+  Unit tests bring their own main(), see test/.
+*/
+
+#ifndef UNIT_TEST
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include "setup.hpp"
+#include "simulator.hpp"
+#include "native_benchmark.hpp"
+#include "price.hpp"
+#include "data_source.hpp"
+#include "display_action_price.hpp"
+#include "benchmark.hpp"
+#include "utils.hpp"
+#include <memory>
+
+extern DataSource *g_data_source;
+extern DisplayT *g_display;
+extern ParameterStore g_parameters;
+
+namespace {
+volatile int64_t g_sink; // keeps results of pure operations alive
+
+const char c_price[] = "6543.21";
+
+TextView view(const char *text)
+{
+  return TextView{text, strlen(text)};
+}
+
+void receive(const char *text)
+{
+  DataSource::s_callback(WStype_TEXT, (uint8_t*) text, strlen(text));
+}
+
+void benchmarkPrice()
+{
+  using NativeBenchmark::measure;
+  Price price(view(c_price));
+  char buffer[32];
+
+  measure("price parse", []() { g_sink = Price(view(c_price)).getRaw(); });
+  measure("price toChars", [&]() { g_sink = price.toChars(buffer, sizeof(buffer)); });
+  measure("price toString", [&]() { g_sink = price.toString().length(); });
+  measure("price nextPrice", [&]() { g_sink = price.nextPrice().getRaw(); });
+  measure("price delta", [&]() { g_sink = price.delta(price + 12345); });
+}
+
+void benchmarkDispatch()
+{
+  using NativeBenchmark::measure;
+  measure("dispatch price", []() { receive(c_price); });
+  measure("dispatch ;HB", []() { receive(";HB"); });
+  measure("dispatch unknown command", []() { receive(";NO_SUCH_COMMAND 1 2 3"); });
+}
+
+void benchmarkDisplay(const std::shared_ptr<Display::PriceAction>& price_action)
+{
+  using NativeBenchmark::measure;
+  const uint32_t frame_us = g_display->getMilisPerTick() * 1000;
+  price_action->updatePrice(view(c_price));
+  measure("display frame, static price", [&]() { g_display->step(frame_us); });
+
+  uint32_t frame = 0;
+  const char *prices[] = { "6543.21", "6549.87" };
+  measure("display frame, animating price", [&]() {
+    if (++frame % 8 == 0)
+      price_action->updatePrice(view(prices[(frame / 8) % 2]));
+    g_display->step(frame_us);
+  });
+}
+
+void benchmarkParameters()
+{
+  using NativeBenchmark::measure;
+  uint32_t change = 0;
+  measure("parameters store", [&]() {
+    g_parameters.setValue(ParameterId::BRIGHTNESS, String(1 + (++change % 5)));
+    g_parameters.store();
+  });
+  measure("parameters load", []() {
+    Utils::eeprom_BEGIN();
+    g_parameters.load();
+    Utils::eeprom_END();
+  });
+}
+
+void benchmarkScenarios(const std::shared_ptr<Display::PriceAction>& price_action)
+{
+  const char *scenarios[] = { "steady", "bursty", "crash", "decimals", "subcent" };
+  for (const char *name : scenarios) {
+    Benchmark::Scenario scenario;
+    Benchmark::parseScenario(view(name), scenario);
+    const Display::PriceAction saved_state = *price_action;
+    const auto result = Benchmark::run(scenario, 1000, g_display, price_action.get());
+    *price_action = saved_state;
+    printf("%s\n", Benchmark::format(view(name), result, g_display->getMilisPerTick() * 1000).c_str());
+  }
+}
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(argc > 1 && strcmp(argv[1], "-v") == 0);
+  if (argc > 1 && strcmp(argv[1], "--simulate") == 0) {
+    if (argc < 4 || argc > 5) {
+      fprintf(stderr, "usage: %s --simulate <WxH> <script> [out_dir]\n", argv[0]);
+      return 2;
+    }
+    return Native::simulate(argv[2], argv[3], argc == 5 ? argv[4] : nullptr);
+  }
+
+  Native::setupParameters();
+  g_display = Native::createDisplay();
+  auto price_action = std::make_shared<Display::PriceAction>(10); // as in main.cpp
+  g_display->queueAction(price_action);
+
+  g_data_source = new DataSource;
+  g_data_source->setOnPriceChange([&](const TextView& price) { price_action->updatePrice(price); });
+  g_data_source->setBenchmarkRunning(true); // no logging of received texts
+
+  benchmarkPrice();
+  benchmarkDispatch();
+  benchmarkDisplay(price_action);
+  benchmarkParameters();
+  benchmarkScenarios(price_action);
+  return 0;
+}
+
+#endif
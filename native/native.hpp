@@ -0,0 +1,47 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Host side controls of the shims, for the tests and the benchmark runner.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Native {
+// micros()/millis() follow the host's monotonic clock, until a manual time is set; the manual
+// clock only moves with advanceMicros() and delay(), so that runs are deterministic
+void setMicros(const uint32_t now);
+void advanceMicros(const uint32_t us);
+void useHostClock();
+
+// last value written to a pin by digitalWrite()
+uint8_t getPin(const uint8_t pin);
+
+// writes the running sketch to flash offset 0
+void setSketch(const uint8_t *data, const uint32_t size);
+void eraseFlash();
+// power loss: only the next bytes of flash writes reach the flash, from the first byte past
+// them on writes and erases fail, until powerOn() (or eraseFlash())
+void cutPowerAfterFlashBytes(const uint32_t bytes);
+void powerOn();
+// number of ESP.restart() calls, the firmware keeps running on the host
+uint32_t getRestarts();
+}
@@ -0,0 +1,54 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "native_benchmark.hpp"
+#include "alloc_counter.hpp"
+#include <chrono>
+#include <stdio.h>
+
+namespace NativeBenchmark {
+Result measure(const char *name, const std::function<void(void)>& operation)
+{
+  typedef std::chrono::steady_clock clock;
+  const auto min_duration = std::chrono::milliseconds(c_min_duration_ms);
+
+  operation(); // warm up caches and lazily built state
+
+  Result result = {};
+  uint32_t batch = 1;
+  const uint32_t allocations = AllocCounter::count();
+  const uint32_t bytes = AllocCounter::bytes();
+  const auto started_at = clock::now();
+  clock::duration elapsed;
+  do { // batches keep the clock reads out of short operations
+    for (uint32_t i=0;i<batch;++i)
+      operation();
+    result.iterations += batch;
+    batch *= 2;
+    elapsed = clock::now() - started_at;
+  } while (elapsed < min_duration);
+
+  result.ns_per_op = std::chrono::duration<double, std::nano>(elapsed).count() / result.iterations;
+  result.allocations_per_op = (double) (AllocCounter::count() - allocations) / result.iterations;
+  result.bytes_per_op = (double) (AllocCounter::bytes() - bytes) / result.iterations;
+  printf("%-32s %10u ops %12.1f ns/op %8.2f allocs/op %8.1f B/op\n", name, result.iterations, result.ns_per_op,
+    result.allocations_per_op, result.bytes_per_op);
+  return result;
+}
+}
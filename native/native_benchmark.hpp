@@ -0,0 +1,42 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Micro benchmark helper of the native environment: runs an operation repeatedly, for at
+  least c_min_duration_ms of host time, and reports the time and the heap allocations
+  and allocated bytes (see AllocCounter) per call.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <functional>
+
+namespace NativeBenchmark {
+struct Result {
+  uint32_t iterations;
+  double ns_per_op;
+  double allocations_per_op;
+  double bytes_per_op;
+};
+
+const uint32_t c_min_duration_ms = 200;
+
+Result measure(const char *name, const std::function<void(void)>& operation);
+}
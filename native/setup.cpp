@@ -0,0 +1,109 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "setup.hpp"
+#include <SPI.h>
+#include "config.hpp"
+#include "parameter_schema.hpp"
+#include "data_source.hpp"
+#include "scheduler.hpp"
+#include "boot_profiler.hpp"
+#include "device_identity.hpp"
+
+ParameterStore g_parameters;
+Scheduler g_scheduler;
+BootProfiler g_boot_profiler;
+DeviceIdentity g_identity;
+DisplayT *g_display = nullptr;
+DataSource *g_data_source = nullptr;
+
+namespace {
+#if defined(X_DISPLAY_U8G2)
+class NativeDisplay : public Display::U8G2Matrix
+{
+public:
+  NativeDisplay(U8G2 *display, const int milis_per_tick, const int width, const int height, const bool max7219,
+                const std::vector<const uint8_t *>& fonts) :
+    U8G2Matrix(display, milis_per_tick, false, width, height, max7219)
+  {
+    if (!fonts.empty()) {
+      m_fonts = fonts;
+      setFont(0);
+    }
+  }
+};
+
+// the fonts U8G2Matrix picks for a display of this height (it only builds in the model's set)
+std::vector<const uint8_t *> fontsForHeight(const int height)
+{
+  if (height < 16)
+    return { u8g2_font_profont10_tr, u8g2_font_micro_tr, u8g2_font_u8glib_4_tr };
+  if (height < 32)
+    return { u8g2_font_profont15_mr, u8g2_font_profont12_mr, u8g2_font_profont10_mr };
+  return { u8g2_font_profont29_mr, u8g2_font_profont22_mr, u8g2_font_10x20_tr };
+}
+#else
+  #error only U8g2 displays are supported in the native environment
+#endif
+}
+
+namespace Native {
+DisplayT* createDisplay(const uint8_t *font)
+{
+#if defined(X_DISPLAY_MAX7219)
+  const bool max7219 = true;
+#else
+  const bool max7219 = false;
+#endif
+  std::vector<const uint8_t *> fonts;
+  if (font)
+    fonts.push_back(font);
+  return new NativeDisplay(&g_display_hw, X_DISPLAY_MILIS_PER_TICK, X_DISPLAY_WIDTH, X_DISPLAY_HEIGHT, max7219, fonts);
+}
+
+Display::U8G2Matrix* createDisplay(const int width, const int height)
+{
+  // the drivers of config_model.hpp; the vendored U8g2 has no 48x8 MAX7219, the 64x8 one stands
+  // in for it and U8G2Matrix only draws (and dumps) its first 48 columns
+  static U8G2_MAX7219_32X8_F_4W_SW_SPI max7219_32x8(U8G2_R0, D7, D5, D6, U8X8_PIN_NONE, U8X8_PIN_NONE);
+  static U8G2_MAX7219_64X8_F_4W_SW_SPI max7219_64x8(U8G2_R0, D7, D5, D6, U8X8_PIN_NONE, U8X8_PIN_NONE);
+  static U8G2_SSD1306_128X64_NONAME_F_HW_I2C ssd1306_128x64(U8G2_R0);
+
+  U8G2 *display = nullptr;
+  if (height == 8 && width == 32)
+    display = &max7219_32x8;
+  else if (height == 8 && (width == 48 || width == 64))
+    display = &max7219_64x8;
+  else if (height == 64 && width == 128)
+    return new NativeDisplay(&ssd1306_128x64, 50, width, height, false, fontsForHeight(height));
+  else
+    return nullptr;
+  return new NativeDisplay(display, 33, width, height, true, fontsForHeight(height));
+}
+
+void countDisplayBus()
+{
+  countBus(g_display_hw.getU8x8());
+}
+
+void setupParameters()
+{
+  g_parameters.begin(c_parameter_schema);
+}
+}
@@ -0,0 +1,42 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Globals that main.cpp defines on the device, and the parts of its setup that make sense on
+  the host, for the benchmark runner and the unit tests of the native environment.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include "display.hpp"
+#include "display_u8g2.hpp"
+
+namespace Native {
+// the display of the model (see config_model.hpp), drawing into the U8g2 frame buffer; a given
+// font replaces all of the model's fonts
+DisplayT* createDisplay(const uint8_t *font = nullptr);
+// a display of another geometry: the 32x8, 48x8 or 64x8 MAX7219 matrix or the 128x64 SSD1306,
+// with the fonts and frame rate the firmware uses for it; nullptr for any other size
+Display::U8G2Matrix* createDisplay(const int width, const int height);
+// starts counting what the model's display sends, see Native::getBusCounters()
+void countDisplayBus();
+// g_parameters with the firmware's schema and default values, nothing is loaded from flash
+void setupParameters();
+}
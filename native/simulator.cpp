@@ -0,0 +1,191 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include "simulator.hpp"
+#include "native.hpp"
+#include "setup.hpp"
+#include "data_source.hpp"
+#include "display_action_price.hpp"
+#include "display_action_text.hpp"
+#include "display_action_multi.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <vector>
+
+extern DataSource *g_data_source;
+extern DisplayT *g_display;
+
+namespace {
+const uint32_t c_run_after_last_message_ms = 5000;
+
+struct ScriptedMessage
+{
+  uint32_t at_ms;
+  String text;
+};
+
+class FilePrint : public Print
+{
+public:
+  explicit FilePrint(FILE *file) : m_file(file) {}
+  size_t write(uint8_t c) override { return fputc(c, m_file) == EOF ? 0 : 1; }
+  size_t write(const uint8_t *buffer, size_t size) override { return fwrite(buffer, 1, size, m_file); }
+
+private:
+  FILE *m_file;
+};
+
+bool loadScript(const char *path, std::vector<ScriptedMessage>& messages, uint32_t& end_ms)
+{
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "cannot open script %s\n", path);
+    return false;
+  }
+
+  bool has_end = false;
+  end_ms = 0;
+  char line[512];
+  for (int line_number = 1; fgets(line, sizeof(line), file); ++line_number) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '#' || line[0] == '\0')
+      continue;
+
+    char *text = nullptr;
+    const unsigned long at_ms = strtoul(line, &text, 10);
+    if (text == line || (*text != ' ' && *text != '\0')) {
+      fprintf(stderr, "%s:%d: expected \"<ms> <message>\"\n", path, line_number);
+      fclose(file);
+      return false;
+    }
+    if (*text == '\0') {
+      end_ms = at_ms;
+      has_end = true;
+    } else {
+      messages.push_back(ScriptedMessage{(uint32_t) at_ms, String(text + 1)});
+      if (!has_end)
+        end_ms = std::max<uint32_t>(end_ms, at_ms + c_run_after_last_message_ms);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+// as setAnnouncement() in main.cpp, slides the message in over the current action and back out
+void showAnnouncement(const String& message, const bool static_msg, const int display_time)
+{
+  using namespace Display;
+  using namespace Display::Action;
+  std::queue<ActionPtr_t> q;
+  auto current_action = g_display->getTopAction();
+  q.push(std::make_shared<SlideTransition>(current_action, 1, nullptr, 1, 0.5, Coords{-1,0}));
+  if (static_msg)
+    q.push(std::make_shared<StaticText>(message, display_time, Coords{0,0}));
+  else
+    q.push(std::make_shared<RotatingTextOnce>(message, 20, Coords{0,0}));
+  q.push(std::make_shared<SlideTransition>(nullptr, 1, current_action, 1, 0.5, Coords{-1,0}));
+  g_display->prependAction(std::make_shared<MultiRepeat>(q, 0, false, nullptr));
+}
+
+bool writeFrame(Display::U8G2Matrix *display, const char *out_dir, const uint32_t frame)
+{
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%05u.pbm", out_dir, frame);
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return false;
+  }
+  FilePrint out(file);
+  display->dumpFrame(out);
+  fclose(file);
+  return true;
+}
+}
+
+namespace Native {
+int simulate(const char *geometry, const char *script, const char *out_dir)
+{
+  int width = 0, height = 0;
+  Display::U8G2Matrix *display = nullptr;
+  if (sscanf(geometry, "%dx%d", &width, &height) == 2)
+    display = createDisplay(width, height);
+  if (!display) {
+    fprintf(stderr, "unsupported geometry %s, use 32x8, 48x8, 64x8 or 128x64\n", geometry);
+    return 2;
+  }
+
+  std::vector<ScriptedMessage> messages;
+  uint32_t end_ms;
+  if (!loadScript(script, messages, end_ms))
+    return 2;
+  if (out_dir)
+    mkdir(out_dir, 0755);
+
+  setMicros(0);
+  setupParameters();
+  g_display = display;
+  auto price_action = std::make_shared<Display::PriceAction>(10); // as in main.cpp
+  g_display->queueAction(price_action);
+
+  g_data_source = new DataSource;
+  g_data_source->setOnPriceChange([&](const TextView& price) { price_action->updatePrice(price); });
+  g_data_source->setOnPriceATH([&](const TextView& price) { price_action->setATHPrice(price); });
+  g_data_source->setOnPriceTimeoutSet([&](const TextView& timeout) {
+    price_action->setPriceTimeout(timeout.toString().toFloat());
+  });
+  g_data_source->setOnAnnouncement([](const TextView& message, const bool static_msg, const int display_time) {
+    showAnnouncement(message.toString(), static_msg, display_time);
+  });
+
+  const uint32_t frame_ms = display->getMilisPerTick();
+  size_t next_message = 0;
+  uint32_t frames = 0;
+  std::chrono::steady_clock::duration render_time{0}, total_time{0};
+  for (uint32_t now_ms = 0; now_ms < end_ms; now_ms += frame_ms, ++frames) {
+    const auto started_at = std::chrono::steady_clock::now();
+    for (; next_message < messages.size() && messages[next_message].at_ms <= now_ms; ++next_message) {
+      const String& text = messages[next_message].text;
+      DataSource::s_callback(WStype_TEXT, (uint8_t*) text.c_str(), text.length());
+    }
+    display->step(frame_ms * 1000);
+    const auto rendered_at = std::chrono::steady_clock::now();
+    if (out_dir && !writeFrame(display, out_dir, frames))
+      return 1;
+    render_time += rendered_at - started_at;
+    total_time += std::chrono::steady_clock::now() - started_at;
+    advanceMicros(frame_ms * 1000);
+  }
+
+  const double render_s = std::chrono::duration<double>(render_time).count();
+  const double total_s = std::chrono::duration<double>(total_time).count();
+  printf("%dx%d: %u frames (%u ms of display time), %.0f frames/s rendered", width, height, frames,
+    frames * frame_ms, render_s > 0 ? frames / render_s : 0);
+  if (out_dir)
+    printf(", %.0f frames/s with the images written to %s", total_s > 0 ? frames / total_s : 0, out_dir);
+  printf("\n");
+  return 0;
+}
+}
@@ -0,0 +1,34 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Headless simulator of the native runner: replays a script of server messages into a display of
+  the chosen geometry, one frame per display tick, and writes every frame as a PBM image.
+*/
+
+#pragma once
+
+namespace Native {
+/* geometry is "<width>x<height>" (32x8, 48x8, 64x8 or 128x64). Each script line is
+   "<ms> <message>", a text the server sends <ms> after the start (a price, ";ATH 7000",
+   ";MSG Hello", ...); a line with only "<ms>" ends the run there, otherwise it ends 5 s after
+   the last message. Lines starting with '#' are comments. Without out_dir no images are written.
+   Returns the exit code of the runner. */
+int simulate(const char *geometry, const char *script, const char *out_dir);
+}
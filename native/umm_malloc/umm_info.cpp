@@ -0,0 +1,39 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <Esp.h>
+extern "C" {
+#include "umm_malloc.h"
+}
+
+UMM_HEAP_INFO ummHeapInfo;
+
+void *umm_info(void *ptr, int force)
+{
+  (void) ptr;
+  (void) force;
+  const unsigned short int blocks = ESP.getFreeHeap() / 8;
+  ummHeapInfo = UMM_HEAP_INFO();
+  ummHeapInfo.totalEntries = 1;
+  ummHeapInfo.freeEntries = 1;
+  ummHeapInfo.totalBlocks = blocks;
+  ummHeapInfo.freeBlocks = blocks;
+  ummHeapInfo.maxFreeContiguousBlocks = blocks;
+  return nullptr;
+}
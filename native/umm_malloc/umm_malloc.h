@@ -0,0 +1,43 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Heap statistics of the core's umm_malloc. The host heap isn't umm's, so umm_info() reports
+  the free heap of EspClass as a single free block of 8 byte umm blocks.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct UMM_HEAP_INFO_t {
+  unsigned short int totalEntries;
+  unsigned short int usedEntries;
+  unsigned short int freeEntries;
+
+  unsigned short int totalBlocks;
+  unsigned short int usedBlocks;
+  unsigned short int freeBlocks;
+
+  unsigned short int maxFreeContiguousBlocks;
+} UMM_HEAP_INFO;
+
+extern UMM_HEAP_INFO ummHeapInfo;
+
+void *umm_info(void *ptr, int force);
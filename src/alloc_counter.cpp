@@ -0,0 +1,66 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "alloc_counter.hpp"
+
+namespace {
+volatile uint32_t g_allocations = 0;
+volatile uint32_t g_allocated_bytes = 0;
+}
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void* ICACHE_RAM_ATTR __wrap_malloc(size_t size)
+{
+  ++g_allocations;
+  g_allocated_bytes += size;
+  return __real_malloc(size);
+}
+
+void* ICACHE_RAM_ATTR __wrap_calloc(size_t count, size_t size)
+{
+  ++g_allocations;
+  g_allocated_bytes += count * size;
+  return __real_calloc(count, size);
+}
+
+void* ICACHE_RAM_ATTR __wrap_realloc(void *ptr, size_t size)
+{
+  if (size > 0) {
+    ++g_allocations;
+    g_allocated_bytes += size;
+  }
+  return __real_realloc(ptr, size);
+}
+}
+
+namespace AllocCounter {
+uint32_t count()
+{
+  return g_allocations;
+}
+
+uint32_t bytes()
+{
+  return g_allocated_bytes;
+}
+}
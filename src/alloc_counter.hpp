@@ -0,0 +1,33 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Heap allocation counter. malloc/calloc/realloc are wrapped at link time
+  (-Wl,--wrap=... in platformio.ini), so that code paths which should not
+  allocate (e.g. display rendering) can be checked on the device.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+
+namespace AllocCounter {
+uint32_t count(); // number of allocations since boot
+uint32_t bytes(); // bytes requested by them (a realloc counts its full new size)
+}
@@ -0,0 +1,212 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "benchmark.hpp"
+#include "data_source.hpp"
+#include "alloc_counter.hpp"
+
+extern DataSource *g_data_source;
+
+namespace Benchmark {
+namespace {
+const uint32_t c_scale = 100000000; // generated prices are in units of 10^-8
+const uint16_t c_max_settle_frames = 3000;
+
+const char c_scenario_steady[] PROGMEM = "steady";
+const char c_scenario_bursty[] PROGMEM = "bursty";
+const char c_scenario_crash[] PROGMEM = "crash";
+const char c_scenario_decimals[] PROGMEM = "decimals";
+const char c_scenario_subcent[] PROGMEM = "subcent";
+
+// deterministic, so that runs are comparable
+uint32_t xorshift(uint32_t &state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+int32_t randomStep(uint32_t &state, const int32_t max_step)
+{
+  return (int32_t) (xorshift(state) % (2*max_step + 1)) - max_step;
+}
+}
+
+// price stream generator, returns next price and number of frames to render after it
+class Stream
+{
+public:
+  Stream(const Scenario scenario, const uint16_t messages)
+    : m_scenario(scenario), m_messages(messages), m_index(0), m_random(2463534242u)
+  {
+    switch (m_scenario) {
+    case Scenario::DECIMALS: m_value = 12345678; m_decimals = 8; break; // 0.12345678
+    case Scenario::SUBCENT: m_value = 4321; m_decimals = 8; break; // 0.00004321
+    default: m_value = 654321000000LL; m_decimals = 2; break; // 6543.21
+    }
+  }
+
+  uint8_t next()
+  {
+    const int64_t cent = c_scale / 100;
+    switch (m_scenario) {
+    case Scenario::STEADY:
+      m_value += randomStep(m_random, 50) * cent;
+      break;
+    case Scenario::BURSTY:
+      m_value += randomStep(m_random, 50) * cent;
+      ++m_index;
+      return (m_index % 10 == 0) ? 20 : 0; // bursts of 10 messages without frames in between
+    case Scenario::CRASH: // falls by ~35%, then recovers
+      if (m_index < m_messages * 2 / 5)
+        m_value -= m_value / 100 / cent * cent;
+      else
+        m_value += m_value / 150 / cent * cent;
+      break;
+    case Scenario::DECIMALS:
+      m_value += randomStep(m_random, 5000);
+      break;
+    case Scenario::SUBCENT:
+      m_value = std::max(m_value + randomStep(m_random, 20), (int64_t) 1);
+      break;
+    }
+    ++m_index;
+    return 4;
+  }
+
+  size_t format(char *buffer, const size_t size)
+  {
+    uint32_t divisor = 1;
+    for (uint8_t i=m_decimals;i<8;++i)
+      divisor *= 10;
+    return snprintf_P(buffer, size, PSTR("%u.%0*u"), (uint32_t) (m_value / c_scale), m_decimals,
+      (uint32_t) (m_value % c_scale) / divisor);
+  }
+private:
+  const Scenario m_scenario;
+  const uint16_t m_messages;
+  uint16_t m_index;
+  uint32_t m_random;
+  int64_t m_value;
+  uint8_t m_decimals;
+};
+
+namespace {
+void renderFrame(DisplayT *display, Result &result)
+{
+  const uint32_t allocations = AllocCounter::count();
+  const uint32_t started_at = micros();
+  display->step(display->getMilisPerTick() * 1000);
+  const uint32_t duration = micros() - started_at;
+
+  result.render_allocations += AllocCounter::count() - allocations;
+  result.render_us += duration;
+  result.max_render_us = std::max(result.max_render_us, duration);
+  ++result.frames;
+  ESP.wdtFeed();
+}
+}
+
+bool parseScenario(const TextView& name, Scenario& scenario)
+{
+  if (name.equals_P(c_scenario_steady)) scenario = Scenario::STEADY;
+  else if (name.equals_P(c_scenario_bursty)) scenario = Scenario::BURSTY;
+  else if (name.equals_P(c_scenario_crash)) scenario = Scenario::CRASH;
+  else if (name.equals_P(c_scenario_decimals)) scenario = Scenario::DECIMALS;
+  else if (name.equals_P(c_scenario_subcent)) scenario = Scenario::SUBCENT;
+  else return false;
+  return true;
+}
+
+Run::Run(const Scenario scenario, const uint16_t messages, DisplayT *display, Display::PriceAction *price_action)
+  : m_stream(new Stream(scenario, messages)), m_messages(messages), m_display(display), m_price_action(price_action),
+    m_result()
+{
+}
+
+Run::~Run()
+{
+}
+
+bool Run::isSettled()
+{
+  return !m_price_action->isAnimating() || m_result.settle_frames >= c_max_settle_frames;
+}
+
+bool Run::step(const uint16_t max_frames)
+{
+  uint32_t frames = 0;
+  char buffer[24];
+
+  while (m_result.messages < m_messages && frames < max_frames) {
+    const uint8_t message_frames = m_stream->next();
+    const size_t length = m_stream->format(buffer, sizeof(buffer));
+
+    const bool benchmark_running = g_data_source->isBenchmarkRunning();
+    g_data_source->setBenchmarkRunning(true);
+    const uint32_t allocations = AllocCounter::count();
+    const uint32_t started_at = micros();
+    DataSource::s_callback(WStype_TEXT, (uint8_t*) buffer, length);
+    const uint32_t duration = micros() - started_at;
+    g_data_source->setBenchmarkRunning(benchmark_running);
+
+    m_result.ingest_allocations += AllocCounter::count() - allocations;
+    m_result.ingest_us += duration;
+    m_result.max_ingest_us = std::max(m_result.max_ingest_us, duration);
+    ++m_result.messages;
+
+    for (uint8_t frame=0;frame<message_frames;++frame)
+      renderFrame(m_display, m_result);
+    frames += message_frames;
+  }
+  if (m_result.messages < m_messages)
+    return false;
+
+  while (!isSettled() && frames < max_frames) {
+    renderFrame(m_display, m_result);
+    ++m_result.settle_frames;
+    ++frames;
+  }
+  return isSettled();
+}
+
+Result run(const Scenario scenario, const uint16_t messages, DisplayT *display, Display::PriceAction *price_action)
+{
+  Run run(scenario, messages, display, price_action);
+  while (!run.step(UINT16_MAX)) {}
+  return run.getResult();
+}
+
+String format(const TextView& scenario_name, const Result& result, const uint32_t frame_period_us)
+{
+  const uint32_t messages = std::max(result.messages, (uint16_t) 1);
+  const uint32_t frames = std::max(result.frames, (uint32_t) 1);
+  const uint32_t messages_per_sec = (uint64_t) result.messages * 1000000 / std::max(result.ingest_us, (uint32_t) 1);
+
+  return "benchmark " + scenario_name.toString() + " msgs=" + String(result.messages) +
+    " msgs_per_s=" + String(messages_per_sec) +
+    " ingest_avg_us=" + String(result.ingest_us / messages) + " ingest_max_us=" + String(result.max_ingest_us) +
+    " ingest_allocs=" + String(result.ingest_allocations) +
+    " frames=" + String(result.frames) +
+    " render_avg_us=" + String(result.render_us / frames) + " render_max_us=" + String(result.max_render_us) +
+    " render_allocs=" + String(result.render_allocations) +
+    " lag_ms=" + String(result.settle_frames * frame_period_us / 1000);
+}
+}
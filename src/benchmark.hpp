@@ -0,0 +1,79 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  End-to-end benchmark of the price ingest path. Synthetic price streams are fed through
+  DataSource::s_callback(), as if received from the server, and the display is stepped
+  with a fixed frame period in between, measuring ingest and render times, heap allocations
+  and how long the price animation takes to catch up. The data source is marked as benchmarking
+  while a message is fed, so that the messages aren't logged to serial (which would dominate the
+  ingest time) and don't count as real prices. On the device a run is fed in slices (Run::step()),
+  so that loop() keeps serving the network and the watchdog in between.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include "text_view.hpp"
+#include "display.hpp"
+#include "display_action_price.hpp"
+#include <memory>
+
+namespace Benchmark {
+enum class Scenario : uint8_t { STEADY, BURSTY, CRASH, DECIMALS, SUBCENT };
+
+struct Result {
+  uint16_t messages;
+  uint32_t frames;
+  uint32_t ingest_us; // total
+  uint32_t max_ingest_us;
+  uint32_t ingest_allocations;
+  uint32_t render_us; // total
+  uint32_t max_render_us;
+  uint32_t render_allocations;
+  uint32_t settle_frames; // frames needed to finish the animation after the last message
+};
+
+class Stream;
+
+class Run
+{
+public:
+  Run(const Scenario scenario, const uint16_t messages, DisplayT *display, Display::PriceAction *price_action);
+  ~Run();
+
+  // feeds messages (then settling frames) until about max_frames frames are rendered, true once finished
+  bool step(const uint16_t max_frames);
+  const Result& getResult() const { return m_result; }
+private:
+  bool isSettled();
+
+  std::unique_ptr<Stream> m_stream;
+  const uint16_t m_messages;
+  DisplayT *m_display;
+  Display::PriceAction *m_price_action;
+  Result m_result;
+};
+
+bool parseScenario(const TextView& name, Scenario& scenario);
+// a whole run at once, for the host
+Result run(const Scenario scenario, const uint16_t messages, DisplayT *display, Display::PriceAction *price_action);
+// ";DIAG benchmark ..." line, without the ";DIAG " prefix
+String format(const TextView& scenario_name, const Result& result, const uint32_t frame_period_us);
+}
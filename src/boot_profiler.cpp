@@ -0,0 +1,56 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "boot_profiler.hpp"
+#include <algorithm>
+
+namespace {
+// in Stage order
+const char c_stage_names[(uint8_t) BootProfiler::Stage::COUNT][12] PROGMEM = {
+  "serial", "hw", "display", "params", "wifi", "dhcp", "websocket", "first_text", "first_price",
+  "ntp", "update"
+};
+}
+
+void BootProfiler::mark(const Stage stage)
+{
+  if (isReached(stage))
+    return;
+  if (m_heap_at_start == 0)
+    m_heap_at_start = ESP.getFreeHeap();
+  m_reached_at[(uint8_t) stage] = std::max(millis(), (unsigned long) 1);
+  DEBUG_SERIAL.printf_P(PSTR("[Boot] %s at %u ms\n"), String(FPSTR(c_stage_names[(uint8_t) stage])).c_str(),
+    m_reached_at[(uint8_t) stage]);
+  if (isComplete()) {
+    m_heap_booted = ESP.getFreeHeap();
+    DEBUG_SERIAL.printf_P(PSTR("[Boot] Free heap %u at start, %u after boot\n"), m_heap_at_start, m_heap_booted);
+  }
+}
+
+String BootProfiler::format()
+{
+  String line = "boot";
+  for (uint8_t stage=0;stage<(uint8_t) Stage::COUNT;++stage) {
+    line += " ";
+    line += FPSTR(c_stage_names[stage]);
+    line += "=";
+    line += (m_reached_at[stage] != 0 ? String(m_reached_at[stage]) : String("-"));
+  }
+  line += " heap_start=" + String(m_heap_at_start) + " heap_booted=" + String(m_heap_booted);
+  return line;
+}
@@ -0,0 +1,68 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*
+  Boot phase profiler. Records when each stage of the boot was first reached (ms since the
+  sketch started) and reports them once per boot, to see which stage dominates time-to-ticker.
+  Free heap is recorded at the first stage and once the boot is complete, to compare the
+  memory cost of the whole boot between firmware builds.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+
+class BootProfiler
+{
+public:
+  enum class Stage : uint8_t {
+    SERIAL_READY,
+    HARDWARE,
+    DISPLAY_READY,
+    PARAMETERS,
+    WIFI_ASSOCIATED,
+    WIFI_GOT_IP,
+    WEBSOCKET_CONNECTED,
+    FIRST_TEXT,
+    FIRST_PRICE,
+    NTP_SYNCED,
+    UPDATE_CHECKED,
+    COUNT
+  };
+
+  BootProfiler() : m_heap_at_start(0), m_heap_booted(0), m_reported(false) { memset(m_reached_at, 0, sizeof(m_reached_at)); }
+
+  // only the first time a stage is reached is kept, e.g. not WiFi reconnects
+  void mark(const Stage stage);
+  bool isReached(const Stage stage) { return m_reached_at[(uint8_t) stage] != 0; }
+  uint32_t getReachedAt(const Stage stage) { return m_reached_at[(uint8_t) stage]; }
+  // the ticker shows a price and the update check is done
+  bool isComplete() { return isReached(Stage::FIRST_PRICE) && isReached(Stage::UPDATE_CHECKED); }
+
+  // "boot ..." line, without the ";DIAG " prefix, stages not reached are reported as '-'
+  String format();
+  bool isReported() { return m_reported; }
+  void setReported() { m_reported = true; }
+private:
+  uint32_t m_reached_at[(uint8_t) Stage::COUNT]; // millis(), 0 if not reached
+  uint32_t m_heap_at_start; // free heap when the first stage was reached
+  uint32_t m_heap_booted; // free heap when the boot was complete
+  bool m_reported;
+};
+
+extern BootProfiler g_boot_profiler;
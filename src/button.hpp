@@ -24,7 +24,6 @@
 #pragma once
 #include "config_common.hpp"
 #include <Arduino.h>
-#include <Ticker.h>
 #include <functional>
 
 typedef std::function<void()> button_callback_t;
@@ -38,8 +37,6 @@ public:
     pinMode(m_pin, INPUT);
   }
 
-  void setupTickCallback(Ticker::callback_t callback);
-
   void onShortPress(button_callback_t func);
   void onLongPress(button_callback_t func);
   void onSuperLongPress(button_callback_t func);
@@ -54,7 +51,6 @@ private:
   unsigned long m_pressed_at;
   bool m_long_press_dispatched;
   bool m_super_long_press_dispatched;
-  Ticker m_ticker;
 
   static const unsigned int m_long_press_delay = 1000;
   static const unsigned int m_super_long_press_delay = 10000;
@@ -19,6 +19,7 @@
 
 #define PORTAL_TRIGGER_PIN 0 // Flash button
 #define DEBUG_SERIAL Serial
+#define X_DISPLAY_PROFILER // frame time statistics of the display pipeline, comment out to compile out
 
 #if !defined(FIRMWARE_VERSION)
 # define FIRMWARE_VERSION "1.0.0"
@@ -30,18 +30,21 @@
     #define HAS_GYROSCOPE
   #endif
   #define X_DISPLAY_U8G2
+  #define X_DISPLAY_MAX7219
   #define X_DISPLAY_WIDTH 32
   #define X_DISPLAY_HEIGHT 8
   #include "display_u8g2.hpp"
   U8G2_MAX7219_32X8_F_4W_SW_SPI g_display_hw(U8G2_R0, /* clock=*/ D7, /* data=*/ D5, /* cs=*/ D6, /* dc=*/ U8X8_PIN_NONE, /* reset=*/ U8X8_PIN_NONE);
 #elif defined(X_MODEL_3DX0100) // as above, 6 modules
   #define X_DISPLAY_U8G2
+  #define X_DISPLAY_MAX7219
   #define X_DISPLAY_WIDTH 48
   #define X_DISPLAY_HEIGHT 8
   #include "display_u8g2.hpp"
   U8G2_MAX7219_48X8_F_4W_SW_SPI g_display_hw(U8G2_R0, /* clock=*/ D7, /* data=*/ D5, /* cs=*/ D6, /* dc=*/ U8X8_PIN_NONE, /* reset=*/ U8X8_PIN_NONE);
 #elif defined(X_MODEL_3DB0100) // as above, 8 modules
   #define X_DISPLAY_U8G2
+  #define X_DISPLAY_MAX7219
   #define X_DISPLAY_WIDTH 64
   #define X_DISPLAY_HEIGHT 8
   #include "display_u8g2.hpp"
@@ -68,6 +71,7 @@
 #elif defined(X_MODEL_3DT0100) // model to be used as ntp clock only (no websocket/ticker information)
   #define X_CLOCK_ONLY_DISPLAY
   #define X_DISPLAY_U8G2
+  #define X_DISPLAY_MAX7219
   #define X_DISPLAY_WIDTH 32
   #define X_DISPLAY_HEIGHT 8
   #include "display_u8g2.hpp"
@@ -75,6 +79,7 @@
 #elif defined(X_MODEL_TESTER) // model for testing display LEDs
   #define X_TEST_DISPLAY
   #define X_DISPLAY_U8G2
+  #define X_DISPLAY_MAX7219
   #define X_DISPLAY_WIDTH 32
   #define X_DISPLAY_HEIGHT 8
   #include "display_u8g2.hpp"
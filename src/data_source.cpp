@@ -20,8 +20,13 @@
 #include "data_source.hpp"
 
 #include "utils.hpp"
+#include "display.hpp"
+#include "scheduler.hpp"
+#include "boot_profiler.hpp"
+#include "device_identity.hpp"
 
 extern DataSource *g_data_source;
+extern DisplayT *g_display;
 extern ParameterStore g_parameters;
 
 void DataSource::connect()
@@ -29,9 +34,9 @@ void DataSource::connect()
   String host, path, protocol;
   int port;
 
-  String ticker_url = g_parameters["ticker_url"];
+  String ticker_url = g_parameters.getString(ParameterId::TICKER_URL);
   Utils::parseURL(ticker_url, host, port, path, protocol);
-  path += "?uuid=" + g_parameters["__device_uuid"];
+  path += "?uuid=" + g_identity.getUUID();
 
   DEBUG_SERIAL.printf_P(PSTR("[Wsc] Connecting to protocol '%s' host '%s' port '%i' url '%s'\n"),protocol.c_str(),host.c_str(), port, path.c_str());
   if (protocol=="ws")
@@ -58,6 +63,7 @@ void DataSource::loop()
   // force reconnect
   if (!m_connected && (millis() - m_last_connected_at > c_force_reconnect_interval)) {
     DEBUG_SERIAL.printf_P(PSTR("[WSc] Couldn't autoconnect for %i secs, forcing restart\n"), c_force_reconnect_interval / 1000);
+    g_parameters.flush();
     ESP.restart();
   }
 
@@ -66,6 +72,13 @@ void DataSource::loop()
     reconnect();
   }
 
+  // transfer abandoned by the server
+  if (m_firmware.isActive() && millis() - m_firmware_data_at > c_firmware_stall_timeout) {
+    DEBUG_SERIAL.printf_P(PSTR("[WSc] No firmware data for %i secs, aborting transfer\n"), c_firmware_stall_timeout / 1000);
+    m_firmware.abort();
+    firmwareDone(false);
+  }
+
   // send heartbeat
   if (m_connected && millis() - m_last_heartbeat_sent_at > c_heartbeat_interval) {
     queueText(";HB");
@@ -98,20 +111,44 @@ void DataSource::queueText(const String& text)
 void DataSource::sendHello()
 {
   String text = ";HELLO " + String(X_MODEL_NUMBER) + " " +
-    g_parameters["__device_uuid"] + " " + FIRMWARE_VERSION + " " + ESP.getSketchMD5();
+    g_identity.getUUID() + " " + FIRMWARE_VERSION + " " + g_identity.getSketchMD5();
   queueText(text);
 }
 
+void DataSource::sendBootProfile()
+{
+  if (!m_connected || g_boot_profiler.isReported() || !g_boot_profiler.isComplete())
+    return;
+  queueText(";DIAG " + g_boot_profiler.format());
+  g_boot_profiler.setReported();
+}
+
 void DataSource::sendDiagnostics()
 {
   queueText(";DIAG last_reset_reason " + ESP.getResetReason());
   queueText(";DIAG last_reset_info " + ESP.getResetInfo());
+  if (g_display)
+    queueText(";DIAG display_frames rendered=" + String(g_display->getFramesRendered()) +
+      " sent=" + String(g_display->getFramesSent()));
+#if defined(X_DISPLAY_PROFILER)
+  if (g_display)
+    g_display->getProfiler().report([this](const char *line) { queueText(";DIAG display_profile " + String(line)); });
+#endif
+
+  for (Scheduler::task_id_t id=0;id<g_scheduler.getTaskCount();++id) {
+    const auto& task = g_scheduler.getTask(id);
+    queueText(";DIAG task " + String(task.name) + " runs=" + String(task.runs) + " overruns=" + String(task.overruns) +
+      " max_late_us=" + String(task.max_lateness_us) + " max_us=" + String(task.max_duration_us));
+  }
+  sendBootProfile();
+  queueText(";DIAG params commits=" + String(g_parameters.getCommits()) + " unchanged=" + String(g_parameters.getCommitsUnchanged()) +
+    " coalesced=" + String(g_parameters.getStoresCoalesced()) + " erases=" + String(g_parameters.getErases()));
 }
 
 void DataSource::sendParameter(const ParameterItem *item)
 {
-  if (item->name.startsWith("__")) return;
-  String text = ";PARAM " + item->name + " " + item->value;
+  if (item->isReserved()) return;
+  String text = ";PARAM " + item->getName() + " " + item->value;
   queueText(text);
 }
 
@@ -129,75 +166,272 @@ bool DataSource::sendOTPRequest()
   return false;
 }
 
-void DataSource::textCallback(const String& str)
+namespace {
+// FNV-1a, used to look up protocol commands; constexpr so that c_commands is built at compile time
+constexpr uint32_t commandHash(const char *name, const uint32_t hash = 2166136261u)
 {
-  if (str=="") return;
-  if (str==";UPDATE") {
-    if (m_on_update_request) {
-      disconnect();
-      m_on_update_request();
-    }
-  } else if (str.startsWith(";RESET")) {
-    ESP.restart();
-  } else if (str.startsWith(";ATH=")) { // All-Time-High
-    if (m_on_price_ath)
-      m_on_price_ath(str.substring(5));
-  } else if (str.startsWith(";MSG ") || str.startsWith(";MSG=")) { // Announcement
-    if (m_on_announcement)
-      m_on_announcement(str.substring(5), false, 0);
-  } else if (str.startsWith(";STATICMSG ") || str.startsWith(";MSGSTATIC ")) { // Announcement
-    if (m_on_announcement) {
-      int time_idx = str.indexOf(' ');
-      if (time_idx==-1)
-        return;
-      int msg_idx = str.indexOf(' ', time_idx+1);
-      if (msg_idx==-1)
-        return;
-
-      int display_time = str.substring(time_idx+1).toInt();
-      String msg = str.substring(msg_idx+1);
-      m_on_announcement(msg, true, display_time);
-    }
-  } else if (str.startsWith(";PARAM ")) { // parameter update
-    String pair = str.substring(7);
-    int index = pair.indexOf(" ");
-    String param_name = pair.substring(0,index);
-    String param_value = pair.substring(index+1);
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] Parameter '%s' updated to '%s'\n"),param_name.c_str(), param_value.c_str());
-    parameterCallback(param_name, param_value);
-  } else if (str.startsWith(";OTP ")||str.startsWith(";OTP=")) { // OTP
-    if (m_on_otp)
-      m_on_otp(str.substring(5));
-  } else if (str.startsWith(";OTP_ACK")) { // OTP acknowledge
-    if (m_on_otp_ack)
-      m_on_otp_ack();
-  } else if (str.startsWith(";DATA_TIMEOUT")) {
-    if (m_on_price_timeout_set)
-      m_on_price_timeout_set(str.substring(13));
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] Data timeout set to '%s' secs\n"),str.substring(13).c_str());
-  } else if (str.startsWith(";GET_PARAMS")) {
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] Parameters requested, sending\n"));
-    sendAllParameters();
-  } else if (str.startsWith(";NEW_SETTINGS_LOADED")) {
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] New settings loaded\n"));
-    if (m_on_new_settings)
-      m_on_new_settings();
-  } else if (str.startsWith(";HB")) {
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] Heartbeat received\n"));
-  } else if (str.startsWith("; Welcome")) {
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] Welcome message received\n"));
-  } else if (str.startsWith(";")){
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] Unknown message '%s'\n"),str.c_str());
-  } else {
+  return (*name == '\0') ? hash : commandHash(name + 1, (hash ^ (uint8_t) *name) * 16777619u);
+}
+
+uint32_t commandHash(const TextView& name)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i=0;i<name.length;++i)
+    hash = (hash ^ (uint8_t) name.data[i]) * 16777619u;
+  return hash;
+}
+
+const char c_cmd_update[] PROGMEM = "UPDATE";
+const char c_cmd_reset[] PROGMEM = "RESET";
+const char c_cmd_ath[] PROGMEM = "ATH";
+const char c_cmd_msg[] PROGMEM = "MSG";
+const char c_cmd_staticmsg[] PROGMEM = "STATICMSG";
+const char c_cmd_msgstatic[] PROGMEM = "MSGSTATIC";
+const char c_cmd_param[] PROGMEM = "PARAM";
+const char c_cmd_otp[] PROGMEM = "OTP";
+const char c_cmd_otp_ack[] PROGMEM = "OTP_ACK";
+const char c_cmd_data_timeout[] PROGMEM = "DATA_TIMEOUT";
+const char c_cmd_get_params[] PROGMEM = "GET_PARAMS";
+const char c_cmd_new_settings[] PROGMEM = "NEW_SETTINGS_LOADED";
+const char c_cmd_hb[] PROGMEM = "HB";
+const char c_cmd_frame_dump[] PROGMEM = "FRAME_DUMP";
+const char c_cmd_benchmark[] PROGMEM = "BENCHMARK";
+const char c_cmd_fw_begin[] PROGMEM = "FW_BEGIN";
+const char c_cmd_comment[] PROGMEM = ""; // "; Welcome ..."
+}
+
+const DataSource::Command DataSource::c_commands[] PROGMEM = {
+  { commandHash("UPDATE"), c_cmd_update, &DataSource::commandUpdate },
+  { commandHash("RESET"), c_cmd_reset, &DataSource::commandReset },
+  { commandHash("ATH"), c_cmd_ath, &DataSource::commandATH }, // All-Time-High
+  { commandHash("MSG"), c_cmd_msg, &DataSource::commandMessage }, // Announcement
+  { commandHash("STATICMSG"), c_cmd_staticmsg, &DataSource::commandStaticMessage },
+  { commandHash("MSGSTATIC"), c_cmd_msgstatic, &DataSource::commandStaticMessage },
+  { commandHash("PARAM"), c_cmd_param, &DataSource::commandParameter }, // parameter update
+  { commandHash("OTP"), c_cmd_otp, &DataSource::commandOTP },
+  { commandHash("OTP_ACK"), c_cmd_otp_ack, &DataSource::commandOTPAck }, // OTP acknowledge
+  { commandHash("DATA_TIMEOUT"), c_cmd_data_timeout, &DataSource::commandDataTimeout },
+  { commandHash("GET_PARAMS"), c_cmd_get_params, &DataSource::commandGetParameters },
+  { commandHash("NEW_SETTINGS_LOADED"), c_cmd_new_settings, &DataSource::commandNewSettings },
+  { commandHash("HB"), c_cmd_hb, &DataSource::commandHeartbeat },
+  { commandHash("FRAME_DUMP"), c_cmd_frame_dump, &DataSource::commandFrameDump },
+  { commandHash("BENCHMARK"), c_cmd_benchmark, &DataSource::commandBenchmark },
+  { commandHash("FW_BEGIN"), c_cmd_fw_begin, &DataSource::commandFirmwareBegin }, // firmware over websocket
+  { commandHash(""), c_cmd_comment, &DataSource::commandComment },
+};
+
+void DataSource::textCallback(const TextView& str)
+{
+  if (str.empty()) return;
+
+  if (str.charAt(0) != ';') {
     if (isdigit(str.charAt(0)) ||
       (str.charAt(0)=='-' && isdigit(str.charAt(1)))
     ) {
       if (m_on_price_change)
         m_on_price_change(str);
     } else {
-      DEBUG_SERIAL.printf_P(PSTR("[WSc] Unknown text '%s'\n"),str.c_str());
+      DEBUG_SERIAL.printf_P(PSTR("[WSc] Unknown text '%.*s'\n"), (int) str.length, str.data);
     }
+    return;
+  }
+
+  // ";NAME", ";NAME args" or ";NAME=args"
+  size_t name_end = 1;
+  while (name_end < str.length && str.data[name_end]!=' ' && str.data[name_end]!='=')
+    ++name_end;
+  const TextView name = str.substring(1, name_end);
+  const TextView args = str.substring(name_end + 1);
+  const uint32_t hash = commandHash(name);
+
+  for (size_t i=0;i<sizeof(c_commands)/sizeof(c_commands[0]);++i) {
+    Command command;
+    memcpy_P(&command, &c_commands[i], sizeof(command));
+    if (command.hash == hash && name.equals_P(command.name)) {
+      (this->*command.handler)(args);
+      return;
+    }
+  }
+
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Unknown message '%.*s'\n"), (int) str.length, str.data);
+}
+
+void DataSource::commandUpdate(const TextView& args)
+{
+  if (m_on_update_request)
+    m_on_update_request();
+}
+
+void DataSource::commandReset(const TextView& args)
+{
+  g_parameters.flush();
+  ESP.restart();
+}
+
+void DataSource::commandATH(const TextView& args)
+{
+  if (m_on_price_ath)
+    m_on_price_ath(args);
+}
+
+void DataSource::commandMessage(const TextView& args)
+{
+  if (m_on_announcement)
+    m_on_announcement(args, false, 0);
+}
+
+void DataSource::commandStaticMessage(const TextView& args)
+{
+  if (!m_on_announcement)
+    return;
+
+  int msg_idx = args.indexOf(' ');
+  if (msg_idx==-1)
+    return;
+
+  int display_time = args.substring(0, msg_idx).toInt();
+  m_on_announcement(args.substring(msg_idx+1), true, display_time);
+}
+
+void DataSource::commandParameter(const TextView& args)
+{
+  int index = args.indexOf(' ');
+  if (index==-1)
+    index = args.length;
+  // parameters are kept, so this is the one place where the payload gets copied
+  String param_name = args.substring(0,index).toString();
+  String param_value = args.substring(index+1).toString();
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Parameter '%s' updated to '%s'\n"),param_name.c_str(), param_value.c_str());
+  parameterCallback(param_name, param_value);
+}
+
+void DataSource::commandOTP(const TextView& args)
+{
+  if (m_on_otp)
+    m_on_otp(args);
+}
+
+void DataSource::commandOTPAck(const TextView& args)
+{
+  if (m_on_otp_ack)
+    m_on_otp_ack();
+}
+
+void DataSource::commandDataTimeout(const TextView& args)
+{
+  if (m_on_price_timeout_set)
+    m_on_price_timeout_set(args);
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Data timeout set to '%.*s' secs\n"), (int) args.length, args.data);
+}
+
+void DataSource::commandGetParameters(const TextView& args)
+{
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Parameters requested, sending\n"));
+  sendAllParameters();
+}
+
+void DataSource::commandNewSettings(const TextView& args)
+{
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] New settings loaded\n"));
+  if (m_on_new_settings)
+    m_on_new_settings();
+}
+
+void DataSource::commandHeartbeat(const TextView& args)
+{
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Heartbeat received\n"));
+}
+
+void DataSource::commandFrameDump(const TextView& args)
+{
+  const int separator = args.indexOf(' ');
+  const TextView step_args = (separator == -1) ? TextView{"", 0} : args.substring(separator+1);
+  const int images_separator = step_args.indexOf(' ');
+  const long count = std::min(std::max(args.toInt(), 0L), 1000L);
+  const long step_ms = std::max(step_args.toInt(), 0L);
+  const bool images = (images_separator == -1) || step_args.substring(images_separator+1).toInt() != 0;
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Dumping %ld frames, step %ld ms\n"), count, step_ms);
+  if (g_display)
+    g_display->captureFrames(count, (step_ms > 0) ? step_ms * 1000 : g_display->getMilisPerTick() * 1000, images);
+}
+
+void DataSource::commandBenchmark(const TextView& args)
+{
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Benchmark '%.*s' requested\n"), (int) args.length, args.data);
+  if (m_on_benchmark)
+    m_on_benchmark(args);
+}
+
+// ";FW_BEGIN size md5 delta", answered by ";FW_READY md5 offset" to start (or resume) sending chunks
+void DataSource::commandFirmwareBegin(const TextView& args)
+{
+  const int md5_separator = args.indexOf(' ');
+  const int delta_separator = (md5_separator == -1) ? -1 : args.indexOf(' ', md5_separator+1);
+  const long size = args.toInt();
+  if (delta_separator == -1 || size <= 0) {
+    queueText(";FW_ERROR arguments");
+    return;
   }
+  const String md5 = args.substring(md5_separator+1, delta_separator).toString();
+  const bool delta = args.substring(delta_separator+1).toInt() != 0;
+
+  DEBUG_SERIAL.printf_P(PSTR("[WSc] Firmware transfer of %ld bytes, md5 %s, delta %d\n"), size, md5.c_str(), delta);
+  if (!m_firmware.begin(size, md5, delta)) {
+    queueText(";FW_ERROR begin");
+    return;
+  }
+  m_firmware_data_at = millis();
+  sendText(";FW_READY " + m_firmware.getMD5() + " " + String(m_firmware.getReceived()));
+}
+
+/* Binary frame: offset (4 bytes), CRC32 of the data (4 bytes), data. Every chunk is answered
+   right away (not through the send queue, which is rate limited) by ";FW_ACK next_offset", or
+   ";FW_NAK expected_offset" to make the server resend from there; the server keeps only a few
+   chunks unacknowledged. */
+void DataSource::firmwareChunkCallback(const uint8_t *payload, const size_t length)
+{
+  if (!m_firmware.isActive() || payload == nullptr || length < c_firmware_chunk_header) {
+    DEBUG_SERIAL.printf_P(PSTR("[WSc] Unexpected binary frame, length: %u\n"), (uint32_t) length);
+    return;
+  }
+
+  const uint32_t offset = payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t) payload[3] << 24);
+  const uint32_t crc = payload[4] | (payload[5] << 8) | (payload[6] << 16) | ((uint32_t) payload[7] << 24);
+  const auto result = m_firmware.writeChunk(offset, crc, payload + c_firmware_chunk_header, length - c_firmware_chunk_header);
+  switch (result) {
+    case FirmwareWriter::Chunk::OK:
+      break;
+    case FirmwareWriter::Chunk::CRC_ERROR:
+    case FirmwareWriter::Chunk::OFFSET_MISMATCH:
+      sendText(";FW_NAK " + String(m_firmware.getReceived()));
+      return;
+    case FirmwareWriter::Chunk::FAILED:
+      firmwareDone(false);
+      return;
+  }
+
+  m_firmware_data_at = millis();
+  sendText(";FW_ACK " + String(m_firmware.getReceived()));
+  if (m_on_firmware_progress)
+    m_on_firmware_progress(m_firmware.getReceived(), m_firmware.getSize());
+
+  if (m_firmware.isComplete())
+    firmwareDone(m_firmware.finish());
+}
+
+void DataSource::firmwareDone(const bool success)
+{
+  sendText(success ? F(";FW_DONE 1") : F(";FW_DONE 0"));
+  if (m_on_firmware_received)
+    m_on_firmware_received(success);
+}
+
+void DataSource::commandComment(const TextView& args)
+{
+  if (args.startsWith_P(PSTR("Welcome")))
+    DEBUG_SERIAL.printf_P(PSTR("[WSc] Welcome message received\n"));
+  else
+    DEBUG_SERIAL.printf_P(PSTR("[WSc] Unknown message '; %.*s'\n"), (int) args.length, args.data);
 }
 
 void DataSource::parameterCallback(const String& param_name, const String& param_value)
@@ -207,12 +441,12 @@ void DataSource::parameterCallback(const String& param_name, const String& param
 
   if (param_name=="ticker_path") // legacy
   {
-    String value = Utils::urlChangePath(g_parameters["ticker_url"],param_value);
+    String value = Utils::urlChangePath(g_parameters.getString(ParameterId::TICKER_URL),param_value);
     g_parameters.setIfExistsAndTriggerCallback("ticker_url", value, true);
   } else {
     g_parameters.setIfExistsAndTriggerCallback(param_name, param_value, true);
   }
-  g_parameters.storeToEEPROM();
+  g_parameters.scheduleStore();
 }
 
 void DataSource::callback(WStype_t type, uint8_t * payload, size_t length)
@@ -237,28 +471,37 @@ void DataSource::callback(WStype_t type, uint8_t * payload, size_t length)
     else
       DEBUG_SERIAL.printf_P(PSTR("[WSc] Connected to url: %s\n"),payload);
     m_hello_sent = false;
+    g_boot_profiler.mark(BootProfiler::Stage::WEBSOCKET_CONNECTED);
     break;
   case WStype_TEXT:
+    if (m_benchmark_running) {
+      textCallback(TextView{(const char*) payload, length});
+      break;
+    }
     m_last_data_received_at = millis();
     m_connected = true;
+    g_boot_profiler.mark(BootProfiler::Stage::FIRST_TEXT);
     if (!m_hello_sent) {
       m_hello_sent = true;
       sendHello();
       sendAllParameters();
       sendDiagnostics();
+      if (m_firmware.isActive()) { // interrupted transfer, server continues from there
+        m_firmware_data_at = millis();
+        queueText(";FW_READY " + m_firmware.getMD5() + " " + String(m_firmware.getReceived()));
+      }
     }
 
     if (payload==nullptr) {
       DEBUG_SERIAL.println(F("[WSc] got empty text!"));
     } else {
-      DEBUG_SERIAL.printf_P(PSTR("[WSc] got text: %s\n"), payload);
-      textCallback(String((char*)payload));
+      DEBUG_SERIAL.printf_P(PSTR("[WSc] got text: %.*s\n"), (int) length, payload);
+      textCallback(TextView{(const char*) payload, length});
     }
     break;
   case WStype_BIN:
     m_last_data_received_at = millis();
-    DEBUG_SERIAL.printf_P(PSTR("[WSc] got binary, length: %u\n"), length);
-    hexdump(payload, length);
+    firmwareChunkCallback(payload, length);
     break;
   case WStype_ERROR:
   case WStype_FRAGMENT:
@@ -24,6 +24,8 @@
 #pragma once
 #include "config_common.hpp"
 #include "parameter_store.hpp"
+#include "text_view.hpp"
+#include "firmware_writer.hpp"
 #include <WebSocketsClient.h>
 #undef NETWORK_W5100 // To fix WebSockets and NTPClientLib #define conflict
 #undef NETWORK_ENC28J60
@@ -31,14 +33,18 @@
 
 #include <queue>
 
-typedef std::function<void(const String&)> on_price_change_t;
-typedef std::function<void(const String&)> on_price_ath_t;
+// arguments are views into the received frame, valid only for the duration of the callback
+typedef std::function<void(const TextView&)> on_price_change_t;
+typedef std::function<void(const TextView&)> on_price_ath_t;
 typedef std::function<void(void)> on_update_request_t;
-typedef std::function<void(const String&, const bool, const int)> on_announcement_t;
-typedef std::function<void(const String&)> on_otp_t;
+typedef std::function<void(const TextView&, const bool, const int)> on_announcement_t;
+typedef std::function<void(const TextView&)> on_otp_t;
 typedef std::function<void(void)> on_otp_ack_t;
-typedef std::function<void(const String&)> on_price_timeout_set_t;
+typedef std::function<void(const TextView&)> on_price_timeout_set_t;
 typedef std::function<void(void)> on_new_settings_t;
+typedef std::function<void(const TextView&)> on_benchmark_t;
+typedef std::function<void(const uint32_t received, const uint32_t total)> on_firmware_progress_t;
+typedef std::function<void(const bool success)> on_firmware_received_t;
 
 class DataSource
 {
@@ -48,7 +54,9 @@ public:
     m_should_send_hello(false), m_hello_sent(true), m_last_heartbeat_sent_at(0),
     m_last_data_received_at(0), m_text_last_sent_at(0),
     m_on_price_change(nullptr), m_on_price_ath(nullptr), m_on_update_request(nullptr),  m_on_announcement(nullptr),
-    m_on_otp(nullptr), m_on_otp_ack(nullptr), m_on_price_timeout_set(nullptr), m_on_new_settings(nullptr)
+    m_on_otp(nullptr), m_on_otp_ack(nullptr), m_on_price_timeout_set(nullptr), m_on_new_settings(nullptr),
+    m_on_benchmark(nullptr), m_on_firmware_progress(nullptr), m_on_firmware_received(nullptr),
+    m_firmware_data_at(0), m_benchmark_running(false)
   {
     m_websocket.onEvent(DataSource::s_callback);
   }
@@ -57,6 +65,11 @@ public:
   void disconnect();
   void reconnect();
   void loop();
+  bool isConnected() { return m_connected; }
+  bool isReceivingFirmware() { return m_firmware.isActive(); } // see commandFirmwareBegin()
+  // text is synthetic (see Benchmark::run()), not logged and not counted as received data
+  void setBenchmarkRunning(const bool running) { m_benchmark_running = running; }
+  bool isBenchmarkRunning() { return m_benchmark_running; }
 
   void setOnPriceChange(on_price_change_t func) { m_on_price_change = func; }
   void setOnPriceATH(on_price_ath_t func) { m_on_price_ath = func; }
@@ -66,12 +79,17 @@ public:
   void setOnOTPack(on_otp_ack_t func) { m_on_otp_ack = func; }
   void setOnPriceTimeoutSet(on_price_timeout_set_t func) { m_on_price_timeout_set = func; }
   void setOnNewSettings(on_new_settings_t func) { m_on_new_settings = func; }
+  void setOnBenchmark(on_benchmark_t func) { m_on_benchmark = func; }
+  void setOnFirmwareProgress(on_firmware_progress_t func) { m_on_firmware_progress = func; }
+  void setOnFirmwareReceived(on_firmware_received_t func) { m_on_firmware_received = func; }
   bool sendOTPRequest();
 
   void sendParameter(const ParameterItem *item);
 
   static void s_callback(WStype_t type, uint8_t * payload, size_t length);
   void queueText(const String& text);
+  // once per boot, when the boot profile is complete
+  void sendBootProfile();
 private:
   void sendText(const String& text);
   void sendHello();
@@ -79,8 +97,36 @@ private:
   void sendAllParameters();
 
   void callback(WStype_t type, uint8_t * payload, size_t length);
-  void textCallback(const String& text);
+  void textCallback(const TextView& text);
   void parameterCallback(const String& name, const String& value);
+  void firmwareChunkCallback(const uint8_t *payload, const size_t length);
+  void firmwareDone(const bool success);
+
+  // protocol commands (";NAME args" or ";NAME=args"), dispatched from c_commands
+  typedef void (DataSource::*command_handler_t)(const TextView& args);
+  struct Command {
+    uint32_t hash;
+    PGM_P name;
+    command_handler_t handler;
+  };
+  static const Command c_commands[];
+
+  void commandUpdate(const TextView& args);
+  void commandReset(const TextView& args);
+  void commandATH(const TextView& args);
+  void commandMessage(const TextView& args);
+  void commandStaticMessage(const TextView& args);
+  void commandParameter(const TextView& args);
+  void commandOTP(const TextView& args);
+  void commandOTPAck(const TextView& args);
+  void commandDataTimeout(const TextView& args);
+  void commandGetParameters(const TextView& args);
+  void commandNewSettings(const TextView& args);
+  void commandHeartbeat(const TextView& args);
+  void commandFrameDump(const TextView& args);
+  void commandBenchmark(const TextView& args);
+  void commandFirmwareBegin(const TextView& args);
+  void commandComment(const TextView& args);
 
   bool m_connected;
   long m_last_connected_at;
@@ -93,6 +139,8 @@ private:
   static const int c_heartbeat_interval = 30 * 1000;
   static const int c_force_reconnect_interval = 120 * 1000;
   static const int c_no_data_reconnect_interval = 300 * 1000;
+  static const size_t c_firmware_chunk_header = 8; // offset and CRC32, little endian
+  static const int c_firmware_stall_timeout = 60 * 1000;
 
   on_price_change_t m_on_price_change;
   on_price_ath_t m_on_price_ath;
@@ -102,6 +150,12 @@ private:
   on_otp_ack_t m_on_otp_ack;
   on_price_timeout_set_t m_on_price_timeout_set;
   on_new_settings_t m_on_new_settings;
+  on_benchmark_t m_on_benchmark;
+  on_firmware_progress_t m_on_firmware_progress;
+  on_firmware_received_t m_on_firmware_received;
+  FirmwareWriter m_firmware; // kept over reconnects, to resume the transfer
+  long m_firmware_data_at; // FW_BEGIN, FW_READY or the last accepted chunk
+  bool m_benchmark_running;
   WebSocketsClient m_websocket;
   std::queue<String> m_send_queue;
 };
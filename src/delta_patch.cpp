@@ -0,0 +1,156 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "delta_patch.hpp"
+#include <Updater.h>
+#include "device_identity.hpp"
+
+bool DeltaPatch::write(const uint8_t *data, size_t length)
+{
+  while (length > 0) {
+    switch (m_state) {
+      case State::HEADER:
+      case State::OP:
+      case State::ARGUMENTS: {
+        const uint8_t count = std::min((size_t) (m_needed - m_collected), length);
+        memcpy(m_buffer + m_collected, data, count);
+        m_collected += count;
+        data += count;
+        length -= count;
+        if (m_collected < m_needed)
+          break;
+
+        m_collected = 0;
+        if (m_state == State::HEADER) {
+          if (!parseHeader())
+            return false;
+          m_state = State::OP;
+          m_needed = 1;
+        } else if (m_state == State::OP) {
+          m_op = m_buffer[0];
+          if (m_op == c_op_end) {
+            m_state = State::FINISHED;
+          } else if (m_op == c_op_copy || m_op == c_op_insert) {
+            m_state = State::ARGUMENTS;
+            m_needed = (m_op == c_op_copy ? 8 : 4);
+          } else {
+            return fail(PSTR("unknown op"));
+          }
+        } else if (!runOp()) {
+          return false;
+        }
+        break;
+      }
+      case State::INSERT: {
+        const size_t count = std::min((size_t) m_insert_remaining, length);
+        if (!output(data, count))
+          return false;
+        m_insert_remaining -= count;
+        data += count;
+        length -= count;
+        if (m_insert_remaining == 0) {
+          m_state = State::OP;
+          m_needed = 1;
+        }
+        break;
+      }
+      case State::FINISHED:
+        return fail(PSTR("data after end"));
+      case State::FAILED:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool DeltaPatch::parseHeader()
+{
+  if (readU32(0) != c_magic || m_buffer[4] != c_version)
+    return fail(PSTR("invalid header"));
+
+  m_old_size = readU32(8);
+  const uint32_t new_size = readU32(12);
+  if (m_old_size != g_identity.getSketchSize())
+    return fail(PSTR("patch is for another sketch"));
+
+  if (!Update.begin(new_size, U_FLASH))
+    return fail(PSTR("can't start update"));
+
+  char md5[33];
+  for (uint8_t i=0;i<16;++i)
+    sprintf(md5 + i*2, "%02x", m_buffer[16 + i]);
+  Update.setMD5(md5);
+  DEBUG_SERIAL.printf_P(PSTR("[Update] Delta patch, %u -> %u bytes\n"), m_old_size, new_size);
+  return true;
+}
+
+bool DeltaPatch::runOp()
+{
+  if (m_op == c_op_copy)  {
+    if (!copy(readU32(0), readU32(4)))
+      return false;
+    m_state = State::OP;
+    m_needed = 1;
+  } else {
+    m_insert_remaining = readU32(0);
+    m_state = (m_insert_remaining > 0 ? State::INSERT : State::OP);
+    m_needed = 1;
+  }
+  return true;
+}
+
+// the running sketch is mapped from flash offset 0, reads have to be 4 byte aligned
+bool DeltaPatch::copy(uint32_t offset, uint32_t length)
+{
+  if (offset > m_old_size || length > m_old_size - offset)
+    return fail(PSTR("copy out of range"));
+
+  uint32_t buffer[c_copy_chunk / 4 + 1];
+  while (length > 0) {
+    const uint32_t aligned = offset & ~3;
+    const uint32_t skip = offset - aligned;
+    const uint32_t count = std::min(length, (uint32_t) c_copy_chunk);
+    if (!ESP.flashRead(aligned, buffer, (skip + count + 3) & ~3))
+      return fail(PSTR("flash read failed"));
+    if (!output((const uint8_t*) buffer + skip, count))
+      return false;
+    offset += count;
+    length -= count;
+  }
+  return true;
+}
+
+bool DeltaPatch::output(const uint8_t *data, const size_t length)
+{
+  if (Update.write(const_cast<uint8_t*>(data), length) != length)
+    return fail(PSTR("write failed"));
+  m_written += length;
+  return true;
+}
+
+bool DeltaPatch::fail(PGM_P reason)
+{
+  DEBUG_SERIAL.printf_P(PSTR("[Update] Delta patch failed: %s\n"), String(FPSTR(reason)).c_str());
+  m_state = State::FAILED;
+  return false;
+}
+
+uint32_t DeltaPatch::readU32(const uint8_t offset)
+{
+  return m_buffer[offset] | (m_buffer[offset+1] << 8) | (m_buffer[offset+2] << 16) | ((uint32_t) m_buffer[offset+3] << 24);
+}
@@ -0,0 +1,70 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*
+  Applies a binary delta patch (made by tools/make_patch.py) against the running sketch,
+  streaming the new image into the update partition through Updater. Patch data is pushed
+  in chunks of any size, as it arrives from the network.
+
+  Format, little endian:
+    header: "CCDP", version (1 byte), 3 reserved bytes, old size (4), new size (4), new MD5 (16)
+    ops:    0x01 COPY old offset (4), length (4) - copies from the running sketch
+            0x02 INSERT length (4), data         - literal data
+            0x00 END
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+
+class DeltaPatch
+{
+public:
+  DeltaPatch() : m_state(State::HEADER), m_needed(c_header_size), m_collected(0), m_insert_remaining(0), m_written(0) {}
+
+  // returns false on an invalid patch or failed write, the update is then aborted
+  bool write(const uint8_t *data, size_t length);
+  bool isFinished() { return m_state == State::FINISHED; }
+  uint32_t getWritten() { return m_written; } // bytes of the new image
+private:
+  enum class State : uint8_t { HEADER, OP, ARGUMENTS, INSERT, FINISHED, FAILED };
+
+  bool parseHeader();
+  bool runOp();
+  bool copy(uint32_t offset, uint32_t length);
+  bool output(const uint8_t *data, const size_t length);
+  bool fail(PGM_P reason); // PROGMEM
+  uint32_t readU32(const uint8_t offset);
+
+  State m_state;
+  uint8_t m_buffer[32]; // header or op arguments being collected
+  uint8_t m_needed;
+  uint8_t m_collected;
+  uint8_t m_op;
+  uint32_t m_insert_remaining;
+  uint32_t m_old_size;
+  uint32_t m_written;
+
+  static const uint8_t c_header_size = 32;
+  static const uint32_t c_magic = 0x50444343; // "CCDP"
+  static const uint8_t c_version = 1;
+  static const uint8_t c_op_end = 0x00;
+  static const uint8_t c_op_copy = 0x01;
+  static const uint8_t c_op_insert = 0x02;
+  static const size_t c_copy_chunk = 256;
+};
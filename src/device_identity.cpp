@@ -0,0 +1,60 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "device_identity.hpp"
+#include "parameter_store.hpp"
+
+extern ParameterStore g_parameters;
+
+const String& DeviceIdentity::getSketchMD5()
+{
+  if (m_sketch_md5 == "") {
+    const uint32_t started_at = millis();
+    m_sketch_md5 = ESP.getSketchMD5();
+    DEBUG_SERIAL.printf_P(PSTR("[Identity] Sketch MD5 %s, %u ms\n"), m_sketch_md5.c_str(), (uint32_t) (millis() - started_at));
+  }
+  return m_sketch_md5;
+}
+
+uint32_t DeviceIdentity::getSketchSize()
+{
+  if (m_sketch_size == 0)
+    m_sketch_size = ESP.getSketchSize();
+  return m_sketch_size;
+}
+
+uint32_t DeviceIdentity::getChipId()
+{
+  if (m_chip_id == 0)
+    m_chip_id = ESP.getChipId();
+  return m_chip_id;
+}
+
+const char *DeviceIdentity::getSdkVersion()
+{
+  if (m_sdk_version == nullptr)
+    m_sdk_version = ESP.getSdkVersion();
+  return m_sdk_version;
+}
+
+const String& DeviceIdentity::getUUID()
+{
+  if (m_uuid == "")
+    m_uuid = g_parameters.getString(ParameterId::DEVICE_UUID);
+  return m_uuid;
+}
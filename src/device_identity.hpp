@@ -0,0 +1,47 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*
+  Boot-invariant identity of the device and its firmware, computed on first use and then
+  served from RAM; hashing the sketch for its MD5 reads the whole image from flash.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+
+class DeviceIdentity
+{
+public:
+  DeviceIdentity() : m_sketch_size(0), m_chip_id(0), m_sdk_version(nullptr) {}
+
+  const String& getSketchMD5();
+  uint32_t getSketchSize();
+  uint32_t getChipId();
+  const char *getSdkVersion();
+  // generated on the first boot, so only valid after the parameters are loaded
+  const String& getUUID();
+private:
+  String m_sketch_md5;
+  uint32_t m_sketch_size;
+  uint32_t m_chip_id;
+  const char *m_sdk_version;
+  String m_uuid;
+};
+
+extern DeviceIdentity g_identity;
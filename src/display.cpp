@@ -19,44 +19,118 @@
 
 #include <Arduino.h>
 #include "display.hpp"
+#include "utils.hpp"
 
 namespace Display {
 DisplayT::~DisplayT() {}
 
-Coords DisplayT::centerTextOffset(const String& text)
+Coords DisplayT::centerTextOffset(const int text_width)
 {
   return Coords {
-    (int) std::max(ceil((getDisplayWidth() - getTextWidth(text)) / 2.0), 0.0),
+    (int) std::max(ceil((getDisplayWidth() - text_width) / 2.0), 0.0),
     - (int) std::max(floor((getDisplayHeight() - getCurrentFontHeight()) / 2.0), 0.0)
   };
 }
 
-void DisplayT::setupTickCallback(Ticker::callback_t callback)
+void DisplayT::tick(void)
 {
-    m_ticker.attach(c_milis_per_tick / 1000.0,callback);
+  const uint32_t current_time = micros();
+  const uint32_t elapsed_time = current_time - m_last_tick_at; // wraparound safe
+  m_last_tick_at = current_time;
+  if (m_capture_pending)
+    return;
+
+  step((m_capture_frames > 0) ? m_capture_step : elapsed_time);
 }
 
-void DisplayT::tick(void)
+void DisplayT::captureFrames(const uint16_t count, const uint32_t step_us, const bool images)
+{
+  m_capture_frames = count;
+  m_capture_step = step_us;
+  m_capture_images = images;
+  m_captured_frames = 0;
+  m_capture_hash = Utils::fnv1a(nullptr, 0);
+}
+
+void DisplayT::captureFrame(const uint32_t elapsed_time)
 {
-  unsigned long current_time = micros();
-  double elapsed_time = (current_time - m_last_tick_at) / 1000000.0;
-  m_last_tick_at = micros();
+  const uint32_t hash = getFrameHash();
+  m_capture_hash = Utils::fnv1a((const uint8_t*) &hash, sizeof(hash), m_capture_hash);
+  ++m_captured_frames;
+  --m_capture_frames;
+  m_capture_elapsed = elapsed_time;
+  m_capture_pending = true;
+}
+
+void DisplayT::dumpCapturedFrame(void)
+{
+  if (!m_capture_pending)
+    return;
+
+  DEBUG_SERIAL.printf_P(PSTR("[Display] frame %u, +%u us, hash %08x\n"), m_captured_frames, m_capture_elapsed, getFrameHash());
+  if (m_capture_images)
+    dumpFrame(DEBUG_SERIAL);
+  if (m_capture_frames == 0)
+    DEBUG_SERIAL.printf_P(PSTR("[Display] capture finished, frames %u, hash %08x\n"), m_captured_frames, m_capture_hash);
+  m_capture_pending = false;
+}
 
+void DisplayT::step(const uint32_t elapsed_time)
+{
+#if defined(X_DISPLAY_PROFILER)
+  const uint32_t started_at = micros();
+#endif
   while(true) {
     if (m_actions.empty())
       return;
 
     auto action = m_actions.at(0);
+#if defined(X_DISPLAY_PROFILER)
+    uint32_t phase_started_at = micros();
+#endif
     action->tick(this, elapsed_time);
+#if defined(X_DISPLAY_PROFILER)
+    uint32_t phase_time = micros() - phase_started_at;
+    m_profiler.addPhase(FrameProfiler::PHASE_TICK, phase_time);
+    m_profiler.addAction(action->getName(), FrameProfiler::PHASE_TICK, phase_time);
+#endif
 
     if (action->isFinished()) {
       m_actions.erase(m_actions.begin());
       continue;
     }
+#if defined(X_DISPLAY_PROFILER)
+    phase_started_at = micros();
+#endif
     clearBuffer();
     resetBrightness();
     action->draw(this, Coords{0,0});
-    sendBuffer();
+    ++m_frames_rendered;
+    if (m_capture_frames > 0)
+      captureFrame(elapsed_time);
+#if defined(X_DISPLAY_PROFILER)
+    phase_time = micros() - phase_started_at;
+    m_profiler.addPhase(FrameProfiler::PHASE_DRAW, phase_time);
+    m_profiler.addAction(action->getName(), FrameProfiler::PHASE_DRAW, phase_time);
+    phase_started_at = micros();
+#endif
+
+    if (isFrameChanged() || m_frames_skipped >= c_max_frames_skipped) {
+      if (m_frames_skipped >= c_max_frames_skipped) {
+        invalidateFrame();
+        setBrightness(m_sent_brightness);
+      }
+      sendBuffer();
+      ++m_frames_sent;
+      m_frames_skipped = 0;
+    } else {
+      ++m_frames_skipped;
+    }
+#if defined(X_DISPLAY_PROFILER)
+    const uint32_t finished_at = micros();
+    m_profiler.addPhase(FrameProfiler::PHASE_SEND, finished_at - phase_started_at);
+    m_profiler.addFrame(finished_at - started_at, c_milis_per_tick * 1000);
+#endif
     break;
   }
 }
@@ -70,14 +144,14 @@ void DisplayT::queueAction(shared_ptr<ActionT> action)
 void DisplayT::prependAction(shared_ptr<ActionT> action)
 {
   action->setFinished(false);
-  action->tick(this, 0.0);
+  action->tick(this, 0);
   m_actions.insert(m_actions.begin(), action);
 }
 
 void DisplayT::replaceAction(shared_ptr<ActionT> action)
 {
   action->setFinished(false);
-  action->tick(this, 0.0);
+  action->tick(this, 0);
   m_actions[0] = action;
 }
 
@@ -117,7 +191,7 @@ const uint8_t DisplayT::getFont()
   return m_current_font;
 }
 
-void DisplayT::displayTextHCentered(const String& value, const Coords& coords)
+void DisplayT::displayTextHCentered(const char *value, const Coords& coords)
 {
   auto offset = DisplayT::centerTextOffset(value);
   displayText(value, coords + Coords{offset.x,0});
@@ -26,11 +26,11 @@
 #pragma once
 
 #include "config_common.hpp"
-#include <Ticker.h>
 #include <vector>
 #include <memory>
 
 #include "display_action.hpp"
+#include "frame_profiler.hpp"
 
 using std::vector;
 using std::shared_ptr;
@@ -40,18 +40,22 @@ class DisplayT
 {
 public:
   DisplayT(const int milis_per_tick) :
-    m_enabled(true), m_current_font(0), c_milis_per_tick(milis_per_tick), m_brightness(0)
+    m_enabled(true), m_current_font(0), c_milis_per_tick(milis_per_tick), m_brightness(0), m_sent_brightness(-1),
+    m_frames_rendered(0), m_frames_sent(0), m_frames_skipped(0), m_capture_frames(0), m_capture_step(0),
+    m_capture_images(false), m_captured_frames(0), m_capture_hash(0), m_capture_pending(false), m_capture_elapsed(0)
   {
     m_last_tick_at = micros();
   }
   virtual ~DisplayT() = 0;
 
   virtual void displayNumber(const int number, const int length=0, const int position=0, const bool zero_fill=false) = 0;
-  virtual void displayText(const String& value, const Coords& coords) = 0;
+  virtual void displayText(const char *value, const Coords& coords) = 0;
+  void displayText(const String& value, const Coords& coords) { displayText(value.c_str(), coords); }
   virtual void displayBitmap(const unsigned char *bitmap, const Coords& coords, const int w, const int h) =0;
   virtual void displayBitmapP(const unsigned char *bitmap, const Coords& coords, const int w, const int h) = 0;
 
-  void displayTextHCentered(const String& value, const Coords& coords);
+  void displayTextHCentered(const char *value, const Coords& coords);
+  void displayTextHCentered(const String& value, const Coords& coords) { displayTextHCentered(value.c_str(), coords); }
 
   virtual void fill(const Coords& coords, const int color=1) = 0;
 
@@ -61,19 +65,24 @@ public:
 
   virtual void clearBuffer(void) = 0;
   virtual void sendBuffer(void) = 0;
-  virtual int getTextWidth(const String& text) = 0;
+  virtual bool isFrameChanged(void) { return true; } // false if the buffer equals the last sent one
+  virtual void invalidateFrame(void) {} // next sendBuffer() sends the whole frame
+  virtual void dumpFrame(Print& out) {} // buffer as plain PBM (P1) image, one text row per pixel row
+  virtual uint32_t getFrameHash(void) { return 0; } // hash of the buffer, identical frames hash the same
+  virtual int getTextWidth(const char *text) = 0;
+  int getTextWidth(const String& text) { return getTextWidth(text.c_str()); }
 
   void setDisplayBrightness(const uint8_t brightness)
   {
     m_brightness = brightness;
-    setBrightness(m_brightness);
+    applyBrightness(m_brightness);
   }
   void useBrightness(const uint8_t brightness)
   {
-    setBrightness(brightness);
+    applyBrightness(brightness);
   }
   void resetBrightness() {
-    setBrightness(m_brightness);
+    applyBrightness(m_brightness);
   }
 
   virtual void setDrawColor(const uint8_t color) = 0;
@@ -83,14 +92,24 @@ public:
   virtual int getCurrentFontHeight() = 0;
   virtual bool isNumeric(void) = 0;
   virtual bool isGraphic(void) = 0;
-  Coords centerTextOffset(const String& text);
+  Coords centerTextOffset(const int text_width);
+  Coords centerTextOffset(const char *text) { return centerTextOffset(getTextWidth(text)); }
+  Coords centerTextOffset(const String& text) { return centerTextOffset(text.c_str()); }
 
   void setFont(const uint8_t font);
   virtual void useFont() {};
   const uint8_t getFont();
 
-  void setupTickCallback(Ticker::callback_t callback);
+  int getMilisPerTick() { return c_milis_per_tick; }
   void tick(void);
+  void step(const uint32_t elapsed_time); // advances actions by elapsed_time (us) and renders one frame
+  /* dumps hashes (and images) of the next frames to serial, advancing them by fixed step_us instead
+     of real time, so that a scripted timeline renders the same on every run; the hash of the whole
+     sequence printed at the end is the value to compare between firmware builds */
+  void captureFrames(const uint16_t count, const uint32_t step_us, const bool images=true);
+  /* prints the captured frame, from the main context: an image takes most of a second of serial
+     output, too long for the background ticker; the display holds the frame until then */
+  void dumpCapturedFrame(void);
   void queueAction(shared_ptr<ActionT> action);
   void prependAction(shared_ptr<ActionT> action);
   void replaceAction(shared_ptr<ActionT> action);
@@ -99,17 +118,46 @@ public:
   void cleanQueue(void);
   shared_ptr<ActionT> getTopAction(void);
 
+  uint32_t getFramesRendered() { return m_frames_rendered; }
+  uint32_t getFramesSent() { return m_frames_sent; }
+#if defined(X_DISPLAY_PROFILER)
+  FrameProfiler& getProfiler() { return m_profiler; }
+#endif
+
 protected:
   virtual void setBrightness(const uint8_t brightness) = 0; // 0..255
+  void applyBrightness(const uint8_t brightness) // sends the brightness only when it changes
+  {
+    if (brightness == m_sent_brightness)
+      return;
+    m_sent_brightness = brightness;
+    setBrightness(brightness);
+  }
+  void captureFrame(const uint32_t elapsed_time);
 
-  unsigned long m_last_tick_at;
+  uint32_t m_last_tick_at;
   bool m_enabled;
   vector<shared_ptr<ActionT>> m_actions;
-  Ticker m_ticker;
   uint8_t m_current_font;
   const int c_milis_per_tick;
   uint8_t m_brightness;
+  int16_t m_sent_brightness; // -1 until the first frame
 //  uint8_t m_num_fonts;
+
+  uint32_t m_frames_rendered;
+  uint32_t m_frames_sent;
+  uint8_t m_frames_skipped; // consecutive unchanged frames
+  static const uint8_t c_max_frames_skipped = 30; // resend anyway, so that the display recovers from glitches
+  uint16_t m_capture_frames;
+  uint32_t m_capture_step;
+  bool m_capture_images;
+  uint16_t m_captured_frames;
+  uint32_t m_capture_hash;
+  bool m_capture_pending; // frame rendered, waiting for dumpCapturedFrame()
+  uint32_t m_capture_elapsed;
+#if defined(X_DISPLAY_PROFILER)
+  FrameProfiler m_profiler;
+#endif
 };
 }
 
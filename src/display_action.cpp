@@ -22,7 +22,7 @@
 #include "display.hpp"
 
 namespace Display {
-double ActionT::elapsedTime(void)
+uint32_t ActionT::elapsedTime(void)
 {
   return m_elapsed_time;
 }
@@ -41,36 +41,31 @@ void ActionT::setFinished(bool status)
 
 void ActionT::reset()
 {
-  m_elapsed_time = 0.0;
+  m_elapsed_time = 0;
   m_finished = false;
 }
 
 /* === Transition === */
 
-void Action::SlideTransition::tick(DisplayT *display, double elapsed_time)
+void Action::SlideTransition::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
+  advance(elapsed_time);
   if (m_actionA) m_actionA->tick(display, elapsed_time);
   if (m_actionB) m_actionB->tick(display, elapsed_time);
-  if (elapsedTime() > m_duration)
+  if (m_duration >= 0 && elapsedTime() > (uint32_t) m_duration)
     setFinished();
 }
 
-double slide_function(double position)
-{
-  double s = 0.5 + sin((position-0.5)*M_PI)*0.5;
-  return std::max(std::min(s,1.0),0.0);
-}
-
 void Action::SlideTransition::draw(DisplayT *display, Coords coords)
 {
   const int width = display->getDisplayWidth() * m_direction.x;
   const int height = display->getDisplayHeight() * m_direction.y;
 
-  const int offset_x_a = round(slide_function(elapsedTime() / m_duration) * width);
+  const uint16_t position = Easing::position(elapsedTime(), m_duration);
+  const int offset_x_a = Easing::scale(m_curve, position, width);
   const int offset_x_b = offset_x_a - width;
 
-  const int offset_y_a = round(slide_function(elapsedTime() / m_duration) * height);
+  const int offset_y_a = Easing::scale(m_curve, position, height);
   const int offset_y_b = offset_y_a - height;
 
   if (m_draw_priorityA>=m_draw_priorityB) {
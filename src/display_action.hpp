@@ -31,6 +31,7 @@
 #include "config_common.hpp"
 #include <memory>
 #include "coords.hpp"
+#include "easing.hpp"
 
 using std::shared_ptr;
 
@@ -39,28 +40,51 @@ typedef std::function<void(void)> action_callback_t;
 namespace Display {
 class DisplayT;
 
+/* Actions run on integer microseconds, elapsed times saturate instead of wrapping around.
+   Durations are given in seconds, negative duration means infinite. */
+typedef int32_t duration_t;
+
+constexpr duration_t toDuration(const double seconds)
+{
+  return (seconds < 0) ? -1 : (seconds >= 2147.0) ? INT32_MAX : (duration_t) (seconds * 1000000.0);
+}
+
+inline uint32_t addSaturating(const uint32_t a, const uint32_t b)
+{
+  return (a > UINT32_MAX - b) ? UINT32_MAX : a + b;
+}
+
+// units (pixels, digits, ...) passed in given time at given speed per second
+inline int32_t unitsInTime(const uint32_t time_us, const int32_t units_per_second)
+{
+  return (int64_t) time_us * units_per_second / 1000000;
+}
+
 class ActionT
 {
 public:
   ActionT(double duration, Coords coords, action_callback_t onfinished_cb = nullptr)
-    : m_duration(duration), m_coords(coords), m_finished(false), m_elapsed_time(0.0), m_onfinished_cb(onfinished_cb)
+    : m_duration(toDuration(duration)), m_coords(coords), m_finished(false), m_elapsed_time(0), m_onfinished_cb(onfinished_cb)
   {}
 
-  virtual void tick(DisplayT *display, double elapsed_time) = 0;
+  virtual void tick(DisplayT *display, uint32_t elapsed_time) = 0; // elapsed time in microseconds
   virtual void draw(DisplayT *display, Coords coords) = 0;
+  virtual const char *getName() { return "action"; } // action type, for profiling
   void reset();
   bool isFinished(void);
   void setFinished(bool status = true);
 
-  double elapsedTime(void);
+  uint32_t elapsedTime(void);
   // transition_from, transition_to
   void setCoords(Coords coords);
   virtual ~ActionT() = 0;
 protected:
-  double m_duration;
+  void advance(const uint32_t elapsed_time) { m_elapsed_time = addSaturating(m_elapsed_time, elapsed_time); }
+
+  duration_t m_duration;
   Coords m_coords;
   bool m_finished;
-  double m_elapsed_time;
+  uint32_t m_elapsed_time;
   action_callback_t m_onfinished_cb;
 };
 
@@ -72,13 +96,16 @@ class SlideTransition : public ActionT
 public:
   SlideTransition(shared_ptr<ActionT> actionA, const int draw_priorityA,
     shared_ptr<ActionT> actionB, const int draw_priorityB, double duration,
-    const Coords& direction, const Coords& coords=Coords{0,0})
+    const Coords& direction, const Coords& coords=Coords{0,0},
+    const Easing::Curve curve=Easing::Curve::EASE_IN_OUT)
     : ActionT(duration, coords), m_actionA(actionA), m_actionB(actionB),
-    m_draw_priorityA(draw_priorityA), m_draw_priorityB(draw_priorityB), m_direction(direction)
+    m_draw_priorityA(draw_priorityA), m_draw_priorityB(draw_priorityB), m_direction(direction),
+    m_curve(curve)
     {}
 
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "slide"; }
 private:
 
   shared_ptr<ActionT> m_actionA;
@@ -86,6 +113,7 @@ private:
   const int m_draw_priorityA;
   const int m_draw_priorityB;
   const Coords m_direction;
+  const Easing::Curve m_curve;
 };
 }
 }
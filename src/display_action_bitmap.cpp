@@ -22,11 +22,11 @@
 
 namespace Display {
 namespace Action {
-void StaticBitmap::tick(DisplayT *display, double elapsed_time)
+void StaticBitmap::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
+  advance(elapsed_time);
 
-  if (m_duration >= 0 && m_elapsed_time > m_duration)
+  if (m_duration >= 0 && m_elapsed_time > (uint32_t) m_duration)
     m_finished = true;
 }
 
@@ -37,8 +37,9 @@ public:
     : ActionT(duration, coords), m_data(data), m_width(width), m_height(height)
   {}
 
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "bitmap"; }
 protected:
   const unsigned char *m_data;
   const int m_width;
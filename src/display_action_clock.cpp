@@ -25,16 +25,16 @@
 
 namespace Display {
 namespace Action {
-void Clock::tick(DisplayT *display, double elapsed_time)
+void Clock::tick(DisplayT *display, uint32_t elapsed_time)
 {
   updateTime();
-  m_elapsed_time += elapsed_time;
+  advance(elapsed_time);
 
   if (m_always_on)
     return;
 
-  if (m_duration <= 0.0) return;
-  if (m_time=="" || m_elapsed_time > m_duration) {
+  if (m_duration <= 0) return;
+  if (m_time=="" || m_elapsed_time > (uint32_t) m_duration) {
     setFinished();
     m_elapsed_time = 0;
   }
@@ -35,8 +35,9 @@ public:
   Clock(double duration, const Coords& coords=Coords{0,0})
     : ActionT(duration, coords), m_time(""), m_always_on(false), m_is_time_set(false)
     {}
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "clock"; }
   void setAlwaysOn(bool always_on);
   bool isAlwaysOn();
   bool isTimeSet() { return m_is_time_set;}
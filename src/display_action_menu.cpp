@@ -22,7 +22,7 @@
 
 namespace Display {
 namespace Action {
-void MenuWrapper::tick(DisplayT *display, double elapsed_time)
+void MenuWrapper::tick(DisplayT *display, uint32_t elapsed_time)
 {
   if (m_menu->isFinished())
     setFinished(true);
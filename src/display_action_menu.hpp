@@ -37,8 +37,9 @@ public:
   MenuWrapper(Menu* menu, const Coords& coords=Coords{0,0})
     : ActionT(-1, coords), m_menu(menu)
     {}
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "menu"; }
 private:
   Menu* m_menu;
 };
@@ -23,10 +23,10 @@
 using namespace std;
 
 namespace Display { namespace Action {
-void MultiRepeat::tick(DisplayT *display, double elapsed_time)
+void MultiRepeat::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
-  if (m_duration > 0 && m_elapsed_time > m_duration)
+  advance(elapsed_time);
+  if (m_duration > 0 && m_elapsed_time > (uint32_t) m_duration)
     setFinished(true);
 
   if (m_actions.empty()) {
@@ -50,8 +50,9 @@ public:
   //     m_actions.push(*it);
   // }
 
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "multi"; }
 
 protected:
   std::queue<ActionPtr_t> m_actions;
@@ -20,22 +20,23 @@
 #include "config_common.hpp"
 #include "display_action_price.hpp"
 #include "data_source.hpp"
-#include <cmath>
+#include "alloc_counter.hpp"
+#include <cstdlib>
 
 extern DataSource *g_data_source;
 
 namespace Display {
-void PriceAction::tick(DisplayT *display, double elapsed_time)
+void PriceAction::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
+  advance(elapsed_time);
+  m_since_price_changed = addSaturating(m_since_price_changed, elapsed_time);
+  m_since_price_updated = addSaturating(m_since_price_updated, elapsed_time);
 
   /* send warning about receiving no price updates at 90% of set timeout,
      so that the server can send us repeated price in case of very slowly
      updating data sources */
-  const float timeout_pre_warning = 0.90f;
-
   if (m_price_timeout > 0 &&
-    (m_elapsed_time - m_price_last_updated_at) > (m_price_timeout * timeout_pre_warning))
+    m_since_price_updated > (uint32_t) m_price_timeout / 10 * 9)
   {
     if (!m_price_timeout_reported) {
       g_data_source->queueText(";WARN Data timeout imminent");
@@ -51,28 +52,29 @@ void PriceAction::tick(DisplayT *display, double elapsed_time)
     m_displayed_price < std::min(m_price, m_last_price) ||
     m_displayed_price > std::max(m_price, m_last_price);
 
-  const double displayed_price_delta = fabs(m_displayed_price.delta(m_price));
-  const double price_delta = fabs(m_price.delta(m_last_price));
-  const double price_delta_from_start = outside_bounds ? 0 : fabs(m_displayed_price.delta(m_last_price));
-  const double price_delta_from_end = outside_bounds ? price_delta : fabs(m_displayed_price.delta(m_price));
+  // deltas are in increments of the displayed price, scaled by Price::c_delta_unit
+  const int64_t unit = Price::c_delta_unit;
+  const int64_t displayed_price_delta = llabs(m_displayed_price.delta(m_price));
+  const int64_t price_delta = llabs(m_price.delta(m_last_price));
+  const int64_t price_delta_from_start = outside_bounds ? 0 : llabs(m_displayed_price.delta(m_last_price));
+  const int64_t price_delta_from_end = outside_bounds ? price_delta : llabs(m_displayed_price.delta(m_price));
 
-  double animation_multiplier = std::max(std::min(std::min(price_delta_from_start, price_delta_from_end), 3.0) / 3.0, 0.2);
+  int64_t animation_multiplier = std::max(std::min(std::min(price_delta_from_start, price_delta_from_end), 3*unit) / 3, unit / 5);
   if (outside_bounds)
-    animation_multiplier = 1.0;
+    animation_multiplier = unit;
 
-  animation_multiplier *=  std::max(displayed_price_delta, 40.0) / 40.0; // boost the speed if the price difference is too large
+  animation_multiplier = animation_multiplier * std::max(displayed_price_delta, 40*unit) / (40*unit); // boost the speed if the price difference is too large
 
-  const double animation_speed = m_animation_speed * animation_multiplier;
-  const double time_delta = elapsed_time * animation_speed;
+  const int64_t time_delta = (int64_t) elapsed_time * m_animation_speed * animation_multiplier / 1000000;
 
-  double p_anim_delta = time_delta*m_displayed_price.getIncrement();
+  const int64_t p_anim_delta = time_delta * m_displayed_price.getIncrement() / unit;
   if (m_price >= m_displayed_price) {
     m_displayed_price = std::min(m_displayed_price + p_anim_delta, m_price);
   } else {
     m_displayed_price = std::max(m_displayed_price - p_anim_delta, m_price);
   }
 
-  if (fabs(m_price.delta(m_displayed_price)) < 0.001) {
+  if (m_price.delta(m_displayed_price) == 0) {
      m_displayed_price = m_price;
      m_last_price = m_price;
   }
@@ -81,8 +83,8 @@ void PriceAction::tick(DisplayT *display, double elapsed_time)
 void PriceAction::blinkIfATH(DisplayT *display)
 {
   if (m_displayed_price >= m_ath_price &&
-    (m_elapsed_time - m_price_last_changed_at < c_ath_animation_length)) {
-    if ((int)((m_elapsed_time - m_price_last_changed_at) * 10) % 4 < 2 ) {
+    m_since_price_changed < (uint32_t) c_ath_animation_length) {
+    if ((m_since_price_changed / 100000) % 4 < 2 ) {
       display->useBrightness(0);
     } else {
       display->useBrightness(255);
@@ -95,65 +97,126 @@ void PriceAction::blinkIfATH(DisplayT *display)
 void PriceAction::blinkPixelIfReceivedPriceUpdate(DisplayT *display)
 {
   // blink pixel when we received price update
-  if (m_elapsed_time - m_price_last_updated_at <= 0.05)
+  if (m_since_price_updated <= 50000)
     display->drawPixel({display->getDisplayWidth()-1, display->getDisplayHeight()-1});
 }
 
+void PriceAction::invalidateGlyphWidths()
+{
+  memset(m_glyph_widths, -1, sizeof(m_glyph_widths));
+}
+
+int PriceAction::getGlyphWidth(DisplayT *display, const char glyph)
+{
+  if (glyph == '\0')
+    return 0;
+
+  const char text[2] = {glyph, '\0'};
+  if (glyph < c_first_cached_glyph || glyph > c_last_cached_glyph)
+    return display->getTextWidth(text);
+
+  if (m_glyph_widths_font != display->getFont()) {
+    invalidateGlyphWidths();
+    m_glyph_widths_font = display->getFont();
+  }
+
+  int8_t &width = m_glyph_widths[glyph - c_first_cached_glyph];
+  if (width < 0)
+    width = display->getTextWidth(text);
+  return width;
+}
+
+void PriceAction::updateLayout(DisplayT *display, const char *text, const size_t length)
+{
+  if (m_layout_valid && m_layout_font == display->getFont() &&
+    strncmp(m_layout_text, text, sizeof(m_layout_text)) == 0)
+    return;
+
+  memset(m_layout_text, 0, sizeof(m_layout_text));
+  memcpy(m_layout_text, text, std::min(length, sizeof(m_layout_text)-1));
+  m_layout_font = display->getFont();
+  m_layout_valid = true;
+  ++m_layout_updates;
+
+  m_layout_offset = display->centerTextOffset(m_layout_text); // higher price has more spaces
+
+  int offset_x = 0;
+  for (uint8_t i=0;i<c_max_glyphs;++i) {
+    m_layout_x[i] = offset_x;
+    offset_x += getGlyphWidth(display, m_layout_text[i])+1;
+  }
+}
+
 void PriceAction::draw(DisplayT *display, Coords orig_coords)
+{
+  const uint32_t allocations = AllocCounter::count();
+  drawPrice(display, orig_coords);
+  m_draw_allocations += AllocCounter::count() - allocations;
+}
+
+void PriceAction::drawPrice(DisplayT *display, Coords orig_coords)
 {
   if (!display->isGraphic()) {
     // FIXME: for numeric-only displays
-    if (display->isNumeric())
-      display->displayNumber((int)m_displayed_price.get());
+    if (display->isNumeric()) {
+      display->displayNumber(m_displayed_price.toInt());
+      m_price_drawn = m_price_drawn || m_price.isInitialized();
+    }
     return;
   }
 
   Coords coords = orig_coords + m_coords;
 
-  String price_top = m_displayed_price.toString();
-  String price_bottom = m_displayed_price.nextPrice().toString();
-  if (!m_price.isInitialized() || (m_price_timeout > 0 && (m_elapsed_time - m_price_last_updated_at) > m_price_timeout))
+  if (!m_price.isInitialized() || (m_price_timeout > 0 && m_since_price_updated > (uint32_t) m_price_timeout))
   {
-    String text = "-----";
+    const char *text = "-----";
     display->displayText(text, coords + display->centerTextOffset(text));
     return;
   }
 
+  // top price is written one char in, so that it can be padded with space
+  char price_top_buffer[c_max_glyphs+1];
+  char price_bottom[c_max_glyphs+1] = {};
+  char *price_top = price_top_buffer+1;
+  size_t price_top_length = m_displayed_price.toChars(price_top, sizeof(price_top_buffer)-1);
+  const size_t price_bottom_length = m_displayed_price.nextPrice().toChars(price_bottom, sizeof(price_bottom)-1);
+
   // fractional part = vertical position of animated glyph(s)
-  double tmp;
-  double fract = (double) std::modf(m_displayed_price.get(),&tmp);
-  fract = (double) std::modf(fract*m_displayed_price.getIncrExponent(),&tmp);
-  if (fract>0.999)
-    fract = 0.0;
-  if (fract<0.001)
-    fract = 0.1;
+  int32_t fract = m_displayed_price.stepFraction();
+  if (fract >= Price::c_delta_unit - 1)
+    fract = 0;
+  if (fract < 1)
+    fract = Price::c_delta_unit / 10;
 
   // FIXME:
   // if (fract<(0.01*m_displayed_price.getIncrement()))
   //   price_bottom = price_top; // for horizontal shift during rollovers
 
-  int offset_top = (int) (-fract * display->getDisplayHeight());
+  int offset_top = -(fract * display->getDisplayHeight() / Price::c_delta_unit);
   int offset_bottom = offset_top + display->getDisplayHeight();
 
-  if (price_bottom.length()>price_top.length())
-    price_top = " " + price_top;
+  if (price_bottom_length>price_top_length) {
+    *--price_top = ' ';
+    ++price_top_length;
+  }
 
   blinkIfATH(display);
 
-  coords += display->centerTextOffset(price_bottom); // higher price has more spaces
+  updateLayout(display, price_bottom, price_bottom_length);
+  coords += m_layout_offset;
 
-  int offset_x = 0;
-  for (unsigned int i=0;i<price_top.length();++i)
+  for (size_t i=0;i<price_top_length;++i)
   {
-    const int offset_dot_top = (price_top.charAt(i)=='.') ? -1 : 0;
-    const int offset_dot_bottom = (price_bottom.charAt(i)=='.') ? -1 : 0;
+    const int offset_x = m_layout_x[i];
+    const int offset_dot_top = (price_top[i]=='.') ? -1 : 0;
+    const int offset_dot_bottom = (price_bottom[i]=='.') ? -1 : 0;
     if (price_top[i]==price_bottom[i]) {
-      display->drawGlyph(price_top.charAt(i), coords + Coords{offset_x + offset_dot_top, 0});
+      display->drawGlyph(price_top[i], coords + Coords{offset_x + offset_dot_top, 0});
     } else {
-      display->drawGlyph(price_top.charAt(i), coords + Coords{offset_x + offset_dot_top, offset_top});
-      display->drawGlyph(price_bottom.charAt(i), coords + Coords{offset_x + offset_dot_bottom, offset_bottom});
+      display->drawGlyph(price_top[i], coords + Coords{offset_x + offset_dot_top, offset_top});
+      if (price_bottom[i] != '\0')
+        display->drawGlyph(price_bottom[i], coords + Coords{offset_x + offset_dot_bottom, offset_bottom});
     }
-    offset_x += display->getTextWidth(String(price_bottom[i]))+1;
   }
 
   if (display->getDisplayHeight() >= 64 ) {
@@ -165,12 +228,10 @@ void PriceAction::draw(DisplayT *display, Coords orig_coords)
   }
 
   blinkPixelIfReceivedPriceUpdate(display);
-  // blink pixel when we received price update
-  if (m_elapsed_time - m_price_last_updated_at <= 0.05)
-    display->drawPixel({display->getDisplayWidth()-1, display->getDisplayHeight()-1});
+  m_price_drawn = true;
 }
 
-void PriceAction::updatePrice(const String& n_price)
+void PriceAction::updatePrice(const TextView& n_price)
 {
   Price new_price(n_price);
   if (new_price.displayFloatPart())
@@ -181,7 +242,7 @@ void PriceAction::updatePrice(const String& n_price)
     g_data_source->queueText(";DIAG data_timeout_recovered");
   }
 
-  m_price_last_updated_at = m_elapsed_time;
+  m_since_price_updated = 0;
   m_price_timeout_reported = false;
   if (m_price == new_price)
     return;
@@ -196,25 +257,25 @@ void PriceAction::updatePrice(const String& n_price)
   }
   m_price = new_price;
 
-  m_price_last_changed_at = m_elapsed_time;
+  m_since_price_changed = 0;
 }
 
-void PriceAction::setATHPrice(const String& ath_price)
+void PriceAction::setATHPrice(const TextView& ath_price)
 {
   m_ath_price = Price(ath_price);
 }
 
 void PriceAction::reset()
 {
-  m_price = Price("");
-  m_last_price = Price("");
-  m_displayed_price = Price("");
+  m_price = Price();
+  m_last_price = Price();
+  m_displayed_price = Price();
   m_display_float_part = false;
 }
 
 void PriceAction::setPriceTimeout(double timeout)
 {
-  m_price_timeout = timeout;
+  m_price_timeout = toDuration(timeout);
 }
 
 }
@@ -21,44 +21,79 @@
   Action for animated display of price/ticker data
 */
 
+#pragma once
 #include "config_common.hpp"
 #include <Arduino.h>
 #include "display_action.hpp"
 #include "display.hpp"
 #include "price.hpp"
+#include "text_view.hpp"
 #include <limits>
 
 namespace Display {
 class PriceAction : public ActionT
 {
 public:
-  PriceAction(const double animation_speed, const Coords& coords=Coords{0,0})
-    : ActionT(-1, coords), m_animation_speed(animation_speed), m_price(""), m_last_price(""),
-      m_displayed_price(""), m_ath_price(""), m_price_timeout(300.0), m_display_float_part(false),
-      m_price_timeout_reported(false)
-    {}
+  PriceAction(const int animation_speed, const Coords& coords=Coords{0,0})
+    : ActionT(-1, coords), m_animation_speed(animation_speed), m_price(), m_last_price(),
+      m_displayed_price(), m_ath_price(), m_since_price_changed(UINT32_MAX), m_since_price_updated(0),
+      m_price_timeout(toDuration(300.0)), m_display_float_part(false),
+      m_price_timeout_reported(false), m_layout_offset{0,0}, m_layout_font(0), m_layout_valid(false), m_glyph_widths_font(0),
+      m_draw_allocations(0), m_layout_updates(0), m_price_drawn(false)
+    {
+      invalidateGlyphWidths();
+    }
 
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
-  void updatePrice(const String &price);
-  void setATHPrice(const String &ath_price);
+  const char *getName() { return "price"; }
+  void updatePrice(const TextView &price);
+  void setATHPrice(const TextView &ath_price);
   void reset();
 
   void setPriceTimeout(double timeout);
+  bool isAnimating() { return m_price != m_last_price; }
+
+  uint32_t getDrawAllocations() { return m_draw_allocations; }
+  uint32_t getLayoutUpdates() { return m_layout_updates; }
+  bool isPriceDrawn() { return m_price_drawn; } // a received price, not the "-----" placeholder, was drawn
 private:
+  void drawPrice(DisplayT *display, Coords coords);
   void blinkIfATH(DisplayT *display);
   void blinkPixelIfReceivedPriceUpdate(DisplayT *display);
+  void updateLayout(DisplayT *display, const char *text, const size_t length);
+  int getGlyphWidth(DisplayT *display, const char glyph);
+  void invalidateGlyphWidths();
 
-  double m_animation_speed;
+  int m_animation_speed; // digits per second
   Price m_price;
   Price m_last_price;
   Price m_displayed_price;
   Price m_ath_price;
-  double m_price_last_changed_at;
-  double m_price_last_updated_at;
-  double m_price_timeout; // after X seconds without receiving price updates, stop displaying it
-  static constexpr double c_ath_animation_length = 4.0;
+  uint32_t m_since_price_changed; // us, saturating
+  uint32_t m_since_price_updated;
+  duration_t m_price_timeout; // after X us without receiving price updates, stop displaying it
+  static constexpr duration_t c_ath_animation_length = toDuration(4.0);
   bool m_display_float_part;
   bool m_price_timeout_reported;
+
+  /* layout of the (higher) bottom price, glyph x positions and centering offset,
+     recomputed only when its text or the font changes */
+  static const uint8_t c_max_glyphs = Price::c_max_length + 1; // + space padding
+  char m_layout_text[c_max_glyphs+1];
+  int16_t m_layout_x[c_max_glyphs];
+  Coords m_layout_offset;
+  uint8_t m_layout_font;
+  bool m_layout_valid;
+
+  // advance widths of ' '..'9' (covers digits, '.', '-') for current font
+  static const char c_first_cached_glyph = ' ';
+  static const char c_last_cached_glyph = '9';
+  int8_t m_glyph_widths[c_last_cached_glyph - c_first_cached_glyph + 1];
+  uint8_t m_glyph_widths_font;
+
+  uint32_t m_draw_allocations; // heap allocations made while drawing, should stay 0
+  uint32_t m_layout_updates;
+  bool m_price_drawn;
 };
 }
@@ -0,0 +1,52 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "config_common.hpp"
+#include "display_action_progress.hpp"
+
+namespace Display {
+namespace Action {
+void Progress::setProgress(const uint32_t done, const uint32_t total)
+{
+  m_percent = (total == 0) ? 0 : std::min((uint64_t) done * 100 / total, (uint64_t) 100);
+}
+
+void Progress::tick(DisplayT *display, uint32_t elapsed_time)
+{
+  advance(elapsed_time);
+}
+
+void Progress::draw(DisplayT *display, Coords coords)
+{
+  const uint8_t percent = m_percent;
+  if (display->isNumeric()) {
+    display->displayNumber(percent);
+    return;
+  }
+
+  const String text = m_label + String(percent) + "%";
+  display->displayText(text, m_coords + coords + display->centerTextOffset(text));
+  if (display->isGraphic()) {
+    const int bottom = display->getDisplayHeight() - 1;
+    const int width = display->getDisplayWidth() * percent / 100;
+    if (width > 0)
+      display->drawLine(m_coords + coords + Coords{0, bottom}, m_coords + coords + Coords{width - 1, bottom});
+  }
+}
+}
+}
@@ -0,0 +1,49 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*
+  Action for displaying progress of a long running operation (firmware download): percentage
+  and a bar along the bottom row on graphic displays, a counting up number on numeric ones.
+  setProgress() may be called from the main context while the display runs in the background.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include "display_action.hpp"
+#include "display.hpp"
+
+namespace Display {
+namespace Action {
+class Progress : public ActionT
+{
+public:
+  Progress(const String& label, const Coords& coords = Coords{0,0})
+    : ActionT(-1, coords), m_label(label), m_percent(0)
+  {}
+
+  void setProgress(const uint32_t done, const uint32_t total);
+  void tick(DisplayT *display, uint32_t elapsed_time);
+  void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "progress"; }
+private:
+  String m_label;
+  volatile uint8_t m_percent;
+};
+}
+}
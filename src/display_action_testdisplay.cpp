@@ -25,9 +25,9 @@
 
 namespace Display {
 namespace Action {
-void TestDisplay::tick(DisplayT *display, double elapsed_time)
+void TestDisplay::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
+  m_elapsed_time = (m_elapsed_time + elapsed_time) % c_cycle_length;
 }
 
 void TestDisplay::draw(DisplayT *display, Coords coords)
@@ -37,8 +37,8 @@ void TestDisplay::draw(DisplayT *display, Coords coords)
   int w = display->getDisplayWidth();
   int h = display->getDisplayHeight();
 
-  int offset = (int) (m_elapsed_time*8) % 8;
-  int brightness = (int) (m_elapsed_time*8) % 16;
+  int offset = unitsInTime(m_elapsed_time, 8) % 8;
+  int brightness = unitsInTime(m_elapsed_time, 8) % 16;
 
   // modes
   switch(m_current_mode % 6) {
@@ -74,7 +74,7 @@ void TestDisplay::draw(DisplayT *display, Coords coords)
       {
         display->setDisplayBrightness(255);
         Coords coords{4,-1};
-        int n = ((int)(m_elapsed_time) % 50) / 5;
+        int n = (unitsInTime(m_elapsed_time, 1) % 50) / 5;
 
         String text(String(n) + String(n) + String(n) + String(n) + String(n));
         display->displayText(text, coords);
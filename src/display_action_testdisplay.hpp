@@ -38,11 +38,13 @@ public:
   {
   }
 
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "test"; }
   void nextMode();
 protected:
   int m_current_mode;
+  static const uint32_t c_cycle_length = 50000000; // us, all patterns repeat within the cycle
 };
 
 }
@@ -22,11 +22,11 @@
 
 namespace Display {
 namespace Action {
-void StaticText::tick(DisplayT *display, double elapsed_time)
+void StaticText::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
+  advance(elapsed_time);
 
-  if (m_duration >= 0 && m_elapsed_time > m_duration)
+  if (m_duration >= 0 && m_elapsed_time > (uint32_t) m_duration)
     setFinished(true);
 }
 
@@ -36,26 +36,38 @@ void StaticText::draw(DisplayT *display, Coords coords)
   display->displayText(m_text, m_coords + coords);
 }
 
+void RotatingText::tick(DisplayT *display, uint32_t elapsed_time)
+{
+  StaticText::tick(display, elapsed_time);
+
+  const int width = display->getTextWidth(m_text);
+  m_scroll_time += elapsed_time;
+  if (width > 0 && m_speed > 0)
+    m_scroll_time %= (uint32_t) width * 1000000 / m_speed; // time to scroll by whole text width
+}
+
 void RotatingText::draw(DisplayT *display, Coords coords)
 {
   int width = display->getTextWidth(m_text);
-  int offset_x = (int)(m_elapsed_time * m_speed) % width;
+  if (width <= 0)
+    return;
+  int offset_x = unitsInTime(m_scroll_time, m_speed) % width;
   Coords offset_center = display->centerTextOffset(m_text);
 
   display->displayText(m_text, m_coords + coords + Coords{-offset_x, offset_center.y});
   display->displayText(m_text, m_coords + coords + Coords{-offset_x + width, offset_center.y});
 }
 
-void RotatingTextOnce::tick(DisplayT *display, double elapsed_time)
+void RotatingTextOnce::tick(DisplayT *display, uint32_t elapsed_time)
 {
-  m_elapsed_time += elapsed_time;
+  advance(elapsed_time);
 }
 
 void RotatingTextOnce::draw(DisplayT *display, Coords coords)
 {
   const int text_length = display->getTextWidth(m_text);
   Coords offset = display->centerTextOffset(m_text);;
-  offset.x = display->getDisplayWidth() - (int)(m_elapsed_time * m_speed);
+  offset.x = display->getDisplayWidth() - unitsInTime(m_elapsed_time, m_speed);
 
   if (offset.x < -text_length) {
     setFinished(true);
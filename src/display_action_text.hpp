@@ -36,8 +36,9 @@ public:
     : ActionT(duration, coords, onfinished_cb), m_text(text)
   {}
 
-  void tick(DisplayT *display, double elapsed_time);
+  void tick(DisplayT *display, uint32_t elapsed_time);
   void draw(DisplayT *display, Coords coords);
+  const char *getName() { return "text"; }
 protected:
   String m_text;
 };
@@ -46,13 +47,16 @@ class RotatingText : public StaticText
 {
 public:
   RotatingText(const String& text, const double duration, const int speed, const Coords& coords = Coords{0,0}, action_callback_t onfinished_cb = nullptr)
-    : StaticText(text, duration, coords, onfinished_cb), m_speed(speed)
+    : StaticText(text, duration, coords, onfinished_cb), m_speed(speed), m_scroll_time(0)
   {}
 
   void draw(DisplayT *display, Coords coords) override;
+  const char *getName() override { return "rotating_text"; }
+  void tick(DisplayT *display, uint32_t elapsed_time) override;
 
 private:
   int m_speed;
+  uint32_t m_scroll_time; // microseconds, wraps around after scrolling whole text
 };
 
 class RotatingTextOnce : public StaticText
@@ -64,7 +68,8 @@ public:
   }
 
   void draw(DisplayT *display, Coords coords) override;
-  void tick(DisplayT *display, double elapsed_time) override;
+  const char *getName() override { return "rotating_text_once"; }
+  void tick(DisplayT *display, uint32_t elapsed_time) override;
 private:
   int m_speed;
 };
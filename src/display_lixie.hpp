@@ -32,6 +32,9 @@ namespace Display {
 class LixieNumeric : public DisplayT
 {
 public:
+  using DisplayT::displayText;
+  using DisplayT::getTextWidth;
+
   LixieNumeric(Lixie* display, const int milis_per_tick, const int num_digits) :
     DisplayT(milis_per_tick), m_display(display), m_num_digits(num_digits)
   {
@@ -39,7 +42,7 @@ public:
     m_display->max_power(5,450); // 5V, 450mA
   }
 
-  void displayText(const String& value, const Coords& coords) {}
+  void displayText(const char *value, const Coords& coords) {}
   void displayNumber(const int number, const int length, const int position, const bool zero_fill);
   void displayBitmap(const unsigned char *bitmap, const Coords& coords, const int w, const int h) {}
   void displayBitmapP(const unsigned char *bitmap, const Coords& coords, const int w, const int h) {}
@@ -52,7 +55,7 @@ public:
 
   void clearBuffer() {}
   void sendBuffer() {}
-  int getTextWidth(const String& text) { return 0; }
+  int getTextWidth(const char *text) { return 0; }
   void setBrightness(const uint8_t brightness);
   void setDrawColor(const uint8_t color) {};
   void setRotation(const bool rotation) {};
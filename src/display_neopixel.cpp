@@ -21,7 +21,7 @@
 #include "display_neopixel.hpp"
 
 namespace Display {
-void Neopixel::displayText(const String& value, const Coords& coords)
+void Neopixel::displayText(const char *value, const Coords& coords)
 {
   for (int i=0;i<m_width*m_height;++i) {
     // m_leds[i].green = i*4;
@@ -39,6 +39,9 @@ namespace Display {
 class Neopixel : public DisplayT
 {
 public:
+  using DisplayT::displayText;
+  using DisplayT::getTextWidth;
+
   Neopixel(const int milis_per_tick, const int width, const int height) :
     DisplayT(milis_per_tick), m_width(width), m_height(height),
     m_leds(new CRGB[width*height])
@@ -52,7 +55,7 @@ public:
     FastLED.addLeds<NEOPIXEL, DataPin>(m_leds, m_width*m_height);
   }
 
-  void displayText(const String& value, const Coords& coords);
+  void displayText(const char *value, const Coords& coords);
   void displayNumber(const int number, const int length, const int position, const bool zero_fill) {}
   void displayBitmap(const unsigned char *bitmap, const Coords& coords, const int w, const int h) {}
   void displayBitmapP(const unsigned char *bitmap, const Coords& coords, const int w, const int h) {}
@@ -65,7 +68,7 @@ public:
 
   void clearBuffer() {}
   void sendBuffer() {}
-  int getTextWidth(const String& text) { return 0; }
+  int getTextWidth(const char *text) { return 0; }
   void setBrightness(const uint8_t brightness);
   void setDrawColor(const uint8_t color) {};
   void setRotation(const bool rotation) {};
@@ -30,11 +30,14 @@ namespace Display {
 class TM1637 : public DisplayT
 {
 public:
+  using DisplayT::displayText;
+  using DisplayT::getTextWidth;
+
   TM1637(TM1637Display* display, const int milis_per_tick, const int num_digits) :
     DisplayT(milis_per_tick), m_display(display), m_num_digits(num_digits)
     {}
 
-  void displayText(const String& value, const Coords& coords) {}
+  void displayText(const char *value, const Coords& coords) {}
   void displayNumber(const int number, const int length, const int position, const bool zero_fill);
   void displayBitmap(const unsigned char *bitmap, const Coords& coords, const int w, const int h) {}
   void displayBitmapP(const unsigned char *bitmap, const Coords& coords, const int w, const int h) {}
@@ -48,7 +51,7 @@ public:
 
   void clearBuffer() {}
   void sendBuffer() {}
-  int getTextWidth(const String& text) { return 0; }
+  int getTextWidth(const char *text) { return 0; }
   void setDrawColor(const uint8_t color) {};
   void setRotation(const bool rotation) {};
   void setBrightness(const uint8_t brightness);
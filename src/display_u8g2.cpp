@@ -19,12 +19,13 @@
 
 #include <Arduino.h>
 #include "display_u8g2.hpp"
+#include "utils.hpp"
 
 namespace Display {
-void U8G2Matrix::displayText(const String& value, const Coords& coords)
+void U8G2Matrix::displayText(const char *value, const Coords& coords)
 {
   useFont();
-  m_display->drawStr(coords.x,coords.y + m_height,value.c_str());
+  m_display->drawStr(coords.x,coords.y + m_height,value);
 }
 
 void U8G2Matrix::displayNumber(const int number, const int length, const int position, const bool zero_fill)
@@ -70,16 +71,90 @@ void U8G2Matrix::drawPixel(const Coords& coords)
 void U8G2Matrix::clearBuffer(void)
 {
   m_display->clearBuffer();
+  m_frame_hash_valid = false;
 }
 
 void U8G2Matrix::sendBuffer(void)
 {
-  m_display->sendBuffer();
+  if (m_send_changed_rows)
+    sendChangedRows();
+  else
+    m_display->sendBuffer();
+  m_sent_frame_hash = m_frame_hash_valid ? m_frame_hash : getFrameHash();
+  m_sent_frame_valid = true;
+  m_frame_hash_valid = false;
+}
+
+bool U8G2Matrix::isFrameChanged(void)
+{
+  m_frame_hash = getFrameHash();
+  m_frame_hash_valid = true;
+  return !m_sent_frame_valid || m_frame_hash != m_sent_frame_hash;
+}
+
+void U8G2Matrix::invalidateFrame(void)
+{
+  m_sent_frame_valid = false;
+  m_sent_rows_valid = false;
+}
+
+/* The modules are daisy chained, every transfer shifts one register write through all of them,
+   so skipping an unchanged module would not make the transfer any shorter. Instead, transfers of
+   pixel rows (digit registers) that didn't change on any module are skipped. */
+void U8G2Matrix::sendChangedRows()
+{
+  u8x8_t *u8x8 = m_display->getU8x8();
+  const uint8_t modules = m_display->getBufferTileWidth();
+  const uint8_t *buffer = m_display->getBufferPtr();
+
+  for (uint8_t row=0;row<8;++row) {
+    const uint8_t *data = buffer + row*modules;
+    uint8_t *sent = m_sent_rows.data() + row*modules;
+    if (m_sent_rows_valid && memcmp(data, sent, modules) == 0)
+      continue;
+
+    u8x8_cad_StartTransfer(u8x8);
+    for (uint8_t module=0;module<modules;++module) {
+      u8x8_cad_SendCmd(u8x8, row+1); // digit register
+      u8x8_cad_SendArg(u8x8, data[module]);
+    }
+    u8x8_cad_EndTransfer(u8x8);
+
+    memcpy(sent, data, modules);
+  }
+  m_sent_rows_valid = true;
+}
+
+/* pixels are dumped in buffer (hardware) orientation, the buffer layout depends on the display:
+   MAX7219 is horizontal (MSB leftmost), the others are vertical (LSB topmost) 8 pixel high tiles */
+void U8G2Matrix::dumpFrame(Print& out)
+{
+  const uint8_t tile_width = m_display->getBufferTileWidth();
+  const uint8_t *buffer = m_display->getBufferPtr();
+  const bool horizontal = m_display->getU8g2()->ll_hvline == u8g2_ll_hvline_horizontal_right_lsb;
+
+  // the visible area, the buffer may be wider
+  out.printf_P(PSTR("P1\n%d %d\n"), m_width, m_height);
+  for (int y=0;y<m_height;++y) {
+    for (int x=0;x<m_width;++x) {
+      const bool pixel = horizontal ?
+        buffer[y*tile_width + x/8] & (0x80 >> (x%8)) :
+        buffer[(y/8)*tile_width*8 + x] & (1 << (y%8));
+      out.write(pixel ? '1' : '0');
+    }
+    out.write('\n');
+  }
+}
+
+uint32_t U8G2Matrix::getFrameHash()
+{
+  const size_t size = 8 * m_display->getBufferTileHeight() * m_display->getBufferTileWidth();
+  return Utils::fnv1a(m_display->getBufferPtr(), size);
 }
 
-int U8G2Matrix::getTextWidth(const String& text)
+int U8G2Matrix::getTextWidth(const char *text)
 {
-  return m_display->getStrWidth(text.c_str());
+  return m_display->getStrWidth(text);
 }
 
 void U8G2Matrix::setBrightness(const uint8_t brightness)
@@ -95,6 +170,7 @@ void U8G2Matrix::setDrawColor(const uint8_t color)
 void U8G2Matrix::setRotation(const bool rotation)
 {
   m_rotation = rotation;
+  invalidateFrame();
 
   if (m_rotation)
     m_display->setDisplayRotation(U8G2_R2);
@@ -30,9 +30,18 @@ namespace Display {
 class U8G2Matrix : public DisplayT
 {
 public:
-  U8G2Matrix(U8G2 *display, const int milis_per_tick, const bool rotation, const int width, const int height) :
-    DisplayT(milis_per_tick), m_display(display), m_rotation(rotation), m_width(width), m_height(height)
+  using DisplayT::displayText;
+  using DisplayT::getTextWidth;
+
+  U8G2Matrix(U8G2 *display, const int milis_per_tick, const bool rotation, const int width, const int height,
+    const bool send_changed_rows=false) :
+    DisplayT(milis_per_tick), m_display(display), m_rotation(rotation), m_width(width), m_height(height),
+    m_sent_frame_hash(0), m_sent_frame_valid(false), m_frame_hash(0), m_frame_hash_valid(false),
+    m_send_changed_rows(send_changed_rows),
+    m_sent_rows_valid(false)
   {
+    if (m_send_changed_rows)
+      m_sent_rows.resize(8 * display->getBufferTileWidth()); // 8 rows, one byte per module
     m_display->begin();
 #if X_DISPLAY_HEIGHT<16
     m_fonts.push_back(u8g2_font_profont10_tr);
@@ -55,7 +64,7 @@ public:
   }
 
   void displayNumber(int number, int length, int position, bool zero_fill);
-  void displayText(const String& value, const Coords& coords);
+  void displayText(const char *value, const Coords& coords);
   void displayBitmap(const unsigned char *bitmap, const Coords& coords, const int w, const int h);
   void displayBitmapP(const unsigned char *bitmap, const Coords& coords, const int w, const int h);
 
@@ -66,7 +75,11 @@ public:
 
   void clearBuffer(void);
   void sendBuffer(void);
-  int getTextWidth(const String& text);
+  bool isFrameChanged(void);
+  void invalidateFrame(void);
+  void dumpFrame(Print& out);
+  uint32_t getFrameHash();
+  int getTextWidth(const char *text);
   int getDisplayWidth(void);
   int getDisplayHeight(void);
   int getCurrentFontHeight(void);
@@ -75,14 +88,25 @@ public:
   void setRotation(const bool rotation);
   bool isNumeric(void) { return false; }
   bool isGraphic(void) { return true; }
+protected:
+  vector<const uint8_t *> m_fonts; // selected by setFont()
 private:
   void useFont();
   Coords correctOffsetForRotation(const Coords& coords);
+  void sendChangedRows();
 
   U8G2* m_display;
   bool m_rotation;
   const int m_width;
   const int m_height;
-  vector<const uint8_t *> m_fonts;
+  uint32_t m_sent_frame_hash;
+  bool m_sent_frame_valid;
+  uint32_t m_frame_hash; // of the buffer, from isFrameChanged() until the next clearBuffer()/sendBuffer()
+  bool m_frame_hash_valid;
+
+  // chained MAX7219 modules, only changed pixel rows are sent
+  const bool m_send_changed_rows;
+  vector<uint8_t> m_sent_rows;
+  bool m_sent_rows_valid;
 };
 }
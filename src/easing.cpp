@@ -0,0 +1,124 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "easing.hpp"
+
+namespace Easing {
+namespace {
+const uint8_t c_table_bits = 6;
+const uint8_t c_table_size = (1 << c_table_bits) + 1;
+
+// sine ease-in
+const uint16_t c_ease_in[c_table_size] PROGMEM = {
+  0, 1, 5, 11, 20, 31, 44, 60, 79, 100, 123, 148, 176,
+  207, 239, 274, 312, 351, 393, 437, 484, 532, 583, 635, 690, 747,
+  806, 867, 930, 994, 1061, 1129, 1200, 1272, 1345, 1421, 1498, 1576, 1656,
+  1737, 1820, 1905, 1990, 2077, 2165, 2254, 2345, 2436, 2529, 2622, 2716, 2811,
+  2907, 3004, 3101, 3199, 3297, 3396, 3495, 3595, 3695, 3795, 3895, 3995, 4096
+};
+
+// sine ease-out
+const uint16_t c_ease_out[c_table_size] PROGMEM = {
+  0, 101, 201, 301, 401, 501, 601, 700, 799, 897, 995, 1092, 1189,
+  1285, 1380, 1474, 1567, 1660, 1751, 1842, 1931, 2019, 2106, 2191, 2276, 2359,
+  2440, 2520, 2598, 2675, 2751, 2824, 2896, 2967, 3035, 3102, 3166, 3229, 3290,
+  3349, 3406, 3461, 3513, 3564, 3612, 3659, 3703, 3745, 3784, 3822, 3857, 3889,
+  3920, 3948, 3973, 3996, 4017, 4036, 4052, 4065, 4076, 4085, 4091, 4095, 4096
+};
+
+// sine ease-in-out
+const uint16_t c_ease_in_out[c_table_size] PROGMEM = {
+  0, 2, 10, 22, 39, 61, 88, 120, 156, 197, 242, 291, 345,
+  403, 465, 531, 600, 673, 749, 828, 910, 995, 1083, 1172, 1264, 1358,
+  1453, 1550, 1648, 1747, 1847, 1948, 2048, 2148, 2249, 2349, 2448, 2546, 2643,
+  2738, 2832, 2924, 3013, 3101, 3186, 3268, 3347, 3423, 3496, 3565, 3631, 3693,
+  3751, 3805, 3854, 3899, 3940, 3976, 4008, 4035, 4057, 4074, 4086, 4094, 4096
+};
+
+// cubic ease-in-out
+const uint16_t c_cubic_in_out[c_table_size] PROGMEM = {
+  0, 0, 0, 2, 4, 8, 14, 21, 32, 46, 62, 83, 108,
+  137, 172, 211, 256, 307, 364, 429, 500, 579, 666, 760, 864, 977,
+  1098, 1230, 1372, 1524, 1688, 1862, 2048, 2234, 2408, 2572, 2724, 2866, 2998,
+  3119, 3232, 3336, 3430, 3517, 3596, 3667, 3732, 3789, 3840, 3885, 3924, 3959,
+  3988, 4013, 4034, 4050, 4064, 4075, 4082, 4088, 4092, 4094, 4096, 4096, 4096
+};
+
+// bounce ease-out
+const uint16_t c_bounce_out[c_table_size] PROGMEM = {
+  0, 8, 30, 68, 121, 189, 272, 371, 484, 613, 756, 915, 1089,
+  1278, 1482, 1702, 1936, 2186, 2450, 2730, 3025, 3335, 3660, 4001, 3972, 3815,
+  3672, 3545, 3433, 3336, 3254, 3188, 3136, 3100, 3078, 3072, 3081, 3105, 3144,
+  3199, 3268, 3353, 3452, 3567, 3697, 3842, 4002, 4058, 3984, 3926, 3882, 3854,
+  3841, 3843, 3860, 3893, 3940, 4003, 4080, 4065, 4041, 4032, 4038, 4060, 4096
+};
+
+const uint16_t *table(const Curve curve)
+{
+  switch (curve) {
+    case Curve::EASE_IN: return c_ease_in;
+    case Curve::EASE_OUT: return c_ease_out;
+    case Curve::EASE_IN_OUT: return c_ease_in_out;
+    case Curve::CUBIC_IN_OUT: return c_cubic_in_out;
+    case Curve::BOUNCE_OUT: return c_bounce_out;
+    case Curve::LINEAR:
+    default:
+      return nullptr;
+  }
+}
+}
+
+uint16_t position(const uint32_t elapsed, const int32_t duration)
+{
+  if (duration <= 0 || elapsed >= (uint32_t) duration)
+    return c_one;
+
+  // drop low bits of long durations, so that elapsed << c_one_bits fits into 32 bits
+  uint8_t shift = 0;
+  while (((uint32_t) duration >> shift) >= (1UL << (31 - c_one_bits)))
+    ++shift;
+
+  return ((elapsed >> shift) << c_one_bits) / ((uint32_t) duration >> shift);
+}
+
+uint16_t value(const Curve curve, const uint16_t position)
+{
+  const uint16_t *curve_table = table(curve);
+  if (position >= c_one)
+    return c_one;
+  if (curve_table == nullptr)
+    return position;
+
+  const uint8_t step_bits = c_one_bits - c_table_bits;
+  const uint8_t index = position >> step_bits;
+  const int32_t fraction = position & ((1 << step_bits) - 1);
+  const int32_t a = pgm_read_word(&curve_table[index]);
+  const int32_t b = pgm_read_word(&curve_table[index+1]);
+  return a + (((b - a) * fraction) >> step_bits);
+}
+
+int scale(const Curve curve, const uint16_t position, const int distance)
+{
+  const int32_t scaled = (int32_t) value(curve, position) * distance;
+  if (scaled >= 0)
+    return (scaled + c_one/2) >> c_one_bits;
+  else
+    return -((-scaled + c_one/2) >> c_one_bits);
+}
+}
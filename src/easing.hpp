@@ -0,0 +1,41 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Easing curves for transitions. Curves are precomputed fixed point tables in PROGMEM
+  (linearly interpolated), positions and values are in 1/c_one units.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+
+namespace Easing {
+enum class Curve : uint8_t { LINEAR, EASE_IN, EASE_OUT, EASE_IN_OUT, CUBIC_IN_OUT, BOUNCE_OUT };
+
+static const uint8_t c_one_bits = 12;
+static const int32_t c_one = 1 << c_one_bits;
+
+// position (0..c_one) of elapsed time within duration, both in the same units
+uint16_t position(const uint32_t elapsed, const int32_t duration);
+// eased value of position, 0..c_one
+uint16_t value(const Curve curve, const uint16_t position);
+// eased position scaled to distance (e.g. display width times direction), rounded
+int scale(const Curve curve, const uint16_t position, const int distance);
+}
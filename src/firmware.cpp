@@ -16,34 +16,132 @@
   with this program; if not, write to the Free Software Foundation, Inc.,
   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
-
 #include "config_common.hpp"
 #include <Arduino.h>
-#include <ESP8266httpUpdate.h>
+#include <ESP8266HTTPClient.h>
+#include <memory>
 #include "firmware.hpp"
+#include "firmware_writer.hpp"
+#include "device_identity.hpp"
+
+String Firmware::getUrl(const String &update_url)
+{
+  return "http://" + update_url + "/esp/update?md5=" + g_identity.getSketchMD5() + "&model=" + String(X_MODEL_NUMBER) + "&version=" + String(FIRMWARE_VERSION);
+}
 
-void Firmware::update(const String &update_url)
+void Firmware::forEachRequestHeader(std::function<void(const String& name, const String& value)> callback)
+{
+  callback(F("x-ESP8266-STA-MAC"), WiFi.macAddress());
+  callback(F("x-ESP8266-AP-MAC"), WiFi.softAPmacAddress());
+  callback(F("x-ESP8266-free-space"), String(ESP.getFreeSketchSpace()));
+  callback(F("x-ESP8266-sketch-size"), String(g_identity.getSketchSize()));
+  callback(F("x-ESP8266-sketch-md5"), g_identity.getSketchMD5());
+  callback(F("x-ESP8266-chip-size"), String(ESP.getFlashChipRealSize()));
+  callback(F("x-ESP8266-sdk-version"), g_identity.getSdkVersion());
+  callback(F("x-ESP8266-mode"), F("sketch"));
+  callback(F("x-ESP8266-version"), FIRMWARE_VERSION);
+}
+
+void Firmware::saveResult(const Result& result)
+{
+  RTCResult saved = { c_result_magic, result.bytes, result.duration_ms, (uint8_t) result.status, result.delta, 0 };
+  ESP.rtcUserMemoryWrite(c_rtc_offset, (uint32_t*) &saved, sizeof(saved));
+}
+
+bool Firmware::takeSavedResult(Result& result)
+{
+  RTCResult saved;
+  if (!ESP.rtcUserMemoryRead(c_rtc_offset, (uint32_t*) &saved, sizeof(saved)) || saved.magic != c_result_magic)
+    return false;
+  result = Result{ (Status) saved.status, saved.bytes, saved.duration_ms, saved.delta != 0 };
+  saved.magic = 0;
+  ESP.rtcUserMemoryWrite(c_rtc_offset, (uint32_t*) &saved, sizeof(saved));
+  return true;
+}
+
+Firmware::Result Firmware::update(const String &update_url, progress_callback_t on_progress)
 {
   if (update_url.length() < 3 || update_url=="") {
     DEBUG_SERIAL.println(F("[Update] Update url empty, skipping"));
-    return;
+    return Result{ Status::NO_UPDATE, 0, 0, false };
   }
 
-  String url = "http://" + update_url + "/esp/update?md5=" + ESP.getSketchMD5() + "&model=" + String(X_MODEL_NUMBER) + "&version=" + String(FIRMWARE_VERSION);
-  //t_httpUpdate_return ret = ESPhttpUpdate.update(url,"","AF B9 78 3B E6 1D 70 AE E7 97 0A 50 D8 7B 1C 89 83 90 32 30");
+  Result result = download(update_url, true, on_progress);
+  if (result.status == Status::FAILED && result.delta) {
+    DEBUG_SERIAL.println(F("[Update] Delta update failed, falling back to full image"));
+    result = download(update_url, false, on_progress);
+  }
+  return result;
+}
+
+Firmware::Result Firmware::download(const String &update_url, const bool allow_delta, progress_callback_t on_progress)
+{
+  Result result = { Status::FAILED, 0, 0, false };
+
+  String url = getUrl(update_url);
   DEBUG_SERIAL.printf_P(PSTR("Update URL: '%s'\n"),url.c_str());
-  t_httpUpdate_return ret = ESPhttpUpdate.update(url);
-
-  switch(ret) {
-    case HTTP_UPDATE_FAILED:
-      DEBUG_SERIAL.println(F("[update] Update failed."));
-      DEBUG_SERIAL.printf_P(PSTR("[update] HTTP_UPDATE_FAILED Error (%d): %s\n"), ESPhttpUpdate.getLastError(), ESPhttpUpdate.getLastErrorString().c_str());
-      break;
-    case HTTP_UPDATE_NO_UPDATES:
-      DEBUG_SERIAL.println(F("[update] Update no Update."));
-      break;
-    case HTTP_UPDATE_OK:
-      DEBUG_SERIAL.println(F("[update] Update ok.")); // may not called we reboot the ESP
-      break;
+
+  HTTPClient http;
+  http.setTimeout(c_timeout_ms);
+  http.begin(url);
+  http.setUserAgent(F("ESP8266-http-Update"));
+  forEachRequestHeader([&http](const String& name, const String& value) { http.addHeader(name, value); });
+  if (allow_delta)
+    http.addHeader(F("x-ESP8266-delta"), F("1")); // server may answer with a patch against the sketch MD5
+  const char *collected_headers[] = { "x-MD5", "x-Delta" };
+  http.collectHeaders(collected_headers, 2);
+
+  const int code = http.GET();
+  if (code == HTTP_CODE_NOT_MODIFIED) {
+    DEBUG_SERIAL.println(F("[Update] No update"));
+    http.end();
+    result.status = Status::NO_UPDATE;
+    return result;
+  }
+  const int size = http.getSize();
+  if (code != HTTP_CODE_OK || size <= 0) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] Unexpected response: %d, size %d\n"), code, size);
+    http.end();
+    return result;
+  }
+
+  result.delta = allow_delta && http.header("x-Delta") == "1";
+  FirmwareWriter writer;
+  if (!writer.begin(size, result.delta ? "" : http.header("x-MD5"), result.delta)) {
+    http.end();
+    return result;
+  }
+
+  // streamed in chunks, the display keeps running from the scheduler's background ticker
+  const uint32_t started_at = millis();
+  uint32_t last_data_at = started_at;
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[c_chunk_size]);
+  WiFiClient *stream = http.getStreamPtr();
+  while (writer.isActive() && !writer.isComplete()) {
+    const size_t available = stream->available();
+    if (available == 0) {
+      if (!stream->connected() || millis() - last_data_at > c_timeout_ms)
+        break;
+      delay(1);
+      continue;
+    }
+
+    const size_t length = stream->read(buffer.get(), std::min(available, (size_t) c_chunk_size));
+    writer.write(buffer.get(), length);
+    last_data_at = millis();
+    if (on_progress)
+      on_progress(writer.getReceived(), size);
   }
+  result.duration_ms = millis() - started_at;
+  result.bytes = writer.getReceived();
+  http.end();
+
+  if (!writer.finish()) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] Update failed after %u of %d bytes\n"), result.bytes, size);
+    return result;
+  }
+
+  DEBUG_SERIAL.printf_P(PSTR("[Update] Updated, %u bytes in %u ms\n"), result.bytes, result.duration_ms);
+  result.status = Status::UPDATED;
+  return result;
 }
@@ -23,8 +23,48 @@
 
 #pragma once
 #include "config_common.hpp"
+#include <Arduino.h>
+#include <functional>
 
 class Firmware {
 public:
-  static void update(const String &update_url);
+  enum class Check : uint8_t { NO_UPDATE, AVAILABLE, FAILED }; // see UpdateCheck
+  enum class Status : uint8_t { UPDATED, NO_UPDATE, FAILED };
+
+  struct Result {
+    Status status;
+    uint32_t bytes; // downloaded
+    uint32_t duration_ms; // of the download
+    bool delta; // a patch against the running sketch was downloaded
+  };
+
+  typedef std::function<void(uint32_t written, uint32_t total)> progress_callback_t;
+
+  /* Downloads the image in chunks and streams it into the update partition, calling on_progress
+     after every chunk (from the main context, so it may run other work). Asks for a delta patch
+     first (see DeltaPatch) and falls back to the full image if applying it fails. Doesn't restart. */
+  static Result update(const String &update_url, progress_callback_t on_progress = nullptr);
+  static String getUrl(const String &update_url);
+  /* keeps the result in RTC memory over the restart that installs the update, so that it
+     can be reported once connected again; takeSavedResult() returns it once */
+  static void saveResult(const Result& result);
+  static bool takeSavedResult(Result& result);
+  // headers the update server expects, as sent by ESPhttpUpdate
+  static void forEachRequestHeader(std::function<void(const String& name, const String& value)> callback);
+private:
+  static Result download(const String &update_url, const bool allow_delta, progress_callback_t on_progress);
+
+  struct RTCResult {
+    uint32_t magic;
+    uint32_t bytes;
+    uint32_t duration_ms;
+    uint8_t status;
+    uint8_t delta;
+    uint16_t reserved;
+  };
+
+  static const uint16_t c_timeout_ms = 10000;
+  static const size_t c_chunk_size = 1024;
+  static const uint32_t c_rtc_offset = 36; // in 4 byte blocks, after UpdateCheck's cache
+  static const uint32_t c_result_magic = 0x52445055; // "UPDR"
 };
@@ -0,0 +1,96 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "firmware_writer.hpp"
+#include <Updater.h>
+#include "utils.hpp"
+
+bool FirmwareWriter::begin(const uint32_t size, const String& md5, const bool delta)
+{
+  if (m_active && size == m_size && md5 == m_md5 && delta == m_delta) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] Resuming at %u of %u bytes\n"), m_received, m_size);
+    return true;
+  }
+
+  abort();
+  m_size = size;
+  m_md5 = md5;
+  m_delta = delta;
+  m_received = 0;
+  m_patch = DeltaPatch();
+  if (!delta) { // a patch starts the update itself, from its header
+    if (!Update.begin(size, U_FLASH)) {
+      DEBUG_SERIAL.printf_P(PSTR("[Update] Can't start update, error %u\n"), Update.getError());
+      return false;
+    }
+    if (md5 != "")
+      Update.setMD5(md5.c_str());
+  }
+  m_active = true;
+  return true;
+}
+
+bool FirmwareWriter::write(const uint8_t *data, const size_t length)
+{
+  if (!m_active || length > m_size - m_received)
+    return false;
+
+  const bool written = m_delta ? m_patch.write(data, length) :
+    Update.write(const_cast<uint8_t*>(data), length) == length;
+  if (!written) {
+    abort();
+    return false;
+  }
+  m_received += length;
+  return true;
+}
+
+FirmwareWriter::Chunk FirmwareWriter::writeChunk(const uint32_t offset, const uint32_t crc, const uint8_t *data, const size_t length)
+{
+  if (!m_active)
+    return Chunk::FAILED;
+  if (offset != m_received)
+    return Chunk::OFFSET_MISMATCH;
+  if (Utils::crc32(data, length) != crc)
+    return Chunk::CRC_ERROR;
+  return write(data, length) ? Chunk::OK : Chunk::FAILED;
+}
+
+bool FirmwareWriter::finish()
+{
+  if (!m_active)
+    return false;
+  m_active = false;
+
+  if (!isComplete() || (m_delta && !m_patch.isFinished())) {
+    Update.end(); // resets the updater
+    return false;
+  }
+  if (!Update.end()) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] Image verification failed, error %u\n"), Update.getError());
+    return false;
+  }
+  return true;
+}
+
+void FirmwareWriter::abort()
+{
+  if (m_active)
+    Update.end(); // incomplete, so only resets the updater
+  m_active = false;
+}
@@ -0,0 +1,61 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*
+  Writes a firmware image or a delta patch (see DeltaPatch) into the update partition, from
+  any transport: the HTTP download, or chunks pushed by the server over the WebSocket. The
+  state is kept until finish() or abort(), so an interrupted transfer can be resumed.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include "delta_patch.hpp"
+
+class FirmwareWriter
+{
+public:
+  enum class Chunk : uint8_t { OK, CRC_ERROR, OFFSET_MISMATCH, FAILED };
+
+  FirmwareWriter() : m_active(false), m_delta(false), m_size(0), m_received(0) {}
+
+  /* Starts writing an image (or patch, if delta) of size bytes, md5 of the resulting image
+     may be empty. Returns true and keeps the received data if the same transfer is already
+     in progress, see getReceived(). */
+  bool begin(const uint32_t size, const String& md5, const bool delta);
+  bool write(const uint8_t *data, const size_t length);
+  // chunk at given offset of the transfer, with CRC32 of its data
+  Chunk writeChunk(const uint32_t offset, const uint32_t crc, const uint8_t *data, const size_t length);
+  // verifies the MD5 and commits the image, to be installed on restart
+  bool finish();
+  void abort();
+
+  bool isActive() { return m_active; }
+  bool isComplete() { return m_received == m_size; }
+  bool isDelta() { return m_delta; }
+  uint32_t getSize() { return m_size; }
+  uint32_t getReceived() { return m_received; }
+  const String& getMD5() { return m_md5; }
+private:
+  bool m_active;
+  bool m_delta;
+  uint32_t m_size; // of the transfer, the patch if delta
+  uint32_t m_received;
+  String m_md5;
+  DeltaPatch m_patch;
+};
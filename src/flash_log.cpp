@@ -0,0 +1,162 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "flash_log.hpp"
+#include "utils.hpp"
+#include <stddef.h>
+
+namespace {
+size_t align4(const size_t length)
+{
+  return (length + 3) & ~3;
+}
+}
+
+bool FlashLog::readHeader(const uint8_t sector, SectorHeader& header)
+{
+  return ESP.flashRead(sectorAddress(sector), (uint32_t*) &header, sizeof(header)) && header.magic == c_magic;
+}
+
+// walks the records of a sector, remembers the last valid one and where the next one goes
+bool FlashLog::findRecord(const uint8_t sector, uint32_t& write_offset)
+{
+  bool found = false;
+  std::vector<uint8_t> data;
+  uint32_t offset = sizeof(SectorHeader);
+
+  while (offset + sizeof(RecordHeader) <= c_sector_size) {
+    RecordHeader header;
+    if (!ESP.flashRead(sectorAddress(sector) + offset, (uint32_t*) &header, sizeof(header)))
+      break;
+    if (header.length == 0xFFFF)
+      break;
+    if (header.marker != c_marker || offset + sizeof(header) + header.length > c_sector_size) {
+      offset = c_sector_size; // garbage, continue in the next sector
+      break;
+    }
+
+    data.resize(align4(header.length));
+    if (ESP.flashRead(sectorAddress(sector) + offset + sizeof(header), (uint32_t*) data.data(), data.size()) &&
+      Utils::fnv1a(data.data(), header.length) == header.checksum) {
+      m_record_address = sectorAddress(sector) + offset + sizeof(header);
+      m_record_length = header.length;
+      found = true;
+    }
+    offset += sizeof(header) + align4(header.length);
+  }
+
+  write_offset = offset;
+  return found;
+}
+
+bool FlashLog::open()
+{
+  m_sector = c_no_sector;
+  m_record_address = 0;
+  m_record_length = 0;
+
+  for (uint8_t sector=0;sector<m_sectors;++sector) {
+    SectorHeader header;
+    if (readHeader(sector, header) && (m_sector == c_no_sector || header.sequence > m_sequence)) {
+      m_sector = sector;
+      m_sequence = header.sequence;
+    }
+  }
+  if (m_sector == c_no_sector)
+    return false;
+
+  if (findRecord(m_sector, m_write_offset))
+    return true;
+
+  // newest sector has no complete record yet (power loss right after moving on), use the previous one
+  const uint8_t previous = (m_sector + m_sectors - 1) % m_sectors;
+  SectorHeader header;
+  uint32_t unused;
+  return readHeader(previous, header) && header.sequence == m_sequence - 1 && findRecord(previous, unused);
+}
+
+bool FlashLog::read(std::vector<uint8_t>& data)
+{
+  if (m_record_address == 0)
+    return false;
+
+  data.resize(align4(m_record_length));
+  if (!ESP.flashRead(m_record_address, (uint32_t*) data.data(), data.size()))
+    return false;
+  data.resize(m_record_length);
+  return true;
+}
+
+bool FlashLog::startSector(const uint8_t sector, const uint32_t sequence)
+{
+  if (!ESP.flashEraseSector(m_first_sector + sector))
+    return false;
+  ++m_erases;
+
+  // the magic goes last, a header cut short by a power loss must not look valid
+  uint32_t word = sequence;
+  if (!ESP.flashWrite(sectorAddress(sector) + offsetof(SectorHeader, sequence), &word, sizeof(word)))
+    return false;
+  word = c_magic;
+  if (!ESP.flashWrite(sectorAddress(sector) + offsetof(SectorHeader, magic), &word, sizeof(word)))
+    return false;
+
+  m_sector = sector;
+  m_sequence = sequence;
+  m_write_offset = sizeof(SectorHeader);
+  return true;
+}
+
+bool FlashLog::append(const uint8_t *data, const size_t length)
+{
+  if (m_sectors == 0 || length > c_max_record_length)
+    return false;
+
+  const size_t record_size = sizeof(RecordHeader) + align4(length);
+  if (m_sector == c_no_sector) {
+    if (!startSector(0, 1))
+      return false;
+  } else if (m_write_offset + record_size > c_sector_size) {
+    if (!startSector((m_sector + 1) % m_sectors, m_sequence + 1))
+      return false;
+  }
+
+  std::vector<uint8_t> record(record_size, 0xFF);
+  RecordHeader header = { (uint16_t) length, c_marker, Utils::fnv1a(data, length) };
+  memcpy(record.data(), &header, sizeof(header));
+  memcpy(record.data() + sizeof(header), data, length);
+
+  const uint32_t address = sectorAddress(m_sector) + m_write_offset;
+  m_write_offset += record_size;
+  if (!ESP.flashWrite(address, (uint32_t*) record.data(), record.size()))
+    return false;
+
+  m_record_address = address + sizeof(header);
+  m_record_length = length;
+  return true;
+}
+
+void FlashLog::erase()
+{
+  for (uint8_t sector=0;sector<m_sectors;++sector)
+    ESP.flashEraseSector(m_first_sector + sector);
+  m_sector = c_no_sector;
+  m_record_address = 0;
+  m_record_length = 0;
+}
@@ -0,0 +1,81 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Append-only record log in raw flash, rotating over several sectors to spread erase wear.
+  Each sector starts with a header holding a sequence number, records are appended after it
+  and the newest record with a valid checksum wins. A sector is only erased when the log moves
+  on to it, so the previous record survives a power loss during the write.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <vector>
+
+class FlashLog
+{
+public:
+  FlashLog(const uint32_t first_sector, const uint8_t sectors)
+    : m_first_sector(first_sector), m_sectors(sectors), m_sector(c_no_sector), m_sequence(0),
+    m_write_offset(0), m_record_address(0), m_record_length(0), m_erases(0)
+  {}
+
+  bool isAvailable() { return m_sectors > 0; }
+  // finds the newest record, returns false if the log holds none
+  bool open();
+  // reads the newest record found by open() or written by append()
+  bool read(std::vector<uint8_t>& data);
+  bool append(const uint8_t *data, const size_t length);
+  void erase();
+
+  uint32_t getErases() { return m_erases; }
+  uint8_t getSector() { return m_sector; }
+
+  static const uint32_t c_sector_size = 4096;
+  static const size_t c_max_record_length = 2048;
+private:
+  struct SectorHeader {
+    uint32_t magic;
+    uint32_t sequence;
+  };
+  struct RecordHeader {
+    uint16_t length; // 0xFFFF = erased flash, end of the sector's records
+    uint16_t marker;
+    uint32_t checksum; // of the data
+  };
+
+  uint32_t sectorAddress(const uint8_t sector) { return (m_first_sector + sector) * c_sector_size; }
+  bool readHeader(const uint8_t sector, SectorHeader& header);
+  bool findRecord(const uint8_t sector, uint32_t& write_offset);
+  bool startSector(const uint8_t sector, const uint32_t sequence);
+
+  const uint32_t m_first_sector;
+  const uint8_t m_sectors;
+  uint8_t m_sector; // current sector, c_no_sector if the log is empty
+  uint32_t m_sequence;
+  uint32_t m_write_offset;
+  uint32_t m_record_address; // newest valid record, 0 if none
+  uint16_t m_record_length;
+  uint32_t m_erases;
+
+  static const uint8_t c_no_sector = 0xFF;
+  static const uint32_t c_magic = 0x474F4C43; // "CLOG"
+  static const uint16_t c_marker = 0xC10C;
+};
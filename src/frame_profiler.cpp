@@ -0,0 +1,125 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "frame_profiler.hpp"
+
+#if defined(X_DISPLAY_PROFILER)
+namespace Display {
+namespace {
+uint8_t bucketOf(const uint32_t duration_us)
+{
+  uint8_t bucket = 0;
+  while (bucket < FrameProfiler::c_histogram_size-1 && (duration_us >> (FrameProfiler::c_first_bucket_bits + bucket)) != 0)
+    ++bucket;
+  return bucket;
+}
+
+const char c_phase_names[][8] PROGMEM = { "tick", "draw", "send", "frame" };
+}
+
+void FrameProfiler::Stats::add(const uint32_t duration_us)
+{
+  if (count == 0 || duration_us < min_us) min_us = duration_us;
+  if (duration_us > max_us) max_us = duration_us;
+  ++count;
+  total_us += duration_us;
+
+  uint16_t &bucket = histogram[bucketOf(duration_us)];
+  if (bucket == UINT16_MAX) { // halve the whole histogram, keeps the distribution
+    for (auto &value : histogram)
+      value /= 2;
+  }
+  ++bucket;
+}
+
+uint32_t FrameProfiler::Stats::percentile(const uint8_t percent) const
+{
+  uint32_t samples = 0;
+  for (const auto value : histogram)
+    samples += value;
+
+  if (samples == 0)
+    return 0;
+
+  const uint32_t wanted = (samples * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i=0;i<c_histogram_size-1;++i) {
+    seen += histogram[i];
+    if (seen >= wanted)
+      return std::min(1UL << (c_first_bucket_bits + i), (unsigned long) max_us);
+  }
+  return max_us;
+}
+
+void FrameProfiler::reset()
+{
+  memset(m_phases, 0, sizeof(m_phases));
+  memset(m_actions, 0, sizeof(m_actions));
+  m_overruns = 0;
+}
+
+void FrameProfiler::addAction(const char *action_name, const Phase phase, const uint32_t duration_us)
+{
+  if (m_paused)
+    return;
+  for (auto &action : m_actions) {
+    if (action.name != nullptr && action.name != action_name && strcmp(action.name, action_name) != 0)
+      continue;
+
+    action.name = action_name; // claims a free slot, types beyond c_max_actions are not tracked
+    (phase == PHASE_TICK ? action.tick : action.draw).add(duration_us);
+    return;
+  }
+}
+
+void FrameProfiler::addFrame(const uint32_t duration_us, const uint32_t budget_us)
+{
+  if (m_paused)
+    return;
+  addPhase(PHASE_FRAME, duration_us);
+  if (duration_us > budget_us)
+    ++m_overruns;
+}
+
+void FrameProfiler::report(std::function<void(const char *line)> callback)
+{
+  char line[112];
+  auto format = [&](const char *prefix, const char *name, const Stats &stats) {
+    snprintf_P(line, sizeof(line), PSTR("%s%s n=%u min=%u avg=%u max=%u p50=%u p90=%u p99=%u"),
+      prefix, name, stats.count, stats.min_us, stats.average(), stats.max_us,
+      stats.percentile(50), stats.percentile(90), stats.percentile(99));
+    callback(line);
+  };
+
+  char name[8];
+  for (uint8_t i=0;i<PHASE_COUNT;++i) {
+    strcpy_P(name, c_phase_names[i]);
+    format("", name, m_phases[i]);
+  }
+  for (const auto &action : m_actions) {
+    if (action.name == nullptr)
+      break;
+    format("tick ", action.name, action.tick);
+    format("draw ", action.name, action.draw);
+  }
+  snprintf_P(line, sizeof(line), PSTR("overruns=%u"), m_overruns);
+  callback(line);
+}
+}
+#endif
@@ -0,0 +1,78 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Frame time profiler for the display pipeline, keeps min/avg/max and a log2 histogram
+  (for percentiles) of each phase of DisplayT::tick() and of tick/draw per action type.
+  Only compiled in with X_DISPLAY_PROFILER defined (see config_common.hpp).
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <functional>
+
+#if defined(X_DISPLAY_PROFILER)
+namespace Display {
+class FrameProfiler
+{
+public:
+  enum Phase : uint8_t { PHASE_TICK = 0, PHASE_DRAW, PHASE_SEND, PHASE_FRAME, PHASE_COUNT };
+  static const uint8_t c_histogram_size = 12;
+  static const uint8_t c_first_bucket_bits = 7; // first bucket is below 128us
+
+  struct Stats {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint16_t histogram[c_histogram_size]; // bucket i counts durations below 2^(i+7) us, last one everything above
+
+    void add(const uint32_t duration_us);
+    uint32_t average() const { return count ? total_us / count : 0; }
+    uint32_t percentile(const uint8_t percent) const; // upper bound of the bucket (or max), in us
+  };
+
+  FrameProfiler() : m_paused(false) { reset(); }
+
+  void reset();
+  void setPaused(const bool paused) { m_paused = paused; } // e.g. for synthetic frames of a benchmark
+  void addPhase(const Phase phase, const uint32_t duration_us) { if (!m_paused) m_phases[phase].add(duration_us); }
+  void addAction(const char *action_name, const Phase phase, const uint32_t duration_us);
+  void addFrame(const uint32_t duration_us, const uint32_t budget_us);
+
+  uint32_t getOverruns() { return m_overruns; }
+  // one line per phase and action, e.g. "draw n=100 min=120 avg=180 max=900 p50=256 p90=512 p99=1024"
+  void report(std::function<void(const char *line)> callback);
+
+  static const uint8_t c_max_actions = 8;
+private:
+  struct ActionStats {
+    const char *name;
+    Stats tick;
+    Stats draw;
+  };
+
+  Stats m_phases[PHASE_COUNT];
+  ActionStats m_actions[c_max_actions];
+  uint32_t m_overruns; // frames longer than the display tick period
+  bool m_paused;
+};
+}
+#endif
@@ -110,7 +110,7 @@ int8_t getFilteredDisplayRotation()//const string& user_setting)
 {
   static int filtered_rotation = 0;
 
-  switch (g_parameters["rotate_display"].toInt()) {
+  switch (g_parameters.getInt(ParameterId::ROTATE_DISPLAY)) {
     case 0: return 0;
     case 1: return 1;
     case 2: break; // auto
@@ -0,0 +1,60 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "heap_telemetry.hpp"
+#include "scheduler.hpp"
+
+extern "C" {
+#include <umm_malloc/umm_malloc.h>
+}
+
+namespace {
+const uint32_t c_heap_block_size = 8; // umm_malloc block
+}
+
+void HeapTelemetry::sample()
+{
+  m_free = ESP.getFreeHeap();
+  umm_info(nullptr, 0); // walks the heap with interrupts off, fills ummHeapInfo
+  m_largest_block = ummHeapInfo.maxFreeContiguousBlocks * c_heap_block_size;
+  m_fragmentation = (m_free > 0 && m_largest_block < m_free) ? 100 - m_largest_block * 100 / m_free : 0;
+
+  m_min_free = std::min(m_min_free, m_free);
+  m_min_largest_block = std::min(m_min_largest_block, m_largest_block);
+  m_max_fragmentation = std::max(m_max_fragmentation, m_fragmentation);
+  ++m_samples;
+}
+
+void HeapTelemetry::report(std::function<void(const String& line)> callback)
+{
+  if (m_samples == 0)
+    sample();
+
+  callback("heap free=" + String(m_free) + " max_block=" + String(m_largest_block) +
+    " frag=" + String(m_fragmentation) + " min_free=" + String(m_min_free) +
+    " min_block=" + String(m_min_largest_block) + " max_frag=" + String(m_max_fragmentation));
+
+  // name:allocations/net heap change in bytes, per task
+  String tasks = "heap_tasks";
+  for (Scheduler::task_id_t id=0;id<g_scheduler.getTaskCount();++id) {
+    const auto& task = g_scheduler.getTask(id);
+    tasks += " " + String(task.name) + ":" + String(task.allocations) + "/" + String(task.heap_change);
+  }
+  callback(tasks);
+}
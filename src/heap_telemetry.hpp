@@ -0,0 +1,56 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Heap telemetry. Samples free heap, largest free block and fragmentation on a schedule,
+  keeps low-water marks since boot and formats them as compact ;DIAG reports.
+  Allocations are attributed to scheduler tasks by the Scheduler itself.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <functional>
+
+class HeapTelemetry
+{
+public:
+  HeapTelemetry()
+    : m_free(0), m_largest_block(0), m_fragmentation(0),
+    m_min_free(UINT32_MAX), m_min_largest_block(UINT32_MAX), m_max_fragmentation(0), m_samples(0)
+  {}
+
+  void sample();
+  // ";DIAG heap ..." and ";DIAG heap_tasks ..." lines, without the ";DIAG " prefix
+  void report(std::function<void(const String& line)> callback);
+
+  uint32_t getFree() { return m_free; }
+  uint32_t getLargestBlock() { return m_largest_block; }
+  uint8_t getFragmentation() { return m_fragmentation; }
+private:
+  uint32_t m_free;
+  uint32_t m_largest_block;
+  uint8_t m_fragmentation; // % of free heap not in the largest block
+  uint32_t m_min_free;
+  uint32_t m_min_largest_block;
+  uint8_t m_max_fragmentation;
+  uint32_t m_samples;
+};
+
+extern HeapTelemetry g_heap_telemetry;
@@ -39,12 +39,15 @@
 #include "display_action_testdisplay.hpp"
 #include "display_action_menu.hpp"
 #include "display_action_multi.hpp"
+#include "display_action_progress.hpp"
 using Display::Coords;
 using Display::Action::ActionPtr_t;
 
 #include "config.hpp"
+#include "parameter_schema.hpp"
 
 #include "firmware.hpp"
+#include "update_check.hpp"
 #include "wifi.hpp"
 #include "utils.hpp"
 #include "button.hpp"
@@ -52,6 +55,11 @@ using Display::Action::ActionPtr_t;
 #include "data_source.hpp"
 #include "bitmaps.hpp"
 #include "gyro.hpp"
+#include "scheduler.hpp"
+#include "heap_telemetry.hpp"
+#include "boot_profiler.hpp"
+#include "device_identity.hpp"
+#include "benchmark.hpp"
 
 #include <EEPROM.h>
 
@@ -60,18 +68,39 @@ using Display::Action::ActionPtr_t;
 #include <Time.h>
 #include <NtpClientLib.h>
 
-#include <Ticker.h>
-
 #include <ESP8266TrueRandom.h>
 
 
 ParameterStore g_parameters;
 
-Ticker g_ticker_clock;
+Scheduler g_scheduler;
+Scheduler::task_id_t g_clock_task = Scheduler::c_invalid_task;
+HeapTelemetry g_heap_telemetry;
+BootProfiler g_boot_profiler;
+UpdateCheck g_update_check;
+DeviceIdentity g_identity;
+Scheduler::task_id_t g_telemetry_task = Scheduler::c_invalid_task;
+Scheduler::task_id_t g_update_check_task = Scheduler::c_invalid_task;
+Scheduler::task_id_t g_update_task = Scheduler::c_invalid_task; // one-shot, for ;UPDATE
+Scheduler::task_id_t g_benchmark_task = Scheduler::c_invalid_task; // feeds ;BENCHMARK a slice at a time
 
 DisplayT *g_display = nullptr;
 shared_ptr<Display::PriceAction> g_price_action;
 shared_ptr<Display::Action::Clock> g_clock_action;
+
+// ;BENCHMARK in progress, it renders the frames itself meanwhile
+struct BenchmarkRun {
+  BenchmarkRun(const TextView& scenario_name, const Benchmark::Scenario scenario, const uint16_t messages) :
+    name(scenario_name.toString()), saved_price(*g_price_action), run(scenario, messages, g_display, g_price_action.get())
+  {}
+
+  const String name;
+  Display::PriceAction saved_price; // restored afterwards, real prices received meanwhile go here
+  Benchmark::Run run;
+};
+std::unique_ptr<BenchmarkRun> g_benchmark;
+const uint16_t c_benchmark_slice_frames = 8;
+
 WiFiCore *g_wifi = nullptr;
 DataSource *g_data_source = nullptr;
 
@@ -85,6 +114,14 @@ bool g_reset_price_on_next_tick = false;
 enum class MODE { TICKER, MENU, ANNOUNCEMENT, OTP, AP, UPDATE};
 MODE g_current_mode(MODE::TICKER);
 
+/* Once WiFi is up, the data source and NTP start right away, the update check waits for the
+   first price (or c_update_check_delay_ms), so that it never delays the ticker at boot. */
+uint32_t g_wifi_connected_at = 0; // millis()
+const uint32_t c_update_check_delay_ms = 20000;
+const uint32_t c_update_report_time_ms = 500;
+shared_ptr<Display::Action::Progress> g_firmware_progress;
+bool g_update_failed = false; // not retried until the next boot, the download would most likely fail again
+
 shared_ptr<Menu> g_menu = nullptr;
 
 // FIXME: class
@@ -98,7 +135,7 @@ void clock_callback()
   if (g_current_mode != MODE::TICKER)
     return;
 
-  if (g_parameters["clock_mode"].toInt() == 0) // Off
+  if (g_parameters.getInt(ParameterId::CLOCK_MODE) == 0) // Off
     return;
 
   if (g_clock_action->isAlwaysOn()) {
@@ -196,7 +233,12 @@ void setupDisplay()
     X_DISPLAY_MILIS_PER_TICK,
     false,
     X_DISPLAY_WIDTH,
-    X_DISPLAY_HEIGHT
+    X_DISPLAY_HEIGHT,
+#if defined(X_DISPLAY_MAX7219)
+    true
+#else
+    false
+#endif
   );
 #elif defined(X_DISPLAY_TM1637)
   g_display = new Display::TM1637(&g_display_hw, X_DISPLAY_MILIS_PER_TICK, X_DISPLAY_WIDTH);
@@ -210,44 +252,61 @@ void setupDisplay()
 #else
   #error error
 #endif
-  g_display->setupTickCallback([&]() { 
-    g_display->tick(); 
+  g_scheduler.addTask("display", X_DISPLAY_MILIS_PER_TICK, []() {
+    if (g_benchmark)
+      return;
+    g_display->tick();
+    // boot stage of the first price on the display, rather than of the first one received
+    if (!g_boot_profiler.isReached(BootProfiler::Stage::FIRST_PRICE) && g_price_action->isPriceDrawn()) {
+      g_boot_profiler.mark(BootProfiler::Stage::FIRST_PRICE);
+      g_data_source->sendBootProfile();
+    }
+  }, Scheduler::PRIORITY_NORMAL, true);
+  g_scheduler.addTask("capture", X_DISPLAY_MILIS_PER_TICK, []() { g_display->dumpCapturedFrame(); }, Scheduler::PRIORITY_LOW);
 #ifdef HAS_GYROSCOPE
-    MPUtick(); 
+  g_scheduler.addTask("gyro", X_DISPLAY_MILIS_PER_TICK, MPUtick, Scheduler::PRIORITY_LOW, true);
+#endif
+#if defined(X_DISPLAY_PROFILER)
+  g_scheduler.addTask("profiler", 60000, []() {
+    g_display->getProfiler().report([](const char *line) { DEBUG_SERIAL.printf_P(PSTR("[Display] %s\n"), line); });
+  }, Scheduler::PRIORITY_LOW);
 #endif
-  }); // can't be moved to class declaration because of lambda capture
 }
 
 void setupClock()
 {
 #if !defined(X_CLOCK_ONLY_DISPLAY)
   g_clock_action = make_shared<Display::Action::Clock>(3.0, Coords{0,0}); // display clock for 3 secs
-  g_ticker_clock.attach(30.0, clock_callback);
+  g_clock_task = g_scheduler.addTask("clock", 30000, clock_callback);
 #endif
 }
 
+void setupTelemetry()
+{
+  g_scheduler.addTask("heap", 1000, []() { g_heap_telemetry.sample(); }, Scheduler::PRIORITY_LOW);
+  g_telemetry_task = g_scheduler.addTask("telemetry", 300000, []() {
+    if (g_data_source && g_data_source->isConnected())
+      g_heap_telemetry.report([](const String& line) { g_data_source->queueText(";DIAG " + line); });
+  }, Scheduler::PRIORITY_LOW);
+}
+
 void setupParameters()
 {
-  g_parameters.addItem({"__LEGACY_ticker_server_host","","", 0, nullptr});
-  g_parameters.addItem({"__LEGACY_ticker_server_port","","", 0, nullptr});
-  g_parameters.addItem({"__LEGACY_ticker_path","","", 0, nullptr});
-  g_parameters.addItem({"__LEGACY_currency_pair","","", 0, nullptr});
-  g_parameters.addItem({"__device_uuid","","", 0, nullptr}); // new uuid will be generated on every device wipe
-  g_parameters.addItem({"update_url","Update server","update.cryptoclock.net", 50, nullptr});
-  g_parameters.addItem({"ticker_url","Ticker server","wss://ticker.cryptoclock.net:443/", 100, [](ParameterItem& item, bool init, bool final_change)
+  const uint32_t free_heap = ESP.getFreeHeap();
+  g_parameters.begin(c_parameter_schema);
+
+  g_parameters.setCallback(ParameterId::TICKER_URL, [](ParameterItem& item, bool init, bool final_change)
   {
     if (init==false) {
       g_data_source->reconnect();
       g_price_action->reset();
       g_announcement = " ";
     }
-  }});
-  g_parameters.addItem({"brightness","Brightness (1-5)","3", 5, [](ParameterItem& item, bool init, bool final_change)
+  });
+  g_parameters.setCallback(ParameterId::BRIGHTNESS, [](ParameterItem& item, bool init, bool final_change)
   {
-    int brightness = std::min(std::max(item.value.toInt(),1L),5L); // sanitize
-    item.value = String(brightness);
     int actual_brightness = 0;
-    switch (brightness) {
+    switch (item.int_value) {
       case 1: actual_brightness = 0; break;
       case 2: actual_brightness = 16; break;
       case 3: actual_brightness = 32; break;
@@ -255,78 +314,77 @@ void setupParameters()
       case 5: default: actual_brightness = 128; break;
     }
     g_display->setDisplayBrightness(actual_brightness);
-  }});
-  g_parameters.addItem({"font","Font (0-2)","0", 5, [](ParameterItem& item, bool init, bool final_change)
+  });
+  g_parameters.setCallback(ParameterId::FONT, [](ParameterItem& item, bool init, bool final_change)
   {
-    int font = std::min(std::max(item.value.toInt(),0L),2L);
-    item.value = String(font);
-    g_display->setFont(font);
-  }});
-
-  g_parameters.addItem({"rotate_display",
-#ifdef HAS_GYROSCOPE
-    "Rotate Display (0,1, 2=auto)",
-#else
-    "Rotate Display (0,1)",
-#endif
-  "0", 5, [](ParameterItem& item, bool init, bool final_change)
+    g_display->setFont(item.int_value);
+  });
+  g_parameters.setCallback(ParameterId::ROTATE_DISPLAY, [](ParameterItem& item, bool init, bool final_change)
   {
-    int rotate = std::min(std::max(item.value.toInt(),0L),2L);
-    item.value = String(rotate);
-    if (rotate==0 || rotate==1)
-      g_display->setRotation(rotate);
-  }});
-  g_parameters.addItem({"clock_mode","Show Clock (0-2)","1", 5, [](ParameterItem& item, bool init, bool final_change)
+    if (item.int_value==0 || item.int_value==1)
+      g_display->setRotation(item.int_value);
+  });
+  g_parameters.setCallback(ParameterId::CLOCK_MODE, [](ParameterItem& item, bool init, bool final_change)
   {
-    int clock_mode = std::min(std::max(item.value.toInt(),0L),2L);
-    item.value = String(clock_mode);
-    if (clock_mode == 2)
+    if (item.int_value == 2)
       g_clock_action->setAlwaysOn(true);
     else
       g_clock_action->setAlwaysOn(false);
 //    g_clock_mode
-  }});
-  g_parameters.addItem({"clock_interval","Clock display interval (secs)","30", 5, [](ParameterItem& item, bool init, bool final_change)
+  });
+  g_parameters.setCallback(ParameterId::CLOCK_INTERVAL, [](ParameterItem& item, bool init, bool final_change)
+  {
+    if (init || final_change)
+      g_scheduler.setPeriod(g_clock_task, item.int_value * 1000);
+  });
+  g_parameters.setCallback(ParameterId::TELEMETRY_INTERVAL, [](ParameterItem& item, bool init, bool final_change)
   {
     if (init || final_change) {
-      int interval = std::max(item.value.toInt(),5L);
+      const int32_t interval = item.int_value > 0 ? std::max<int32_t>(item.int_value, 10) : 0;
+      item.int_value = interval;
       item.value = String(interval);
-      g_ticker_clock.attach(interval, clock_callback);
+      g_scheduler.setEnabled(g_telemetry_task, interval > 0);
+      if (interval > 0)
+        g_scheduler.setPeriod(g_telemetry_task, interval * 1000);
     }
-  }});
-  g_parameters.addItem({"timezone","Timezone (-11..+13)","1", 5, [](ParameterItem& item, bool init, bool final_change)
+  });
+  g_parameters.setCallback(ParameterId::TIMEZONE, [](ParameterItem& item, bool init, bool final_change)
   {
     if (final_change) {
-      int timezone = std::min(std::max(item.value.toInt(),-11L),13L);
-      item.value = String(timezone);
       NTP.stop();
-      NTP.begin(NTP_SERVER, timezone, true);
+      NTP.begin(NTP_SERVER, item.int_value, true);
     }
-  }});
+  });
+
+  DEBUG_SERIAL.printf_P(PSTR("[Parameters] %u parameters, %u bytes of heap used\n"),
+    g_parameters.size(), free_heap - ESP.getFreeHeap());
 }
 
 void loadParameters()
 {
   Utils::eeprom_BEGIN();
-  g_parameters.loadFromEEPROMwithoutInit();
+  g_parameters.load();
+  g_scheduler.addTask("params", 500, []() { g_parameters.loop(); }, Scheduler::PRIORITY_LOW); // writes coalesced changes
   g_wifi = new WiFiCore(g_display);
 
   // no uuid set, generate new one
-  if (g_parameters["__device_uuid"] == "") {
+  if (g_parameters.getString(ParameterId::DEVICE_UUID) == "") {
     uint8_t uuid[16];
     ESP8266TrueRandom.uuid(uuid);
     const String uuid_str = ESP8266TrueRandom.uuidToString(uuid);
-    g_parameters.setValue("__device_uuid", uuid_str);
-    g_parameters.storeToEEPROMwithoutInit();
+    g_parameters.setValue(ParameterId::DEVICE_UUID, uuid_str);
   }
 
   // handle legacy parameters
-  if (g_parameters["__LEGACY_ticker_server_host"]!="")
+  if (g_parameters.getString(ParameterId::LEGACY_TICKER_SERVER_HOST)!="")
   {
-    g_parameters.setValue("ticker_url", "wss://" + g_parameters["__LEGACY_ticker_server_host"] + ":" +
-      g_parameters["__LEGACY_ticker_server_port"] + g_parameters["__LEGACY_ticker_path"] + g_parameters["__LEGACY_currency_pair"]);
+    g_parameters.setValue(ParameterId::TICKER_URL, "wss://" + g_parameters.getString(ParameterId::LEGACY_TICKER_SERVER_HOST) + ":" +
+      g_parameters.getString(ParameterId::LEGACY_TICKER_SERVER_PORT) + g_parameters.getString(ParameterId::LEGACY_TICKER_PATH) +
+      g_parameters.getString(ParameterId::LEGACY_CURRENCY_PAIR));
   }
   Utils::eeprom_END();
+
+  g_parameters.store(); // new uuid or migrated configuration, skipped if unchanged
 }
 
 void setupHW()
@@ -340,46 +398,126 @@ void setupHW()
 #endif
 }
 
+void forceSetTickerMode();
+
+String formatUpdateResult(const Firmware::Result& result)
+{
+  const uint32_t kbps = result.duration_ms > 0 ? (uint64_t) result.bytes * 8 / result.duration_ms : 0;
+  return ";DIAG update status=" + String((int) result.status) + " bytes=" + String(result.bytes) +
+    " ms=" + String(result.duration_ms) + " kbps=" + String(kbps) + " delta=" + String(result.delta);
+}
+
+// restarts only if the new firmware was installed, otherwise returns to the ticker
+void updateFirmware()
+{
+  if (g_current_mode == MODE::UPDATE || g_data_source->isReceivingFirmware())
+    return; // ;UPDATE received while downloading, or firmware is being pushed over the websocket
+  if (g_update_failed) {
+    DEBUG_SERIAL.println(F("[Update] Update failed earlier, skipped until restart"));
+    return;
+  }
+
+  auto progress = make_shared<Display::Action::Progress>("UPD ");
+  g_display->prependAction(progress);
+  g_current_mode = MODE::UPDATE;
+
+  /* the connection to the server is closed while downloading, it isn't serviced (only the display
+     is, from the background ticker) and its TLS buffers are better used by the download */
+  g_data_source->disconnect();
+  const auto result = Firmware::update(g_parameters.getString(ParameterId::UPDATE_URL),
+    [&progress](uint32_t written, uint32_t total) { progress->setProgress(written, total); });
+
+  if (result.status == Firmware::Status::UPDATED) {
+    Firmware::saveResult(result); // reported after the restart
+    g_parameters.flush();
+    ESP.restart();
+  }
+
+  g_data_source->queueText(formatUpdateResult(result));
+  g_data_source->reconnect();
+  g_update_failed = (result.status == Firmware::Status::FAILED);
+  forceSetTickerMode();
+}
+
+void setupUpdateCheck()
+{
+  Firmware::Result installed;
+  if (Firmware::takeSavedResult(installed))
+    g_data_source->queueText(formatUpdateResult(installed));
+
+  // requested by the server, run from here rather than from within the websocket event
+  g_update_task = g_scheduler.addTask("update_request", 10, []() {
+    g_scheduler.setEnabled(g_update_task, false);
+    updateFirmware();
+  }, Scheduler::PRIORITY_LOW);
+  g_scheduler.setEnabled(g_update_task, false);
+
+  g_update_check_task = g_scheduler.addTask("update", 100, []() {
+    if (g_update_check.getState() == UpdateCheck::State::IDLE) {
+      if (!g_boot_profiler.isReached(BootProfiler::Stage::FIRST_PRICE) && millis() - g_wifi_connected_at < c_update_check_delay_ms)
+        return;
+      if (g_current_mode != MODE::TICKER)
+        return; // retried on the next run
+      g_update_check.start(g_parameters.getString(ParameterId::UPDATE_URL));
+    }
+    if (!g_update_check.loop())
+      return;
+
+    g_scheduler.setEnabled(g_update_check_task, false);
+    g_boot_profiler.mark(BootProfiler::Stage::UPDATE_CHECKED);
+    g_data_source->sendBootProfile();
+    g_data_source->queueText(";DIAG update_check result=" + String((int) g_update_check.getResult()) +
+      " cached=" + String(g_update_check.isCached()) + " ms=" + String(g_update_check.getDuration()));
+    if (g_update_check.getResult() == Firmware::Check::AVAILABLE) {
+      DEBUG_SERIAL.println(F("[Update] Update available, updating"));
+      updateFirmware();
+    }
+  }, Scheduler::PRIORITY_LOW);
+}
+
 void setupDataSource()
 {
   g_data_source = new DataSource;
 
   g_data_source->setOnUpdateRequest([&]() {
     DEBUG_SERIAL.println(F("Update request received, updating"));
-    g_display->prependAction(make_shared<Display::Action::RotatingText>("UPDATING... ", -1, 20));
-    g_current_mode = MODE::UPDATE;
-    Firmware::update(g_parameters["update_url"]);
-    g_current_mode = MODE::TICKER;
-    ESP.restart();
+    g_scheduler.setEnabled(g_update_task, true);
   });
 
-  g_data_source->setOnAnnouncement([&](const String& msg, bool static_msg, int display_time){
+  g_data_source->setOnAnnouncement([&](const TextView& msg, bool static_msg, int display_time){
     if (g_announcement=="") {
       g_announcement_static = static_msg;
       g_announcement_time = display_time;
-      g_announcement = msg;
+      g_announcement = msg.toString();
     } // ignore otherwise
   });
 
-  g_data_source->setOnPriceATH([&](const String& price){
+  g_data_source->setOnPriceATH([&](const TextView& price){
     g_price_action->setATHPrice(price);
   });
 
-  g_data_source->setOnPriceTimeoutSet([&](const String& timeout){
-    g_price_action->setPriceTimeout(timeout.toFloat());
+  g_data_source->setOnPriceTimeoutSet([&](const TextView& timeout){
+    g_price_action->setPriceTimeout(timeout.toString().toFloat());
   });
 
-  g_data_source->setOnPriceChange([&](const String& price){
+  g_data_source->setOnPriceChange([&](const TextView& price){
+    if (g_data_source->isBenchmarkRunning()) { // only the display, no logging or boot stages
+      g_price_action->updatePrice(price);
+      return;
+    }
+
     auto currentPrice = Price(price);
     currentPrice.debug_print();
 
+    Display::PriceAction& price_action = g_benchmark ? g_benchmark->saved_price : *g_price_action;
     if (g_reset_price_on_next_tick) {
-      g_price_action->reset();
+      price_action.reset();
       g_reset_price_on_next_tick = false;
     }
 
-    g_price_action->updatePrice(price);
-    DEBUG_SERIAL.printf_P(PSTR("[SYSTEM] Free heap: %i\n"),ESP.getFreeHeap());
+    price_action.updatePrice(price);
+    DEBUG_SERIAL.printf_P(PSTR("[SYSTEM] Free heap: %i, price draw allocations: %u, layout updates: %u\n"),
+      ESP.getFreeHeap(), g_price_action->getDrawAllocations(), g_price_action->getLayoutUpdates());
   });
 
   g_data_source->setOnNewSettings([&](){
@@ -387,8 +525,67 @@ void setupDataSource()
 //    g_price_action->reset();
   });
 
+  g_data_source->setOnBenchmark([&](const TextView& args){
+    const int separator = args.indexOf(' ');
+    const TextView name = (separator == -1) ? args : args.substring(0, separator);
+    const long messages = (separator == -1) ? 200 : std::min(std::max(args.substring(separator+1).toInt(), 1L), 1000L);
+
+    Benchmark::Scenario scenario;
+    if (!Benchmark::parseScenario(name, scenario)) {
+      g_data_source->queueText(";DIAG benchmark unknown_scenario");
+      return;
+    }
+    if (g_current_mode != MODE::TICKER || g_benchmark) {
+      g_data_source->queueText(";DIAG benchmark busy");
+      return;
+    }
+
+    g_benchmark.reset(new BenchmarkRun(name, scenario, messages));
+#if defined(X_DISPLAY_PROFILER)
+    g_display->getProfiler().setPaused(true);
+#endif
+    g_scheduler.setEnabled(g_benchmark_task, true);
+  });
+
+  // a slice per run, so that the network, the watchdog and the other tasks are served in between
+  g_benchmark_task = g_scheduler.addTask("benchmark", 1, []() {
+    if (!g_benchmark->run.step(c_benchmark_slice_frames))
+      return;
+
+    g_scheduler.setEnabled(g_benchmark_task, false);
+#if defined(X_DISPLAY_PROFILER)
+    g_display->getProfiler().setPaused(false);
+#endif
+    *g_price_action = g_benchmark->saved_price;
+    g_data_source->queueText(";DIAG " + Benchmark::format(TextView{g_benchmark->name.c_str(), g_benchmark->name.length()},
+      g_benchmark->run.getResult(), g_display->getMilisPerTick() * 1000));
+    g_benchmark.reset();
+  }, Scheduler::PRIORITY_LOW);
+  g_scheduler.setEnabled(g_benchmark_task, false);
+
+  // firmware pushed by the server over the websocket, the ticker keeps running until the first chunk
+  g_data_source->setOnFirmwareProgress([](const uint32_t received, const uint32_t total) {
+    if (!g_firmware_progress) {
+      g_firmware_progress = make_shared<Display::Action::Progress>("UPD ");
+      g_display->prependAction(g_firmware_progress);
+      g_current_mode = MODE::UPDATE;
+    }
+    g_firmware_progress->setProgress(received, total);
+  });
+
+  g_data_source->setOnFirmwareReceived([](const bool success) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] Firmware received over websocket, %s\n"), success ? "restarting" : "failed");
+    if (success) {
+      g_parameters.flush();
+      delay(c_update_report_time_ms); // lets ;FW_DONE reach the server
+      ESP.restart();
+    }
+    g_firmware_progress = nullptr;
+    forceSetTickerMode();
+  });
 
   g_data_source->connect();
+  g_scheduler.addTask("network", 5, []() { g_data_source->loop(); }, Scheduler::PRIORITY_HIGH);
 }
 
 void setupLogo()
@@ -416,7 +613,11 @@ void connectToWiFi()
 void setupNTP()
 {
   DEBUG_SERIAL.println(F("Starting NTP.."));
-  int timezone = g_parameters["timezone"].toInt();
+  int timezone = g_parameters.getInt(ParameterId::TIMEZONE);
+  NTP.onNTPSyncEvent([](NTPSyncEvent_t event) {
+    if (event == timeSyncd)
+      g_boot_profiler.mark(BootProfiler::Stage::NTP_SYNCED);
+  });
   NTP.begin(NTP_SERVER, timezone, true);
   NTP.setInterval(1800);
 
@@ -431,6 +632,7 @@ void factoryReset()
   g_wifi->resetSettings();
 
   Utils::eeprom_WIPE();
+  g_parameters.wipe();
 
   delay(1000);
   g_wifi->resetSettings();
@@ -443,7 +645,7 @@ void startOnDemandAP()
   g_data_source->disconnect();
   DEBUG_SERIAL.println(F("Starting portal"));
   g_wifi->resetSettings();
-  g_wifi->startAP("OnDemandAP_"+String(ESP.getChipId()), 120);
+  g_wifi->startAP("OnDemandAP_"+String(g_identity.getChipId()), 120);
   g_wifi->resetSettings();
   ESP.restart();
 }
@@ -454,7 +656,6 @@ void setupDefaultButtons()
   g_flash_button->onShortPress(switchMenu);
   g_flash_button->onLongPress([]() { g_start_ondemand_ap = true; });
   g_flash_button->onSuperLongPress([]() { g_force_wipe = true;} );
-  g_flash_button->setupTickCallback([]() { g_flash_button->tick(); });
 }
 
 void switchMenu()
@@ -479,6 +680,7 @@ void setupButton()
 {
   g_flash_button = make_shared<Button>(PORTAL_TRIGGER_PIN);
   setupDefaultButtons();
+  g_scheduler.addTask("button", 100, []() { g_flash_button->tick(); }, Scheduler::PRIORITY_HIGH, true);
 }
 
 void forceSetTickerMode()
@@ -502,7 +704,8 @@ void sendOTPRequest()
   );
   g_menu->end();
 
-  g_data_source->setOnOTP([](const String& otp){
+  g_data_source->setOnOTP([](const TextView& otp_text){
+    const String otp = otp_text.toString();
     auto multi = Display::Action::createRepeatedSlide({-1,0}, otp_timeout, 1.0,
       make_shared<Display::Action::StaticText>("OTP:", 0.8),
       make_shared<Display::Action::StaticText>(otp, 5.0),
@@ -530,9 +733,9 @@ void displayDeviceInfo()
 {
   String info= "v" FIRMWARE_VERSION;
   info += " " __DATE__ " " __TIME__;
-  info += " MD5: " + ESP.getSketchMD5().substring(0,6);
-  info += " UUID: " + g_parameters["__device_uuid"].substring(0,6);
-  info += " SDK: " + String(ESP.getSdkVersion());
+  info += " MD5: " + g_identity.getSketchMD5().substring(0,6);
+  info += " UUID: " + g_identity.getUUID().substring(0,6);
+  info += " SDK: " + String(g_identity.getSdkVersion());
   setAnnouncement(info, false, 0, [](){g_menu->end();});
 }
 
@@ -564,14 +767,20 @@ void setupMenu()
 #else
 
 void setup() {
+  g_scheduler.begin();
   setupButton();
   setupSerial();
+  g_boot_profiler.mark(BootProfiler::Stage::SERIAL_READY);
   setupHW();
+  g_boot_profiler.mark(BootProfiler::Stage::HARDWARE);
   setupDisplay();
+  g_boot_profiler.mark(BootProfiler::Stage::DISPLAY_READY);
   setupClock();
+  setupTelemetry();
 
   setupParameters();
   loadParameters();
+  g_boot_profiler.mark(BootProfiler::Stage::PARAMETERS);
   setupMenu();
 
   setupLogo();
@@ -581,18 +790,14 @@ void setup() {
   connectToWiFi();
   g_display->cleanQueue();
   g_display->queueAction(make_shared<Display::Action::StaticText>(WiFi.SSID(), 1.0));
+  g_wifi_connected_at = millis();
 
-  /* Update */
-  g_display->queueAction(make_shared<Display::Action::RotatingText>("UPDATING... ", -1, 20));
-  g_current_mode = MODE::UPDATE;
-  Firmware::update(g_parameters["update_url"]);
-  g_current_mode = MODE::TICKER;
-
-  g_price_action = make_shared<Display::PriceAction>(10.0); // animation speed, in digits per second
-  g_display->replaceAction(g_price_action);
+  g_price_action = make_shared<Display::PriceAction>(10); // animation speed, in digits per second
+  g_display->queueAction(g_price_action);
 
-  setupNTP();
   setupDataSource();
+  setupNTP();
+  setupUpdateCheck();
 
 //  tone(D8, 1000);
 }
@@ -617,8 +822,7 @@ void loop() {
     }
   }
 
-  g_data_source->loop();
-  delay(10);
+  g_scheduler.loop();
 }
 
 #endif
@@ -23,6 +23,7 @@
 
 void setup()
 {
+  g_scheduler.begin();
   setupSerial();
   setupHW();
   setupDisplay();
@@ -37,7 +38,8 @@ void setup()
 
   /* Update */
   g_display->queueAction(make_shared<Display::Action::RotatingText>("UPDATING... ", -1, 20));
-  Firmware::update(g_parameters["update_url"]);
+  if (Firmware::update(g_parameters.getString(ParameterId::UPDATE_URL)).status == Firmware::Status::UPDATED)
+    ESP.restart();
 
   setupButton();
   setupNTP();
@@ -53,5 +55,5 @@ void loop()
   if (g_force_wipe==true)
     factoryReset();
 
-  delay(100);
+  g_scheduler.loop();
 }
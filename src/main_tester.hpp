@@ -25,6 +25,7 @@ shared_ptr<Display::Action::TestDisplay> g_test_display_action;
 
 void setup()
 {
+  g_scheduler.begin();
   setupSerial();
   setupDisplay();
   g_test_display_action = make_shared<Display::Action::TestDisplay>();
@@ -33,11 +34,10 @@ void setup()
   g_flash_button = make_shared<Button>(PORTAL_TRIGGER_PIN);
   g_flash_button->onShortPress([&](){g_test_display_action->nextMode();});
 //  g_flash_button->onLongPress([](){});
-  g_flash_button->setupTickCallback([&]() { g_flash_button->tick(); });
+  g_scheduler.addTask("button", 100, []() { g_flash_button->tick(); }, Scheduler::PRIORITY_HIGH, true);
 }
 
 void loop()
 {
-  g_flash_button->tick();
-  delay(5);
+  g_scheduler.loop();
 }
@@ -78,7 +78,7 @@ void Menu::onShortPress()
 
 void Menu::saveParameters()
 {
-  m_parameters->storeToEEPROM();
+  m_parameters->scheduleStore();
 }
 
 void Menu::draw(DisplayT *display, const Coords& coords)
@@ -0,0 +1,49 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Parameter schema, in ParameterId order; only the values are kept in RAM.
+  Included by main.cpp (after config.hpp, as it depends on the model), and by the native build.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include "parameter_store.hpp"
+
+// name, description, default value, field length, type, min, max
+const ParameterSchema c_parameter_schema[(size_t) ParameterId::COUNT] PROGMEM = {
+  {"__LEGACY_ticker_server_host", "", "", 0, ParameterType::STRING, 0, 0},
+  {"__LEGACY_ticker_server_port", "", "", 0, ParameterType::STRING, 0, 0},
+  {"__LEGACY_ticker_path", "", "", 0, ParameterType::STRING, 0, 0},
+  {"__LEGACY_currency_pair", "", "", 0, ParameterType::STRING, 0, 0},
+  {"__device_uuid", "", "", 0, ParameterType::STRING, 0, 0}, // new uuid will be generated on every device wipe
+  {"update_url", "Update server", "update.cryptoclock.net", 50, ParameterType::STRING, 0, 0},
+  {"ticker_url", "Ticker server", "wss://ticker.cryptoclock.net:443/", 100, ParameterType::STRING, 0, 0},
+  {"brightness", "Brightness (1-5)", "3", 5, ParameterType::INT, 1, 5},
+  {"font", "Font (0-2)", "0", 5, ParameterType::INT, 0, 2},
+#ifdef HAS_GYROSCOPE
+  {"rotate_display", "Rotate Display (0,1, 2=auto)", "0", 5, ParameterType::INT, 0, 2},
+#else
+  {"rotate_display", "Rotate Display (0,1)", "0", 5, ParameterType::INT, 0, 2},
+#endif
+  {"clock_mode", "Show Clock (0-2)", "1", 5, ParameterType::INT, 0, 2},
+  {"clock_interval", "Clock display interval (secs)", "30", 5, ParameterType::INT, 5, 3600}, // scheduler periods are kept in 32 bit microseconds
+  {"telemetry_interval", "Telemetry interval (secs, 0=off)", "300", 5, ParameterType::INT, 0, 3600},
+  {"timezone", "Timezone (-11..+13)", "1", 5, ParameterType::INT, -11, 13},
+};
@@ -19,100 +19,364 @@
 
 #include "parameter_store.hpp"
 #include <EEPROM.h>
+#include <algorithm>
 #include "utils.hpp"
 #include "data_source.hpp"
 
 extern DataSource *g_data_source;
 
-void ParameterStore::addItem(ParameterItem item)
+namespace {
+const char c_reserved_prefix[] PROGMEM = "__";
+const char c_legacy_prefix[] PROGMEM = "__LEGACY_";
+
+bool schemaStartsWith(const ParameterSchema *schema, PGM_P prefix)
 {
-  m_items.emplace(item.name, item);
+  return schema && strncmp_P(schema->name, prefix, strlen_P(prefix)) == 0;
+}
 }
 
-void ParameterStore::debug_print(void)
+String ParameterItem::getName() const
 {
-  for (const auto& item_pair : m_items) {
-    const auto item = item_pair.second;
-    DEBUG_SERIAL.printf_P(PSTR("[Parameters] name: '%s', value: '%s', description: '%s', field_length: '%i'\n"),
-      item.name.c_str(), item.value.c_str(), item.description.c_str(), item.field_length);
+  return schema ? String(FPSTR(schema->name)) : String();
+}
+
+String ParameterItem::getDescription() const
+{
+  return schema ? String(FPSTR(schema->description)) : String();
+}
+
+bool ParameterItem::isReserved() const
+{
+  return schemaStartsWith(schema, c_reserved_prefix);
+}
+
+bool ParameterItem::isLegacy() const
+{
+  return schemaStartsWith(schema, c_legacy_prefix);
+}
+
+extern "C" uint32_t _SPIFFS_start; // SPIFFS is not used, its first sectors hold the parameter log
+extern "C" uint32_t _SPIFFS_end;
+
+namespace {
+const uint32_t c_flash_mapped_at = 0x40200000;
+
+uint8_t logSectors(const uint8_t wanted)
+{
+  const uint32_t available = ((uint32_t) (uintptr_t) &_SPIFFS_end - (uint32_t) (uintptr_t) &_SPIFFS_start) / FlashLog::c_sector_size;
+  return std::min(available, (uint32_t) wanted);
+}
+}
+
+ParameterStore::ParameterStore() :
+  m_items((size_t) ParameterId::COUNT),
+  m_log(((uint32_t) (uintptr_t) &_SPIFFS_start - c_flash_mapped_at) / FlashLog::c_sector_size, logSectors(c_log_sectors)),
+  m_stored_checksum(0), m_stored_valid(false), m_store_pending(false), m_store_requested_at(0),
+  m_commits(0), m_commits_unchanged(0), m_stores_coalesced(0)
+{}
+
+void ParameterStore::begin(const ParameterSchema *schema)
+{
+  for (size_t i=0;i<m_items.size();++i) {
+    ParameterItem& item = m_items[i];
+    item.schema = &schema[i];
+    item.value = String(FPSTR(schema[i].default_value));
+    validate(item);
   }
 }
 
-void ParameterStore::loadFromEEPROMwithoutInit(void)
+void ParameterStore::setCallback(const ParameterId id, parameter_onchange_t on_change)
 {
-  DEBUG_SERIAL.println(F("[Parameters] Loading from EEPROM"));
+  item(id).on_change = on_change;
+}
 
-  int offset = c_eeprom_offset;
-  String header = Utils::eeprom_ReadString(offset);
-  if (header != "PARAMS") {
-    DEBUG_SERIAL.println(F("[Parameters] Invalid EEPROM header, using defaults\n"));
+// clamps INT parameters to their range and caches the parsed value
+void ParameterStore::validate(ParameterItem& item)
+{
+  if (item.getType() != ParameterType::INT)
     return;
+
+  const long min_value = (int32_t) pgm_read_dword(&item.schema->min_value);
+  const long max_value = (int32_t) pgm_read_dword(&item.schema->max_value);
+  item.int_value = std::min(std::max(item.value.toInt(), min_value), max_value);
+  item.value = String(item.int_value);
+}
+
+void ParameterStore::triggerCallback(ParameterItem& item, const bool init, const bool final_change)
+{
+  validate(item);
+  if (item.on_change) {
+    item.on_change(item, init, final_change);
+    validate(item); // callback may have adjusted the value
   }
+}
 
-  while(true) {
-    String name = Utils::eeprom_ReadString(offset);
-    if (name=="" || name=="ENDPARAMS")
-      break;
-    String value = Utils::eeprom_ReadString(offset);
+void ParameterStore::debug_print(void)
+{
+  for (const auto& item : m_items) {
+    if (item.schema == nullptr)
+      continue;
+    DEBUG_SERIAL.printf_P(PSTR("[Parameters] name: '%s', value: '%s', description: '%s', field_length: '%i'\n"),
+      item.getName().c_str(), item.value.c_str(), item.getDescription().c_str(), item.getFieldLength());
+  }
+}
 
-    auto item = findByName(name);
+void ParameterStore::applyStored(const String& name, const String& value)
+{
+  auto item = findByName(name);
+  if (item==nullptr) {
+    item = findByName("__LEGACY_"+name);
     if (item==nullptr) {
-      item = findByName("__LEGACY_"+name);
-      if (item==nullptr) {
-        DEBUG_SERIAL.printf_P(PSTR("[Parameters] Unknown parameter '%s', ignoring\n"),name.c_str());
-        continue;
-      }
-      DEBUG_SERIAL.printf_P(PSTR("[Parameters] Legacy parameter '%s', value '%s'\n"),name.c_str(), value.c_str());
+      DEBUG_SERIAL.printf_P(PSTR("[Parameters] Unknown parameter '%s', ignoring\n"),name.c_str());
+      return;
     }
+    DEBUG_SERIAL.printf_P(PSTR("[Parameters] Legacy parameter '%s', value '%s'\n"),name.c_str(), value.c_str());
+  }
+
+  item->value = value;
+  triggerCallback(*item, true, true);
+}
+
+/* Binary config image: header, then records of [id, length, value bytes] in ParameterId order.
+   Ids of unknown parameters (written by newer firmware) are skipped. */
+namespace {
+struct ConfigHeader {
+  uint32_t magic;
+  uint8_t format_version;
+  uint8_t schema_version; // bumped when the meaning of existing ids or values changes
+  uint16_t length; // of the records
+  uint32_t crc; // CRC32 of the records
+};
 
-    item->value = value;
-    if (item->on_change!=nullptr)
-      item->on_change(*item, true, true);
+struct StoredValue {
+  uint8_t id;
+  String value;
+};
+
+const uint32_t c_config_magic = 0x47464343; // "CCFG"
+const uint8_t c_config_format_version = 1;
+const uint8_t c_config_schema_version = 1;
+
+bool decodeRecords(const uint8_t *records, const uint8_t *end, std::vector<StoredValue>& values)
+{
+  while (records != end) {
+    if (end - records < 2 || records[1] > end - records - 2)
+      return false;
+    const uint8_t length = records[1];
+    values.push_back(StoredValue{records[0], String()});
+    String& value = values.back().value;
+    value.reserve(length);
+    for (uint8_t i=0;i<length;++i)
+      value += (char) records[2 + i];
+    records += 2 + length;
   }
+  return true;
+}
 
-  debug_print();
+/* Brings the values of an image written with an older schema up to c_config_schema_version, one
+   version at a time. Images of a newer schema (after a downgrade) are rejected, the meaning of
+   their values isn't known. Schema 1 is the first one, there is nothing to migrate from yet. */
+bool migrate(uint8_t schema_version, std::vector<StoredValue>& values)
+{
+  (void) values;
+  while (schema_version < c_config_schema_version) {
+    switch (schema_version) {
+    // case N: rewrite the values of schema N as schema N+1 expects them
+    default:
+      return false;
+    }
+    ++schema_version;
+  }
+  return schema_version == c_config_schema_version;
+}
 }
 
-void ParameterStore::storeToEEPROMwithoutInit(void)
+void ParameterStore::load(void)
 {
-  DEBUG_SERIAL.println(F("[Parameters] Storing to EEPROM"));
+  std::vector<uint8_t> data;
+  if (m_log.open() && m_log.read(data)) {
+    DEBUG_SERIAL.printf_P(PSTR("[Parameters] Loading from flash log, sector %u\n"), m_log.getSector());
+    m_stored_checksum = Utils::fnv1a(data.data(), data.size());
+    m_stored_valid = true;
+  } else {
+    DEBUG_SERIAL.println(F("[Parameters] Loading from EEPROM"));
+    data.resize(c_eeprom_size);
+    for (size_t i=0;i<data.size();++i)
+      data[i] = EEPROM.read(c_eeprom_offset + i);
+  }
+
+  if (!deserialize(data) && !deserializeText(data)) {
+    DEBUG_SERIAL.println(F("[Parameters] No valid configuration, using defaults"));
+    m_stored_valid = false;
+  }
   debug_print();
-  int offset = c_eeprom_offset;
-  Utils::eeprom_WriteString(offset, "PARAMS");
-  for (const auto& item_pair : m_items) {
-    const auto item = item_pair.second;
-    if (item.name.startsWith("__LEGACY_"))
+}
+
+void ParameterStore::serialize(std::vector<uint8_t>& data)
+{
+  data.assign(sizeof(ConfigHeader), 0);
+  for (size_t i=0;i<m_items.size();++i) {
+    const auto& item = m_items[i];
+    if (item.schema == nullptr || item.isLegacy())
       continue;
-    Utils::eeprom_WriteString(offset, item.name);
-    Utils::eeprom_WriteString(offset, item.value);
+    const size_t length = std::min(item.value.length(), (unsigned int) 255);
+    data.push_back(i);
+    data.push_back(length);
+    data.insert(data.end(), item.value.c_str(), item.value.c_str() + length);
+  }
+
+  const uint8_t *records = data.data() + sizeof(ConfigHeader);
+  const size_t length = data.size() - sizeof(ConfigHeader);
+  ConfigHeader header = { c_config_magic, c_config_format_version, c_config_schema_version,
+    (uint16_t) length, Utils::crc32(records, length) };
+  memcpy(data.data(), &header, sizeof(header));
+}
+
+bool ParameterStore::deserialize(const std::vector<uint8_t>& data)
+{
+  ConfigHeader header;
+  if (data.size() < sizeof(header))
+    return false;
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != c_config_magic || header.format_version != c_config_format_version)
+    return false;
+
+  if (header.length > data.size() - sizeof(header)) {
+    DEBUG_SERIAL.printf_P(PSTR("[Parameters] Configuration length %u exceeds %u bytes\n"), header.length, (uint32_t) (data.size() - sizeof(header)));
+    return false;
+  }
+  const uint8_t *records = data.data() + sizeof(header);
+  if (Utils::crc32(records, header.length) != header.crc) {
+    DEBUG_SERIAL.println(F("[Parameters] Configuration CRC mismatch"));
+    return false;
+  }
+
+  // applied only once the whole image is known to be good
+  std::vector<StoredValue> values;
+  if (!decodeRecords(records, records + header.length, values)) {
+    DEBUG_SERIAL.println(F("[Parameters] Configuration record truncated"));
+    return false;
+  }
+  if (!migrate(header.schema_version, values)) {
+    DEBUG_SERIAL.printf_P(PSTR("[Parameters] Configuration schema %u can't be migrated to %u\n"), header.schema_version, c_config_schema_version);
+    return false;
+  }
+
+  for (const auto& stored : values) {
+    if (stored.id < m_items.size() && m_items[stored.id].schema != nullptr) {
+      auto& item = m_items[stored.id];
+      item.value = stored.value;
+      triggerCallback(item, true, true);
+    }
+  }
+  return true;
+}
+
+/* layout of older firmware: "PARAMS", then name and value pairs, "ENDPARAMS", all NUL terminated;
+   only read, the next store() migrates it to the binary image */
+bool ParameterStore::deserializeText(const std::vector<uint8_t>& data)
+{
+  const char *text = (const char*) data.data();
+  const char *end = text + data.size();
+  auto next = [&text, end]() {
+    const char *start = text;
+    while (text < end && *text != '\0' && *text != '\xFF') ++text; // NUL or erased flash
+    String value;
+    value.reserve(text - start);
+    for (const char *c=start;c<text;++c)
+      value += *c;
+    if (text < end) ++text;
+    return value;
+  };
+
+  if (next() != "PARAMS")
+    return false;
+  DEBUG_SERIAL.println(F("[Parameters] Migrating text configuration"));
+  while (text < end) {
+    const String name = next();
+    if (name=="" || name=="ENDPARAMS")
+      break;
+    applyStored(name, next());
+  }
+  m_stored_valid = false; // store the binary image on the next store()
+  return true;
+}
+
+void ParameterStore::store(void)
+{
+  m_store_pending = false;
+
+  std::vector<uint8_t> data;
+  serialize(data);
+  const uint32_t checksum = Utils::fnv1a(data.data(), data.size());
+  if (m_stored_valid && checksum == m_stored_checksum) {
+    ++m_commits_unchanged;
+    DEBUG_SERIAL.println(F("[Parameters] Unchanged, not storing"));
+    return;
   }
-  Utils::eeprom_WriteString(offset, "ENDPARAMS");
+
+  DEBUG_SERIAL.printf_P(PSTR("[Parameters] Storing %u bytes to flash log\n"), (uint32_t) data.size());
+  debug_print();
+  if (!m_log.append(data.data(), data.size())) {
+    DEBUG_SERIAL.println(F("[Parameters] Flash log write failed, storing to EEPROM"));
+    storeToEEPROM(data);
+  }
+  m_stored_checksum = checksum;
+  m_stored_valid = true;
+  ++m_commits;
 }
 
-void ParameterStore::storeToEEPROM(void)
+void ParameterStore::storeToEEPROM(const std::vector<uint8_t>& data)
 {
+  if (data.size() > c_eeprom_size) {
+    DEBUG_SERIAL.println(F("[Parameters] Configuration too large for EEPROM"));
+    return;
+  }
   Utils::eeprom_BEGIN();
-  storeToEEPROMwithoutInit();
+  for (size_t i=0;i<data.size();++i)
+    EEPROM.write(c_eeprom_offset + i, data[i]);
   Utils::eeprom_END();
 }
 
-ParameterMap_t& ParameterStore::all_items(void)
+void ParameterStore::scheduleStore(void)
 {
-  return m_items;
+  if (m_store_pending)
+    ++m_stores_coalesced;
+  m_store_pending = true;
+  m_store_requested_at = millis();
 }
 
-ParameterItem* ParameterStore::findByName(const String& name)
+void ParameterStore::loop(void)
+{
+  if (m_store_pending && millis() - m_store_requested_at >= c_store_delay_ms)
+    store();
+}
+
+void ParameterStore::flush(void)
+{
+  if (m_store_pending)
+    store();
+}
+
+void ParameterStore::wipe(void)
 {
-  auto item = m_items.find(name);
-  if (item==m_items.end()) // not found
-    return nullptr;
+  m_log.erase();
+  m_stored_valid = false;
+  m_store_pending = false;
+}
 
-  return &(*item).second;
+ParameterItem* ParameterStore::findByName(const String& name)
+{
+  for (auto& item : m_items) {
+    if (item.hasName(name.c_str()))
+      return &item;
+  }
+  return nullptr;
 }
 
-String& ParameterStore::operator[] (const char *name)
+const String& ParameterStore::operator[] (const char *name)
 {
-  static String notfound("");
+  static const String notfound("");
   ParameterItem *item = findByName(name);
   if (item != nullptr)
     return item->value;
@@ -127,14 +391,22 @@ bool ParameterStore::setValue(const String& name, const String& value)
     return false;
 
   parameter->value = value;
+  validate(*parameter);
   return true;
 }
 
+void ParameterStore::setValue(const ParameterId id, const String& value)
+{
+  ParameterItem& parameter = item(id);
+  parameter.value = value;
+  validate(parameter);
+}
+
 void ParameterStore::iterateAllParameters(parameter_iterate_func_t func)
 {
-  for (auto& item_pair : m_items) {
-    auto &item = item_pair.second;
-    func(&item);
+  for (auto& item : m_items) {
+    if (item.schema != nullptr)
+      func(&item);
   }
 }
 
@@ -143,8 +415,7 @@ void ParameterStore::setIfExistsAndTriggerCallback(const String& name, const Str
   auto parameter = findByName(name);
   if (parameter) {
     parameter->value = value;
-    if (parameter->on_change)
-      parameter->on_change(*parameter, false, final_change);
+    triggerCallback(*parameter, false, final_change);
     if (final_change)
       g_data_source->sendParameter(parameter);
   }
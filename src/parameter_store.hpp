@@ -24,47 +24,129 @@
 #pragma once
 #include "config_common.hpp"
 #include <Arduino.h>
-#include <map>
+#include <vector>
 #include <functional>
+#include "flash_log.hpp"
+
+/* parameter ids, also indexes into the store, so that firmware code reads parameters without
+   any lookup; names are only used by the protocol, WiFi portal and menu. Ids key the stored
+   configuration, so new parameters are only appended. */
+enum class ParameterId : uint8_t {
+  LEGACY_TICKER_SERVER_HOST,
+  LEGACY_TICKER_SERVER_PORT,
+  LEGACY_TICKER_PATH,
+  LEGACY_CURRENCY_PAIR,
+  DEVICE_UUID,
+  UPDATE_URL,
+  TICKER_URL,
+  BRIGHTNESS,
+  FONT,
+  ROTATE_DISPLAY,
+  CLOCK_MODE,
+  CLOCK_INTERVAL,
+  TELEMETRY_INTERVAL,
+  TIMEZONE,
+  COUNT
+};
+
+enum class ParameterType : uint8_t { STRING, INT }; // enums are INT parameters with a range
+
+/* Static description of a parameter. The schema table lives in PROGMEM (indexed by ParameterId),
+   only the live values are kept in RAM. */
+struct ParameterSchema {
+  char name[28];
+  char description[36];
+  char default_value[40];
+  uint8_t field_length; // of the WiFi portal input
+  ParameterType type;
+  int32_t min_value; // INT only
+  int32_t max_value;
+};
 
 struct ParameterItem;
 
-typedef std::function<void(ParameterItem& item, bool init, bool final_change)> parameter_onchange_t;
+typedef void (*parameter_onchange_t)(ParameterItem& item, bool init, bool final_change);
 
 struct ParameterItem {
-  String name;
-  String description;
+  const ParameterSchema *schema; // PROGMEM, nullptr until the store is initialized
   String value;
-  int field_length;
+  int32_t int_value; // INT parameters only, cached and clamped to min..max when value changes
   parameter_onchange_t on_change;
+
+  String getName() const;
+  String getDescription() const;
+  uint8_t getFieldLength() const { return schema ? pgm_read_byte(&schema->field_length) : 0; }
+  ParameterType getType() const { return schema ? (ParameterType) pgm_read_byte(&schema->type) : ParameterType::STRING; }
+  bool hasName(const char *name) const { return schema && strcmp_P(name, schema->name) == 0; }
+  bool isReserved() const; // "__" prefix, not shown or sent to server
+  bool isLegacy() const; // "__LEGACY_" prefix, only read from EEPROM
 };
 
-typedef std::map<String, ParameterItem> ParameterMap_t;
 typedef std::function<void(const ParameterItem*)> parameter_iterate_func_t;
 
 class ParameterStore
 {
 public:
-  ParameterStore() {}
-
-  void addItem(ParameterItem item);
-
-  void loadFromEEPROMwithoutInit(void);
-  void storeToEEPROMwithoutInit(void);
-  void storeToEEPROM(void);
+  ParameterStore();
+
+  void begin(const ParameterSchema *schema); // table of ParameterId::COUNT entries, sets default values
+  void setCallback(const ParameterId id, parameter_onchange_t on_change);
+
+  /* Parameters are persisted as a binary image (CRC32 checked records keyed by ParameterId) in
+     a flash log rotating over a few sectors (see FlashLog), and only written when they changed.
+     If the log is empty (first boot after an update from older firmware), they are read from
+     the EEPROM, where the text layout of older firmware is migrated. */
+  void load(void); // needs an open EEPROM session for the fallback
+  void store(void); // writes now
+  void scheduleStore(void); // coalesces changes, written c_store_delay_ms after the last one
+  void loop(void);
+  void flush(void); // writes a scheduled store now, before restarting
+  void wipe(void);
+
+  uint32_t getCommits(void) { return m_commits; }
+  uint32_t getCommitsUnchanged(void) { return m_commits_unchanged; }
+  uint32_t getStoresCoalesced(void) { return m_stores_coalesced; }
+  uint32_t getErases(void) { return m_log.getErases(); }
 
   void debug_print(void);
 
-  ParameterMap_t& all_items(void);
+  size_t size(void) { return m_items.size(); }
+
+  // typed access by id, for firmware code
+  ParameterItem& item(const ParameterId id) { return m_items[(size_t) id]; }
+  const String& getString(const ParameterId id) { return item(id).value; }
+  int32_t getInt(const ParameterId id) { return item(id).int_value; }
+  void setValue(const ParameterId id, const String& value);
 
+  // access by name, for the protocol, portal and menu
   bool setValue(const String& name, const String& value);
-  String& operator[] (const char *name);
+  const String& operator[] (const char *name);
   ParameterItem* findByName(const String& name);
   void setIfExistsAndTriggerCallback(const String& name, const String& value, bool final_change);
 
   void iterateAllParameters(parameter_iterate_func_t func);
 private:
-  ParameterMap_t m_items;
+  void validate(ParameterItem& item);
+  void triggerCallback(ParameterItem& item, const bool init, const bool final_change);
+  void applyStored(const String& name, const String& value);
+  void storeToEEPROM(const std::vector<uint8_t>& data);
+  void serialize(std::vector<uint8_t>& data);
+  bool deserialize(const std::vector<uint8_t>& data);
+  bool deserializeText(const std::vector<uint8_t>& data);
+
+  std::vector<ParameterItem> m_items; // indexed by ParameterId
+
+  FlashLog m_log;
+  uint32_t m_stored_checksum; // of the last stored data, to skip unchanged writes
+  bool m_stored_valid;
+  bool m_store_pending;
+  uint32_t m_store_requested_at; // millis()
+  uint32_t m_commits;
+  uint32_t m_commits_unchanged;
+  uint32_t m_stores_coalesced;
 
   static int const c_eeprom_offset = 1024;
+  static const size_t c_eeprom_size = 1024;
+  static const uint8_t c_log_sectors = 4;
+  static const uint32_t c_store_delay_ms = 3000;
 };
@@ -19,10 +19,44 @@
 
 #include "price.hpp"
 
+namespace {
+const uint32_t c_pow10[] PROGMEM = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+uint32_t powerOf10(const uint8_t exponent)
+{
+  return pgm_read_dword(&c_pow10[exponent]);
+}
+
+// writes decimal digits of value to buffer, padded with zeros to min_digits, returns length
+size_t writeDigits(char *buffer, uint32_t value, const uint8_t min_digits = 1)
+{
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while (value || n<min_digits);
+
+  for (uint8_t i=0;i<n;++i)
+    buffer[i] = digits[n-1-i];
+  return n;
+}
+}
+
+Price::Price() :
+  m_value(0), m_display_decimals(6), m_display_float_part(false), m_initialized(false)
+{}
+
 Price::Price(const String& price) :
-  m_price(0.0), m_display_decimals(6), m_display_float_part(false)
+  Price(TextView{price.c_str(), price.length()})
+{}
+
+Price::Price(const TextView& price) :
+  m_value(0), m_display_decimals(6), m_display_float_part(false)
 {
-  if (price=="") {
+  if (price.empty()) {
     m_initialized = false;
   } else {
     fromString(price);
@@ -30,121 +64,190 @@ Price::Price(const String& price) :
   }
 }
 
-Price::Price(const double price, const bool display_float_part) :
-  m_price(price), m_display_decimals(6), m_display_float_part(display_float_part), m_initialized(true)
+Price::Price(const int64_t value, const bool display_float_part) :
+  m_value(value), m_display_decimals(6), m_display_float_part(display_float_part), m_initialized(true)
 {}
 
-void Price::fromString(const String& price)
+/* same semantics as atof() for plain decimal numbers, digits beyond c_decimals are dropped,
+   magnitudes beyond the int64 range saturate */
+int64_t Price::parse(const TextView& text)
+{
+  size_t i = 0;
+  while (i<text.length && isspace(text.data[i])) ++i;
+
+  bool negative = false;
+  if (i<text.length && (text.data[i]=='-' || text.data[i]=='+'))
+    negative = (text.data[i++]=='-');
+
+  const int64_t max_integer = INT64_MAX / c_unit;
+  int64_t integer = 0;
+  for (;i<text.length && isdigit(text.data[i]);++i)
+    integer = std::min(integer*10 + (text.data[i]-'0'), max_integer);
+
+  int64_t fraction = 0;
+  if (i<text.length && text.data[i]=='.') {
+    ++i;
+    for (uint8_t digit=0;digit<c_decimals;++digit) {
+      fraction *= 10;
+      if (i<text.length && isdigit(text.data[i]))
+        fraction += text.data[i++]-'0';
+    }
+  }
+
+  const int64_t value = (integer*c_unit > INT64_MAX - fraction) ? INT64_MAX : integer*c_unit + fraction;
+  return negative ? -value : value;
+}
+
+void Price::fromString(const TextView& price)
 {
-  int pos=price.indexOf('.');
-  if (pos!=-1)
+  if (price.indexOf('.')!=-1)
     m_display_float_part = true;
 
-  m_price = std::atof(price.c_str());
-  if (m_display_float_part)
-    m_price = std::atof(toString().c_str());
+  m_value = parse(price);
+  if (m_display_float_part) { // truncate to displayed precision
+    char buffer[c_max_length+1];
+    const size_t length = toChars(buffer, sizeof(buffer));
+    m_value = parse(TextView{buffer, length});
+  }
 }
 
 void Price::debug_print()
 {
-  DEBUG_SERIAL.printf("[Price] '%.6f', toS: '%s', incr: '%0.9f'\n", m_price, toString().c_str(), getIncrement());
+  char buffer[c_max_length+1];
+  toChars(buffer, sizeof(buffer));
+  DEBUG_SERIAL.printf_P(PSTR("[Price] toS: '%s', incr: 1/%d\n"), buffer, getIncrExponent());
 }
 
 bool operator< (const Price& lhs, const Price& rhs)
 {
-  return (lhs.m_price < rhs.m_price);
+  return (lhs.m_value < rhs.m_value);
 }
 bool operator==(const Price& lhs, const Price& rhs)
 {
-  return (std::fabs(lhs.m_price - rhs.m_price) < std::numeric_limits<double>::epsilon());
+  return (lhs.m_value == rhs.m_value);
 }
 bool operator> (const Price& lhs, const Price& rhs){ return rhs < lhs; }
 bool operator<=(const Price& lhs, const Price& rhs){ return !(lhs > rhs); }
 bool operator>=(const Price& lhs, const Price& rhs){ return !(lhs < rhs); }
 bool operator!=(const Price& lhs, const Price& rhs){ return !(lhs == rhs); }
 
-Price& Price::operator+=(const double rhs)
+Price& Price::operator+=(const int64_t rhs)
 {
-  m_price += rhs;
+  m_value += rhs;
   return *this;
 }
-Price& Price::operator-=(const double rhs)
+Price& Price::operator-=(const int64_t rhs)
 {
-  m_price -= rhs;
+  m_value -= rhs;
   return *this;
 }
-Price Price::operator+(const double rhs)
+Price Price::operator+(const int64_t rhs)
 {
   Price res = *this;
   return (res += rhs);
 }
-Price Price::operator-(const double rhs)
+Price Price::operator-(const int64_t rhs)
 {
   Price res = *this;
   return (res -= rhs);
 }
 
-String Price::toString()
+/* number of decimals shown depends on magnitude (sign is ignored), above 1000 the float part
+   is switched off for good */
+uint8_t Price::getDecimals()
 {
-  uint8_t l_digits = String((int) m_price).length();
-  uint8_t r_digits = m_display_decimals - l_digits - 1;
+  if (!m_display_float_part)
+    return 0;
 
-  if (m_display_float_part && m_price >= 1.0)
-    r_digits = 3;
+  const int64_t integer = ((m_value < 0) ? -m_value : m_value) / c_unit;
+  if (integer >= 1000) {
+    m_display_float_part = false;
+    return 0;
+  }
 
-  if (m_display_float_part && m_price >= 10.0)
-    r_digits = 2;
+  if (integer >= 100)
+    return 1;
+  if (integer >= 10)
+    return 2;
+  if (integer >= 1)
+    return 3;
+  return m_display_decimals - 1;
+}
 
-  if (m_display_float_part && m_price >= 100.0)
-    r_digits = 1;
+size_t Price::toChars(char *buffer, const size_t size)
+{
+  char str[24];
+  size_t length = 0;
 
-  if (m_display_float_part && m_price >= 1000.0) {
-    m_display_float_part = false;
-    r_digits = 0;
-  }
+  const uint8_t decimals = getDecimals();
+  const uint64_t magnitude = (m_value < 0) ? -m_value : m_value;
+  const uint64_t integer = magnitude / c_unit;
+  const uint32_t fraction = magnitude % c_unit;
+
+  if (m_value < 0)
+    str[length++] = '-';
 
-  if (m_display_float_part && (l_digits+1<m_display_decimals)) {
-    String str =  String(m_price, r_digits+5);
-    if (m_price<1.0)
-      return str.substring(1,1 + 2 + r_digits);
-    else
-      return str.substring(0,l_digits+1+r_digits);
+  if (decimals == 0) {
+    length += writeDigits(str+length, (integer > UINT32_MAX) ? UINT32_MAX : integer);
+    if (length > m_display_decimals)
+      length = m_display_decimals;
   } else {
-    return String((int)m_price).substring(0,m_display_decimals);
+    if (integer != 0) // values below 1 are shown without leading zero, e.g. ".12345"
+      length += writeDigits(str+length, integer);
+    str[length++] = '.';
+    length += writeDigits(str+length, fraction / powerOf10(c_decimals - decimals), decimals);
   }
+
+  if (length >= size)
+    length = size-1;
+  memcpy(buffer, str, length);
+  buffer[length] = '\0';
+  return length;
 }
 
-int Price::getIncrExponent()
+String Price::toString()
 {
-  if (!m_display_float_part)
-    return 1;
-
-  const String& s= toString();
-  int pos = s.indexOf('.');
-  if (pos==-1)
-    return 1;
+  char buffer[c_max_length+1];
+  toChars(buffer, sizeof(buffer));
+  return String(buffer);
+}
 
-  int exponent = s.length()-1 - pos;
-  return std::pow(10, exponent);
+int32_t Price::getIncrExponent()
+{
+  return powerOf10(getDecimals());
 }
 
-double Price::getIncrement()
+int64_t Price::getIncrement()
 {
-  return (1.0 / getIncrExponent());
+  return powerOf10(c_decimals - getDecimals());
 }
 
 Price Price::nextPrice()
 {
-  return Price(m_price + getIncrement(), m_display_float_part);
+  const int64_t increment = getIncrement();
+  return Price(m_value + increment, m_display_float_part);
 }
 
-double Price::delta(const Price& other)
+int64_t Price::delta(const Price& other)
 {
-  return ((m_price - other.m_price) * getIncrExponent());
+  return (m_value - other.m_value) / (getIncrement() / c_delta_unit);
 }
 
-double Price::get() {
-  return m_price;
+int32_t Price::stepFraction()
+{
+  const int64_t increment = getIncrement();
+  const int64_t magnitude = (m_value < 0) ? -m_value : m_value;
+  return (magnitude % increment) / (increment / c_delta_unit);
+}
+
+int64_t Price::getRaw()
+{
+  return m_value;
+}
+
+long Price::toInt()
+{
+  return m_value / c_unit;
 }
 
 bool Price::isInitialized()
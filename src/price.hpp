@@ -24,13 +24,19 @@
 #pragma once
 #include "config_common.hpp"
 #include <Arduino.h>
+#include "text_view.hpp"
 
+/*
+  Prices are kept as fixed point integers (in units of 10^-c_decimals), parsed once from
+  the received text. Increments, deltas and formatting are integer-only, as ESP8266 has no FPU.
+*/
 class Price
 {
 public:
+  Price();
   Price(const String& price);
-  Price(const double price, const bool display_float_part);
-  void fromString(const String& price);
+  Price(const TextView& price);
+  void fromString(const TextView& price);
   void debug_print();
   friend bool operator< (const Price& lhs, const Price& rhs);
   friend bool operator==(const Price& lhs, const Price& rhs);
@@ -39,25 +45,38 @@ public:
   friend bool operator>=(const Price& lhs, const Price& rhs);
   friend bool operator!=(const Price& lhs, const Price& rhs);
 
-  Price& operator+=(const double rhs);
-  Price& operator-=(const double rhs);
-  Price operator+(const double rhs);
-  Price operator-(const double rhs);
+  // rhs in fixed point units (see getIncrement())
+  Price& operator+=(const int64_t rhs);
+  Price& operator-=(const int64_t rhs);
+  Price operator+(const int64_t rhs);
+  Price operator-(const int64_t rhs);
   String toString();
+  size_t toChars(char *buffer, const size_t size); // returns length, buffer should hold c_max_length+1 chars
 
-  double getIncrement();
-  int getIncrExponent();
+  int64_t getIncrement(); // smallest displayed step, in fixed point units
+  int32_t getIncrExponent();
+  uint8_t getDecimals();
 
   Price nextPrice();
 
-  double delta(const Price& other);
-  double get();
+  int64_t delta(const Price& other); // in increments of this price, scaled by c_delta_unit
+  int32_t stepFraction(); // position within the current increment, 0..c_delta_unit-1
+  int64_t getRaw();
+  long toInt();
 
   bool isInitialized();
   void setDisplayFloatPart(bool display);
   bool displayFloatPart();
+
+  static const uint8_t c_decimals = 9;
+  static const int64_t c_unit = 1000000000LL;
+  static const int32_t c_delta_unit = 1000;
+  static const uint8_t c_max_length = 12;
 private:
-  double m_price;
+  Price(const int64_t value, const bool display_float_part);
+  static int64_t parse(const TextView& text);
+
+  int64_t m_value;
 
   uint8_t m_display_decimals;
   bool m_display_float_part;
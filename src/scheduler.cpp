@@ -0,0 +1,139 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "scheduler.hpp"
+#include "alloc_counter.hpp"
+
+void Scheduler::begin()
+{
+  m_ticker.attach_ms(c_background_tick_ms, [this]() { backgroundTick(); });
+}
+
+Scheduler::task_id_t Scheduler::addTask(const char *name, const uint32_t period_ms, task_callback_t callback,
+  const uint8_t priority, const bool background)
+{
+  Task task = {};
+  task.name = name;
+  task.callback = callback;
+  task.period_us = period_ms * 1000;
+  task.next_run_at = micros() + task.period_us;
+  task.priority = priority;
+  task.background = background;
+  task.enabled = true;
+  m_tasks.push_back(task);
+  return m_tasks.size()-1;
+}
+
+void Scheduler::setPeriod(const task_id_t id, const uint32_t period_ms)
+{
+  if (id >= m_tasks.size())
+    return;
+  m_tasks[id].period_us = period_ms * 1000;
+  m_tasks[id].next_run_at = micros() + m_tasks[id].period_us;
+}
+
+void Scheduler::setEnabled(const task_id_t id, const bool enabled)
+{
+  if (id >= m_tasks.size())
+    return;
+  if (enabled && !m_tasks[id].enabled)
+    m_tasks[id].next_run_at = micros() + m_tasks[id].period_us;
+  m_tasks[id].enabled = enabled;
+}
+
+void Scheduler::runTask(const task_id_t id, const uint32_t now)
+{
+  Task& task = m_tasks[id];
+  const uint32_t lateness = now - task.next_run_at;
+  task.max_lateness_us = std::max(task.max_lateness_us, lateness);
+
+  // keep the cadence stable, unless we are too far behind
+  task.next_run_at += task.period_us;
+  if ((int32_t)(now - task.next_run_at) >= 0) {
+    ++task.overruns;
+    task.next_run_at = now + task.period_us;
+  }
+
+  const uint32_t allocations = AllocCounter::count();
+  const uint32_t free_heap = ESP.getFreeHeap();
+  task.running = true;
+  task.callback();
+
+  // task list may have been modified by the callback
+  Task& finished = m_tasks[id];
+  finished.running = false;
+  finished.max_duration_us = std::max(finished.max_duration_us, (uint32_t)(micros() - now));
+  finished.allocations += AllocCounter::count() - allocations;
+  finished.heap_change += (int32_t) free_heap - (int32_t) ESP.getFreeHeap();
+  ++finished.runs;
+}
+
+// runs the most urgent due task, returns false if there was none
+bool Scheduler::runNextTask(const bool background_only)
+{
+  const uint32_t now = micros();
+  task_id_t next = c_invalid_task;
+
+  for (task_id_t id=0;id<m_tasks.size();++id) {
+    const Task& task = m_tasks[id];
+    if (!task.enabled || task.running || (background_only && !task.background))
+      continue;
+    if ((int32_t)(now - task.next_run_at) < 0)
+      continue;
+    if (next == c_invalid_task || task.priority < m_tasks[next].priority ||
+      (task.priority == m_tasks[next].priority && (int32_t)(task.next_run_at - m_tasks[next].next_run_at) < 0))
+      next = id;
+  }
+
+  if (next == c_invalid_task)
+    return false;
+
+  runTask(next, now);
+  return true;
+}
+
+void Scheduler::loop()
+{
+  for (size_t i=0;i<m_tasks.size() && runNextTask(false);++i)
+    ;
+
+  // sleep until the nearest deadline
+  const uint32_t now = micros();
+  int32_t wait_us = c_max_idle_ms * 1000;
+  for (const auto& task : m_tasks) {
+    if (task.enabled && !task.running)
+      wait_us = std::min(wait_us, (int32_t)(task.next_run_at - now));
+  }
+
+  m_idle = true;
+  if (wait_us >= 1000)
+    delay(wait_us / 1000);
+  else
+    yield();
+  m_idle = false;
+}
+
+void Scheduler::backgroundTick()
+{
+  if (m_idle)
+    return;
+
+  for (size_t i=0;i<m_tasks.size() && runNextTask(true);++i)
+    ;
+}
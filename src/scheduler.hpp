@@ -0,0 +1,86 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Cooperative, deadline based task scheduler. Tasks are run from loop() when their deadline passes,
+  higher priority first, and loop() sleeps until the nearest deadline.
+  Tasks marked as background are also run from a Ticker while the main context is blocked
+  (setup(), WiFi portal, firmware update, ...), so that e.g. the display keeps animating.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <Ticker.h>
+#include <functional>
+#include <vector>
+
+typedef std::function<void()> task_callback_t;
+
+class Scheduler
+{
+public:
+  typedef uint8_t task_id_t;
+  enum Priority : uint8_t { PRIORITY_HIGH = 0, PRIORITY_NORMAL = 1, PRIORITY_LOW = 2 };
+
+  struct Task {
+    const char *name;
+    task_callback_t callback;
+    uint32_t period_us;
+    uint32_t next_run_at; // micros()
+    uint8_t priority;
+    bool background;
+    bool enabled;
+    bool running;
+
+    uint32_t runs;
+    uint32_t overruns; // deadlines missed by more than a whole period
+    uint32_t max_lateness_us;
+    uint32_t max_duration_us;
+    uint32_t allocations; // heap allocations made by the task since boot
+    int32_t heap_change; // net change of used heap, in bytes
+  };
+
+  Scheduler() : m_idle(false) {}
+
+  void begin();
+  task_id_t addTask(const char *name, const uint32_t period_ms, task_callback_t callback,
+    const uint8_t priority = PRIORITY_NORMAL, const bool background = false);
+  void setPeriod(const task_id_t id, const uint32_t period_ms);
+  void setEnabled(const task_id_t id, const bool enabled);
+  void loop();
+
+  size_t getTaskCount() { return m_tasks.size(); }
+  const Task& getTask(const task_id_t id) { return m_tasks[id]; }
+
+  static const task_id_t c_invalid_task = 0xFF;
+private:
+  bool runNextTask(const bool background_only);
+  void runTask(const task_id_t id, const uint32_t now);
+  void backgroundTick();
+
+  std::vector<Task> m_tasks;
+  Ticker m_ticker;
+  volatile bool m_idle; // main context is sleeping in loop(), background ticker has nothing to do
+
+  static const uint32_t c_background_tick_ms = 10;
+  static const uint32_t c_max_idle_ms = 20;
+};
+
+extern Scheduler g_scheduler;
@@ -0,0 +1,91 @@
+/*
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Non-owning view into a character buffer (not necessarily NUL terminated).
+  Used to parse protocol messages in place, without copying them to heap Strings.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+
+struct TextView {
+  const char *data;
+  size_t length;
+
+  bool empty() const { return length == 0; }
+  char charAt(const size_t index) const { return (index < length) ? data[index] : '\0'; }
+
+  TextView substring(size_t start) const
+  {
+    if (start > length) start = length;
+    return TextView{data + start, length - start};
+  }
+  TextView substring(size_t start, size_t end) const
+  {
+    if (end > length) end = length;
+    if (start > end) start = end;
+    return TextView{data + start, end - start};
+  }
+
+  int indexOf(const char c, const size_t from = 0) const
+  {
+    for (size_t i=from;i<length;++i)
+      if (data[i]==c) return i;
+    return -1;
+  }
+
+  bool equals_P(PGM_P text) const
+  {
+    return (strlen_P(text) == length) && (strncmp_P(data, text, length) == 0);
+  }
+
+  bool startsWith_P(PGM_P text) const
+  {
+    const size_t text_length = strlen_P(text);
+    return (text_length <= length) && (strncmp_P(data, text, text_length) == 0);
+  }
+
+  // same semantics as String::toInt(), leading whitespace and trailing garbage are ignored
+  long toInt() const
+  {
+    size_t i = 0;
+    while (i<length && isspace(data[i])) ++i;
+
+    bool negative = false;
+    if (i<length && (data[i]=='-' || data[i]=='+'))
+      negative = (data[i++]=='-');
+
+    long value = 0;
+    for (;i<length && isdigit(data[i]);++i)
+      value = value*10 + (data[i]-'0');
+    return negative ? -value : value;
+  }
+
+  // allocates, only for handlers that need to keep the data
+  String toString() const
+  {
+    String s;
+    s.reserve(length);
+    for (size_t i=0;i<length;++i)
+      s += data[i];
+    return s;
+  }
+};
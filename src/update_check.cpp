@@ -0,0 +1,133 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "update_check.hpp"
+#include "utils.hpp"
+
+void UpdateCheck::start(const String& update_url)
+{
+  m_started_at = millis();
+  m_cached = false;
+  m_status_line = "";
+
+  if (update_url.length() < 3) {
+    DEBUG_SERIAL.println(F("[Update] Update url empty, skipping check"));
+    finish(Firmware::Check::NO_UPDATE);
+    return;
+  }
+
+  const String url = Firmware::getUrl(update_url);
+  m_key = Utils::fnv1a((const uint8_t*) url.c_str(), url.length());
+
+  RTCCache cache;
+  if (readCache(cache) && (Firmware::Check) cache.result == Firmware::Check::NO_UPDATE && cache.boots < c_cache_boots) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] No update (cached, checked %u boots ago)\n"), cache.boots + 1);
+    writeCache(Firmware::Check::NO_UPDATE, cache.boots + 1);
+    m_cached = true;
+    finish(Firmware::Check::NO_UPDATE);
+    return;
+  }
+
+  String protocol;
+  Utils::parseURL(url, m_host, m_port, m_path, protocol);
+  m_state = State::CONNECTING;
+}
+
+bool UpdateCheck::loop()
+{
+  switch (m_state) {
+    case State::CONNECTING:
+      connect();
+      break;
+    case State::WAITING:
+      readStatus();
+      break;
+    case State::IDLE:
+    case State::DONE:
+      break;
+  }
+  return m_state == State::DONE;
+}
+
+void UpdateCheck::connect()
+{
+  /* the only blocking step: the DNS lookup and TCP handshake stall the main loop, for up to
+     the SDK's own timeouts (several seconds) if the server is unreachable. The network task
+     isn't serviced meanwhile, only the background tasks (display) keep running. */
+  if (!m_client.connect(m_host.c_str(), m_port)) {
+    DEBUG_SERIAL.printf_P(PSTR("[Update] Can't connect to %s:%d\n"), m_host.c_str(), m_port);
+    finish(Firmware::Check::FAILED);
+    return;
+  }
+
+  // only the status is needed, the image is downloaded by Firmware::update()
+  String request = "HEAD " + m_path + " HTTP/1.1\r\nHost: " + m_host + "\r\n";
+  request += F("User-Agent: ESP8266-http-Update\r\nConnection: close\r\n");
+  Firmware::forEachRequestHeader([&request](const String& name, const String& value) {
+    request += name + ": " + value + "\r\n";
+  });
+  request += "\r\n";
+  m_client.print(request);
+  m_state = State::WAITING;
+}
+
+void UpdateCheck::readStatus()
+{
+  while (m_client.available()) {
+    const char c = m_client.read();
+    if (c == '\n') {
+      // "HTTP/1.1 304 Not Modified"
+      const int space = m_status_line.indexOf(' ');
+      const int code = (space == -1 ? 0 : m_status_line.substring(space + 1).toInt());
+      DEBUG_SERIAL.printf_P(PSTR("[Update] Check result: %d\n"), code);
+      finish(code == 200 ? Firmware::Check::AVAILABLE :
+        code == 304 ? Firmware::Check::NO_UPDATE : Firmware::Check::FAILED);
+      return;
+    }
+    if (c != '\r' && m_status_line.length() < 64)
+      m_status_line += c;
+  }
+
+  if (!m_client.connected() || millis() - m_started_at > c_timeout_ms) {
+    DEBUG_SERIAL.println(F("[Update] No response from update server"));
+    finish(Firmware::Check::FAILED);
+  }
+}
+
+void UpdateCheck::finish(const Firmware::Check result)
+{
+  m_client.stop();
+  m_result = result;
+  m_state = State::DONE;
+  m_duration_ms = millis() - m_started_at;
+  if (!m_cached && m_key != 0)
+    writeCache(result, 0);
+}
+
+bool UpdateCheck::readCache(RTCCache& cache)
+{
+  return ESP.rtcUserMemoryRead(c_rtc_offset, (uint32_t*) &cache, sizeof(cache)) &&
+    cache.magic == c_cache_magic && cache.key == m_key;
+}
+
+void UpdateCheck::writeCache(const Firmware::Check result, const uint8_t boots)
+{
+  // only "no update" is worth remembering, anything else is asked again on the next boot
+  RTCCache cache = { result == Firmware::Check::NO_UPDATE ? c_cache_magic : 0, m_key, (uint8_t) result, boots, 0 };
+  ESP.rtcUserMemoryWrite(c_rtc_offset, (uint32_t*) &cache, sizeof(cache));
+}
@@ -0,0 +1,81 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*
+  Background firmware update check. Sends the request ESPhttpUpdate would send, as HEAD, and reads
+  only the status line (304 = current, 200 = image available), one short step per loop() call, so
+  the ticker keeps running. A "no update" result is cached in RTC memory for a few reboots,
+  so restarts (e.g. forced reconnects) don't ask the server every time.
+*/
+
+#pragma once
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "firmware.hpp"
+
+class UpdateCheck
+{
+public:
+  enum class State : uint8_t { IDLE, CONNECTING, WAITING, DONE };
+
+  UpdateCheck() : m_state(State::IDLE), m_port(0), m_started_at(0), m_duration_ms(0),
+    m_result(Firmware::Check::FAILED), m_cached(false), m_key(0)
+  {}
+
+  // starts a check, finishes right away if the result is cached
+  void start(const String& update_url);
+  // advances the check, returns true when it is done
+  bool loop();
+
+  State getState() { return m_state; }
+  Firmware::Check getResult() { return m_result; }
+  bool isCached() { return m_cached; }
+  uint32_t getDuration() { return m_duration_ms; }
+private:
+  struct RTCCache {
+    uint32_t magic;
+    uint32_t key; // of the sketch and update url
+    uint8_t result;
+    uint8_t boots; // since the server was asked
+    uint16_t reserved;
+  };
+
+  void connect();
+  void readStatus();
+  void finish(const Firmware::Check result);
+  bool readCache(RTCCache& cache);
+  void writeCache(const Firmware::Check result, const uint8_t boots);
+
+  WiFiClient m_client;
+  State m_state;
+  String m_host;
+  int m_port;
+  String m_path;
+  String m_status_line;
+  uint32_t m_started_at; // millis()
+  uint32_t m_duration_ms;
+  Firmware::Check m_result;
+  bool m_cached;
+  uint32_t m_key;
+
+  static const uint32_t c_timeout_ms = 5000;
+  static const uint32_t c_rtc_offset = 32; // in 4 byte blocks, the first 128 bytes are used by OTA
+  static const uint32_t c_cache_magic = 0x4B435055; // "UPCK"
+  static const uint8_t c_cache_boots = 8;
+};
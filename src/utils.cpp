@@ -119,4 +119,28 @@ String shortenText(const String& text, const int lead)
   return (text.substring(0,lead) + ".." + text.substring(text.length()-lead-1,text.length()-1));
 }
 
+// FNV-1a hash, pass previous result as hash to continue
+uint32_t fnv1a(const uint8_t *data, const size_t length, uint32_t hash)
+{
+  for (size_t i=0;i<length;++i)
+    hash = (hash ^ data[i]) * 16777619u;
+  return hash;
+}
+
+// CRC-32 (IEEE 802.3), nibble table to keep the flash footprint small
+uint32_t crc32(const uint8_t *data, const size_t length)
+{
+  static const uint32_t table[16] PROGMEM = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i=0;i<length;++i) {
+    crc = pgm_read_dword(&table[(crc ^ data[i]) & 0x0F]) ^ (crc >> 4);
+    crc = pgm_read_dword(&table[(crc ^ (data[i] >> 4)) & 0x0F]) ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
 }
@@ -36,4 +36,6 @@ void eeprom_Erase(const int offset, const int size);
 void parseURL(String url, String &server, int &port, String& path, String& protocol);
 String urlChangePath(String url, const String& new_path);
 String shortenText(const String& text, const int lead);
+uint32_t fnv1a(const uint8_t *data, const size_t length, uint32_t hash = 2166136261u);
+uint32_t crc32(const uint8_t *data, const size_t length);
 }
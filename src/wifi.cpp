@@ -20,17 +20,18 @@
 #include "parameter_store.hpp"
 #include "wifi.hpp"
 #include "utils.hpp"
+#include "boot_profiler.hpp"
 
 extern ParameterStore g_parameters;
 extern WiFiCore *g_wifi;
 
 WiFiCore::WiFiCore(DisplayT *display) :
-  m_wifimanager(WiFiManager()), m_display(display)
+  m_wifimanager(WiFiManager()), m_display(display), m_ap_callback(nullptr)
 {
   m_wifimanager.setSaveConfigCallback(&saveCallback);
+  m_wifimanager.setAPCallback(&apCallback);
 
   AP_list::addAPsToWiFiManager(&m_wifimanager);
-  addParametersFromGlobal();
 
   m_ev_conn = WiFi.onStationModeConnected(onConnect);
   m_ev_disconn = WiFi.onStationModeDisconnected(onDisconnect);
@@ -39,12 +40,21 @@ WiFiCore::WiFiCore(DisplayT *display) :
 
 void WiFiCore::setAPCallback(void (*func)(WiFiManager*))
 {
-  m_wifimanager.setAPCallback(func);
+  m_ap_callback = func;
+}
+
+void WiFiCore::apCallback(WiFiManager *manager)
+{
+  g_wifi->addParametersFromGlobal();
+  if (g_wifi->m_ap_callback)
+    g_wifi->m_ap_callback(manager);
 }
 
 void WiFiCore::connectToWiFiOrFallbackToAP(void)
 {
-  if (!m_wifimanager.autoConnect()) {
+  const bool connected = m_wifimanager.autoConnect();
+  removeParameters();
+  if (!connected) {
     DEBUG_SERIAL.println(F("[WiFiCore] Failed to connect and hit timeout"));
     //reset and try again, or maybe put it to deep sleep
     ESP.reset();
@@ -54,22 +64,38 @@ void WiFiCore::connectToWiFiOrFallbackToAP(void)
 
 void WiFiCore::addParametersFromGlobal()
 {
-  m_parameters.clear();
-  m_parameters.reserve(g_parameters.all_items().size());
+  removeParameters();
+  m_parameters.reserve(g_parameters.size());
+  m_parameter_texts.reserve(g_parameters.size() * 2); // WiFiManagerParameter keeps pointers to id and placeholder
 
   g_parameters.iterateAllParameters([this](const ParameterItem* item) {
-    if (!item->name.startsWith("__")) {// reserved parameter, don't display
-      auto *wifi_param = new WiFiManagerParameter(item->name.c_str(), item->description.c_str(), item->value.c_str(), item->field_length);
+    if (!item->isReserved()) {// reserved parameter, don't display
+      m_parameter_texts.push_back(item->getName());
+      const char *id = m_parameter_texts.back().c_str();
+      m_parameter_texts.push_back(item->getDescription());
+      const char *description = m_parameter_texts.back().c_str();
+      auto *wifi_param = new WiFiManagerParameter(id, description, item->value.c_str(), item->getFieldLength());
       m_parameters.push_back(wifi_param);
       m_wifimanager.addParameter(wifi_param);
     }
   });
 }
 
+void WiFiCore::removeParameters()
+{
+  m_wifimanager.removeParameters();
+  for (auto *wifi_param : m_parameters)
+    delete wifi_param;
+  std::vector<WiFiManagerParameter*>().swap(m_parameters);
+  std::vector<String>().swap(m_parameter_texts);
+}
+
 void WiFiCore::startAP(const String& ssid_name, unsigned long timeout)
 {
   m_wifimanager.setTimeout(timeout);
-  if (!m_wifimanager.startConfigPortal(ssid_name.c_str())) {
+  const bool connected = m_wifimanager.startConfigPortal(ssid_name.c_str());
+  removeParameters();
+  if (!connected) {
     DEBUG_SERIAL.println(F("[WiFiCore] Failed to start AP and hit timeout"));
     delay(3000);
     ESP.reset();
@@ -89,9 +115,7 @@ void WiFiCore::updateParametersFromAP(WiFiManager *manager)
   for (auto *wifi_param : m_parameters) {
     String id = wifi_param->getID();
     String new_value = wifi_param->getValue();
-    auto *param = g_parameters.findByName(id);
-    if (param)
-      param->value = new_value;
+    g_parameters.setValue(id, new_value);
   }
 }
 
@@ -106,15 +130,16 @@ void WiFiCore::saveCallback(void)
 
   // save parameters
   g_wifi->updateParametersFromAP(manager);
-  g_parameters.storeToEEPROMwithoutInit();
-
   Utils::eeprom_END();
+
+  g_parameters.store();
 }
 
 void WiFiCore::onConnect(WiFiEventStationModeConnected event_info)
 {
   DEBUG_SERIAL.printf_P(PSTR("[WiFiCore] Connected to SSID: %s channel %i\n"),
     event_info.ssid.c_str(), event_info.channel);
+  g_boot_profiler.mark(BootProfiler::Stage::WIFI_ASSOCIATED);
 }
 
 void WiFiCore::onDisconnect(WiFiEventStationModeDisconnected event_info)
@@ -128,4 +153,5 @@ void WiFiCore::onGotIP(WiFiEventStationModeGotIP ipInfo)
   DEBUG_SERIAL.printf_P(PSTR("[WiFiCore] Got IP: %s Gateway: %s, Mask: %s\n"),
     ipInfo.ip.toString().c_str(), ipInfo.gw.toString().c_str(), ipInfo.mask.toString().c_str()
   );
+  g_boot_profiler.mark(BootProfiler::Stage::WIFI_GOT_IP);
 }
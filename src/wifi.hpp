@@ -33,13 +33,14 @@ class WiFiCore
 public:
   WiFiCore(DisplayT *display);
 
-  void setAPCallback(void (*func)(WiFiManager*));
+  void setAPCallback(void (*func)(WiFiManager*)); // called when the config portal opens
   void startAP(const String& ssid_name, unsigned long timeout = 120);
   void connectToWiFiOrFallbackToAP(void);
   void resetSettings(void);
 
   WiFiManager* getWiFiManager(void) { return &m_wifimanager; }
 
+  static void apCallback(WiFiManager *manager);
   static void saveCallback(void);
   static void onConnect(WiFiEventStationModeConnected event_info);
   static void onDisconnect(WiFiEventStationModeDisconnected event_info);
@@ -47,11 +48,15 @@ public:
 
   void updateParametersFromAP(WiFiManager *manager); // reads parameters from AP config page and updates g_parameters
 private:
+  // the portal fields exist only while the portal is open
   void addParametersFromGlobal();
+  void removeParameters();
 
   WiFiManager m_wifimanager;
   DisplayT *m_display;
   std::vector<WiFiManagerParameter*> m_parameters;
+  std::vector<String> m_parameter_texts; // names and descriptions of m_parameters, copied from PROGMEM
+  void (*m_ap_callback)(WiFiManager*);
 
   WiFiEventHandler m_ev_conn, m_ev_disconn, m_ev_gotip;
 };
@@ -0,0 +1,252 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Tests of applying delta patches against the running sketch, with the patch pushed in chunks
+  of any size, through DeltaPatch alone and through FirmwareWriter as the update does.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <Updater.h>
+#include <MD5Builder.h>
+#include <vector>
+#include "native.hpp"
+#include "delta_patch.hpp"
+#include "firmware_writer.hpp"
+#include "device_identity.hpp"
+
+namespace {
+typedef std::vector<uint8_t> Bytes;
+
+// same generator as in the script the fixture was made with
+Bytes image(const size_t size, uint32_t seed)
+{
+  Bytes data;
+  for (size_t i=0;i<size;++i) {
+    seed = seed * 1103515245 + 12345;
+    data.push_back((seed >> 16) & 0xFF);
+  }
+  return data;
+}
+
+const size_t c_old_size = 6000;
+
+/* made by tools/make_patch.py from image(6000, 1), changed by: 50 bytes at 1001 replaced with
+   image(50, 2), image(21, 3) inserted at 3002, then the first 100 bytes moved to the end */
+const uint8_t c_tool_patch[] = {
+  0x43, 0x43, 0x44, 0x50, 0x01, 0x00, 0x00, 0x00, 0x70, 0x17, 0x00, 0x00, 0x85, 0x17, 0x00, 0x00,
+  0x42, 0x8c, 0x76, 0x1a, 0xe0, 0x22, 0xdf, 0x42, 0xf5, 0x27, 0x79, 0x10, 0xd6, 0xeb, 0x0f, 0xb6,
+  0x01, 0x64, 0x00, 0x00, 0x00, 0x85, 0x03, 0x00, 0x00, 0x02, 0x32, 0x00, 0x00, 0x00, 0x8c, 0x21,
+  0xff, 0x72, 0xed, 0xd7, 0x18, 0xd9, 0x4e, 0x13, 0x95, 0x13, 0xdc, 0x1b, 0x63, 0xfc, 0x93, 0x06,
+  0xf6, 0xbf, 0x9c, 0xe5, 0x06, 0xe0, 0x6d, 0xb0, 0x0a, 0x05, 0x9f, 0xf2, 0x75, 0x87, 0x8e, 0x34,
+  0xb3, 0xbc, 0xb3, 0x2b, 0xe2, 0x02, 0xc0, 0xa1, 0x51, 0x8c, 0x80, 0x23, 0xb9, 0xec, 0x6d, 0x6f,
+  0x01, 0x1b, 0x04, 0x00, 0x00, 0x9f, 0x07, 0x00, 0x00, 0x02, 0x15, 0x00, 0x00, 0x00, 0x53, 0xc3,
+  0x7d, 0x78, 0x8e, 0xb4, 0x4d, 0xb7, 0x48, 0x2f, 0x6d, 0x46, 0x3d, 0x19, 0xe5, 0x70, 0x24, 0x4c,
+  0xbb, 0xa0, 0xe3, 0x01, 0xba, 0x0b, 0x00, 0x00, 0xb6, 0x0b, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+  0x00, 0x64, 0x00, 0x00, 0x00, 0x00,
+};
+
+Bytes toolPatchResult()
+{
+  const Bytes old = image(c_old_size, 1);
+  Bytes changed(old);
+  const Bytes replaced = image(50, 2);
+  std::copy(replaced.begin(), replaced.end(), changed.begin() + 1001);
+  const Bytes inserted = image(21, 3);
+  changed.insert(changed.begin() + 3002, inserted.begin(), inserted.end());
+
+  Bytes result(changed.begin() + 100, changed.end());
+  result.insert(result.end(), changed.begin(), changed.begin() + 100);
+  return result;
+}
+
+void putU32(Bytes& data, const uint32_t value)
+{
+  for (int i=0;i<4;++i)
+    data.push_back(value >> (i*8));
+}
+
+// patches for the error cases
+class PatchBuilder
+{
+public:
+  PatchBuilder(const Bytes& result, const uint32_t old_size = c_old_size)
+  {
+    const char magic[] = "CCDP";
+    m_data.assign(magic, magic + 4);
+    m_data.push_back(1);
+    m_data.resize(8, 0);
+    putU32(m_data, old_size);
+    putU32(m_data, result.size());
+    MD5Builder md5;
+    md5.begin();
+    md5.add(result.data(), result.size());
+    md5.calculate();
+    uint8_t digest[16];
+    md5.getBytes(digest);
+    m_data.insert(m_data.end(), digest, digest + 16);
+  }
+
+  PatchBuilder& copy(const uint32_t offset, const uint32_t length)
+  {
+    m_data.push_back(0x01);
+    putU32(m_data, offset);
+    putU32(m_data, length);
+    return *this;
+  }
+
+  PatchBuilder& insert(const Bytes& data)
+  {
+    m_data.push_back(0x02);
+    putU32(m_data, data.size());
+    m_data.insert(m_data.end(), data.begin(), data.end());
+    return *this;
+  }
+
+  Bytes end()
+  {
+    m_data.push_back(0x00);
+    return m_data;
+  }
+private:
+  Bytes m_data;
+};
+
+bool apply(const Bytes& patch, const size_t chunk)
+{
+  DeltaPatch delta;
+  for (size_t offset=0;offset<patch.size();offset+=chunk) {
+    if (!delta.write(patch.data() + offset, std::min(chunk, patch.size() - offset))) {
+      Update.end(); // resets the updater
+      return false;
+    }
+  }
+  return delta.isFinished() && Update.end();
+}
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_tool_patch_applies(void)
+{
+  const Bytes patch(c_tool_patch, c_tool_patch + sizeof(c_tool_patch));
+  const Bytes expected = toolPatchResult();
+  const size_t chunks[] = {1, 3, 7, 32, 33, 4096};
+  for (const size_t chunk : chunks) {
+    TEST_ASSERT_TRUE(apply(patch, chunk));
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), Update.getImage().size());
+    TEST_ASSERT_TRUE(Update.getImage() == expected);
+  }
+}
+
+void test_unaligned_copies(void)
+{
+  const Bytes old = image(c_old_size, 1);
+  Bytes expected(old.begin() + 1, old.begin() + 600); // crosses the 256 byte copy chunks
+  expected.insert(expected.end(), old.begin() + 4093, old.begin() + 4103);
+  expected.push_back(0x42);
+  expected.insert(expected.end(), old.end() - 3, old.end());
+
+  const Bytes patch = PatchBuilder(expected).copy(1, 599).copy(4093, 10).insert(Bytes(1, 0x42)).copy(c_old_size - 3, 3).end();
+  TEST_ASSERT_TRUE(apply(patch, 5));
+  TEST_ASSERT_TRUE(Update.getImage() == expected);
+}
+
+void test_md5_mismatch_fails(void)
+{
+  const Bytes expected = image(100, 4);
+  Bytes patch = PatchBuilder(expected).insert(expected).end();
+  patch[16] ^= 1; // MD5 in the header
+  TEST_ASSERT_FALSE(apply(patch, 64));
+  TEST_ASSERT_EQUAL_UINT8(UPDATE_ERROR_MD5, Update.getError());
+
+  const Bytes wrong = image(100, 5);
+  TEST_ASSERT_FALSE(apply(PatchBuilder(expected).insert(wrong).end(), 64));
+}
+
+void test_invalid_patches_fail(void)
+{
+  const Bytes expected = image(16, 6);
+  // for another sketch
+  TEST_ASSERT_FALSE(apply(PatchBuilder(expected, c_old_size + 4).insert(expected).end(), 64));
+  // copy past the end of the sketch
+  TEST_ASSERT_FALSE(apply(PatchBuilder(expected).copy(c_old_size - 8, 16).end(), 64));
+  // longer than announced
+  TEST_ASSERT_FALSE(apply(PatchBuilder(expected).insert(expected).insert(expected).end(), 64));
+
+  Bytes patch = PatchBuilder(expected).insert(expected).end();
+  patch.back() = 0x07; // unknown op
+  TEST_ASSERT_FALSE(apply(patch, 64));
+
+  patch.back() = 0x00;
+  patch.push_back(0x00); // data after end
+  TEST_ASSERT_FALSE(apply(patch, 64));
+
+  patch = PatchBuilder(expected).insert(expected).end();
+  patch[0] = 'X';
+  TEST_ASSERT_FALSE(apply(patch, 64));
+}
+
+void test_firmware_writer_resumes_a_patch(void)
+{
+  const Bytes patch(c_tool_patch, c_tool_patch + sizeof(c_tool_patch));
+  FirmwareWriter writer;
+  TEST_ASSERT_TRUE(writer.begin(patch.size(), "", true));
+  TEST_ASSERT_TRUE(writer.write(patch.data(), 40));
+
+  TEST_ASSERT_TRUE(writer.begin(patch.size(), "", true)); // same transfer, kept
+  TEST_ASSERT_EQUAL_UINT32(40, writer.getReceived());
+  TEST_ASSERT_TRUE(writer.write(patch.data() + 40, patch.size() - 40));
+  TEST_ASSERT_TRUE(writer.finish());
+  TEST_ASSERT_TRUE(Update.getImage() == toolPatchResult());
+}
+
+void test_firmware_writer_rejects_an_incomplete_patch(void)
+{
+  const Bytes patch(c_tool_patch, c_tool_patch + sizeof(c_tool_patch));
+  FirmwareWriter writer;
+  TEST_ASSERT_TRUE(writer.begin(patch.size(), "", true));
+  TEST_ASSERT_TRUE(writer.write(patch.data(), patch.size() - 1));
+  TEST_ASSERT_FALSE(writer.finish());
+  TEST_ASSERT_FALSE(Update.isRunning());
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  const Bytes sketch = image(c_old_size, 1);
+  Native::setSketch(sketch.data(), sketch.size());
+
+  UNITY_BEGIN();
+  RUN_TEST(test_tool_patch_applies);
+  RUN_TEST(test_unaligned_copies);
+  RUN_TEST(test_md5_mismatch_fails);
+  RUN_TEST(test_invalid_patches_fail);
+  RUN_TEST(test_firmware_writer_resumes_a_patch);
+  RUN_TEST(test_firmware_writer_rejects_an_incomplete_patch);
+  return UNITY_END();
+}
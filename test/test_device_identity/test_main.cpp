@@ -0,0 +1,134 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Tests of the device identity cache: values match what the core reports at first use and are
+  then served from RAM, even if flash or the parameters change until the next boot.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <MD5Builder.h>
+#include <vector>
+#include "native.hpp"
+#include "setup.hpp"
+#include "native_benchmark.hpp"
+#include "device_identity.hpp"
+#include "parameter_store.hpp"
+
+extern ParameterStore g_parameters;
+
+namespace {
+std::vector<uint8_t> sketch(const size_t size, const uint8_t seed)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i=0;i<size;++i)
+    data[i] = (i * 31 + seed) & 0xFF;
+  return data;
+}
+
+String md5(const std::vector<uint8_t>& data)
+{
+  MD5Builder builder;
+  builder.begin();
+  for (size_t offset=0;offset<data.size();offset+=0x8000) // add() takes 16 bit lengths
+    builder.add(data.data() + offset, std::min(data.size() - offset, (size_t) 0x8000));
+  builder.calculate();
+  return builder.toString();
+}
+
+String g_sink;
+}
+
+void setUp(void)
+{
+  Native::eraseFlash();
+}
+
+void tearDown(void)
+{
+}
+
+void test_sketch_md5_is_computed_once(void)
+{
+  const std::vector<uint8_t> running = sketch(10000, 1);
+  Native::setSketch(running.data(), running.size());
+
+  DeviceIdentity identity;
+  TEST_ASSERT_EQUAL_STRING(md5(running).c_str(), identity.getSketchMD5().c_str());
+  TEST_ASSERT_EQUAL_UINT32(running.size(), identity.getSketchSize());
+
+  // flash changes under it (which only an update does, and that restarts), the cache stays
+  const std::vector<uint8_t> other = sketch(12000, 2);
+  Native::setSketch(other.data(), other.size());
+  TEST_ASSERT_EQUAL_STRING(md5(other).c_str(), ESP.getSketchMD5().c_str());
+  TEST_ASSERT_EQUAL_STRING(md5(running).c_str(), identity.getSketchMD5().c_str());
+  TEST_ASSERT_EQUAL_UINT32(running.size(), identity.getSketchSize());
+
+  // and a new boot computes it again
+  DeviceIdentity rebooted;
+  TEST_ASSERT_EQUAL_STRING(md5(other).c_str(), rebooted.getSketchMD5().c_str());
+}
+
+void test_chip_values_match_the_core(void)
+{
+  DeviceIdentity identity;
+  TEST_ASSERT_EQUAL_UINT32(ESP.getChipId(), identity.getChipId());
+  TEST_ASSERT_EQUAL_STRING(ESP.getSdkVersion(), identity.getSdkVersion());
+  TEST_ASSERT_TRUE(identity.getSdkVersion() == identity.getSdkVersion());
+}
+
+void test_uuid_is_read_once_from_the_parameters(void)
+{
+  g_parameters.setValue(ParameterId::DEVICE_UUID, "6f1c2a10-0000-4000-8000-000000000001");
+  DeviceIdentity identity;
+  TEST_ASSERT_EQUAL_STRING("6f1c2a10-0000-4000-8000-000000000001", identity.getUUID().c_str());
+
+  g_parameters.setValue(ParameterId::DEVICE_UUID, "6f1c2a10-0000-4000-8000-000000000002");
+  TEST_ASSERT_EQUAL_STRING("6f1c2a10-0000-4000-8000-000000000001", identity.getUUID().c_str());
+}
+
+void test_benchmark_sketch_md5(void)
+{
+  const std::vector<uint8_t> running = sketch(400000, 3); // size of a release build
+  Native::setSketch(running.data(), running.size());
+  DeviceIdentity identity;
+
+  NativeBenchmark::measure("sketch MD5, ESP.getSketchMD5()", [&]() {
+    g_sink = ESP.getSketchMD5();
+  });
+  NativeBenchmark::measure("sketch MD5, cached", [&]() {
+    g_sink = identity.getSketchMD5();
+  });
+  TEST_ASSERT_EQUAL_STRING(md5(running).c_str(), g_sink.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setupParameters();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_sketch_md5_is_computed_once);
+  RUN_TEST(test_chip_values_match_the_core);
+  RUN_TEST(test_uuid_is_read_once_from_the_parameters);
+  RUN_TEST(test_benchmark_sketch_md5);
+  return UNITY_END();
+}
@@ -0,0 +1,305 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Protocol dispatch (DataSource::textCallback): commands and prices are routed to the right
+  callbacks with views into the received frame, without heap allocations; benchmarked against
+  the startsWith() chain with String arguments that the dispatcher replaced.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include "native.hpp"
+#include "native_benchmark.hpp"
+#include "setup.hpp"
+#include "data_source.hpp"
+#include "alloc_counter.hpp"
+
+extern DataSource *g_data_source;
+extern ParameterStore g_parameters;
+
+namespace {
+struct Received {
+  std::string price;
+  const char *price_data;
+  std::string ath;
+  std::string announcement;
+  bool announcement_static;
+  int announcement_time;
+  std::string otp;
+  std::string timeout;
+  int updates;
+  int otp_acks;
+  int new_settings;
+  int calls;
+};
+Received g_received;
+char g_frame[128]; // the received frame, as the websocket library passes it
+
+std::string str(const TextView& view)
+{
+  return std::string(view.data, view.length);
+}
+
+void receive(const char *text)
+{
+  strncpy(g_frame, text, sizeof(g_frame) - 1);
+  DataSource::s_callback(WStype_TEXT, (uint8_t*) g_frame, strlen(g_frame));
+}
+
+bool insideFrame(const char *data)
+{
+  return data >= g_frame && data < g_frame + sizeof(g_frame);
+}
+
+void setCallbacks(DataSource *source)
+{
+  source->setOnPriceChange([](const TextView& price) {
+    g_received.price = str(price);
+    g_received.price_data = price.data;
+    ++g_received.calls;
+  });
+  source->setOnPriceATH([](const TextView& ath) { g_received.ath = str(ath); ++g_received.calls; });
+  source->setOnAnnouncement([](const TextView& text, const bool is_static, const int display_time) {
+    g_received.announcement = str(text);
+    g_received.announcement_static = is_static;
+    g_received.announcement_time = display_time;
+    ++g_received.calls;
+  });
+  source->setOnOTP([](const TextView& otp) { g_received.otp = str(otp); ++g_received.calls; });
+  source->setOnOTPack([]() { ++g_received.otp_acks; ++g_received.calls; });
+  source->setOnPriceTimeoutSet([](const TextView& timeout) { g_received.timeout = str(timeout); ++g_received.calls; });
+  source->setOnUpdateRequest([]() { ++g_received.updates; ++g_received.calls; });
+  source->setOnNewSettings([]() { ++g_received.new_settings; ++g_received.calls; });
+}
+
+/* The startsWith() chain of the old textCallback, which took the frame copied into a String
+   and passed the arguments as substrings. Reference for the benchmark only: the arguments
+   are handed to the same kind of callbacks, but the commands don't act. */
+volatile size_t g_sink;
+
+void legacyArgument(const String& argument)
+{
+  g_sink = argument.length();
+}
+
+void legacyTextCallback(const String& str)
+{
+  if (str=="") return;
+  if (str==";UPDATE") {
+    g_sink = 0;
+  } else if (str.startsWith(";RESET")) {
+    g_sink = 0;
+  } else if (str.startsWith(";ATH=")) {
+    legacyArgument(str.substring(5));
+  } else if (str.startsWith(";MSG ") || str.startsWith(";MSG=")) {
+    legacyArgument(str.substring(5));
+  } else if (str.startsWith(";STATICMSG ") || str.startsWith(";MSGSTATIC ")) {
+    int time_idx = str.indexOf(' ');
+    if (time_idx==-1)
+      return;
+    int msg_idx = str.indexOf(' ', time_idx+1);
+    if (msg_idx==-1)
+      return;
+    g_sink = str.substring(time_idx+1).toInt();
+    legacyArgument(str.substring(msg_idx+1));
+  } else if (str.startsWith(";PARAM ")) {
+    String pair = str.substring(7);
+    int index = pair.indexOf(" ");
+    legacyArgument(pair.substring(0,index));
+    legacyArgument(pair.substring(index+1));
+  } else if (str.startsWith(";OTP ")||str.startsWith(";OTP=")) {
+    legacyArgument(str.substring(5));
+  } else if (str.startsWith(";OTP_ACK")) {
+    g_sink = 0;
+  } else if (str.startsWith(";DATA_TIMEOUT")) {
+    legacyArgument(str.substring(13));
+  } else if (str.startsWith(";GET_PARAMS")) {
+    g_sink = 0;
+  } else if (str.startsWith(";NEW_SETTINGS_LOADED")) {
+    g_sink = 0;
+  } else if (str.startsWith(";HB")) {
+    g_sink = 0;
+  } else if (str.startsWith("; Welcome")) {
+    g_sink = 0;
+  } else if (str.startsWith(";")){
+    g_sink = 0;
+  } else if (isdigit(str.charAt(0)) || (str.charAt(0)=='-' && isdigit(str.charAt(1)))) {
+    legacyArgument(str);
+  }
+}
+
+void legacyReceive(const char *text)
+{
+  legacyTextCallback(String(text));
+}
+
+const char *c_mixed_stream[] = {
+  "6543.21", "6543.22", "6543.19", ";HB", "6543.25", ";ATH=11775.0", "6543.30",
+  ";MSG Bitcoin is up", "6543.31", "; Welcome to the ticker", "6543.28", ";DATA_TIMEOUT 300",
+};
+const size_t c_mixed_stream_length = sizeof(c_mixed_stream) / sizeof(c_mixed_stream[0]);
+}
+
+void setUp(void)
+{
+  g_received = Received();
+  g_received.announcement_time = -1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_price_is_passed_as_view_into_frame(void)
+{
+  receive("6543.21");
+  TEST_ASSERT_EQUAL_STRING("6543.21", g_received.price.c_str());
+  TEST_ASSERT_TRUE(insideFrame(g_received.price_data));
+
+  receive("-0.5");
+  TEST_ASSERT_EQUAL_STRING("-0.5", g_received.price.c_str());
+}
+
+void test_non_numeric_text_is_ignored(void)
+{
+  receive("hello");
+  receive("-x");
+  receive("");
+  TEST_ASSERT_EQUAL(0, g_received.calls);
+}
+
+void test_arguments_follow_space_or_equals(void)
+{
+  receive(";ATH=11775.0");
+  TEST_ASSERT_EQUAL_STRING("11775.0", g_received.ath.c_str());
+  receive(";ATH 11776.5");
+  TEST_ASSERT_EQUAL_STRING("11776.5", g_received.ath.c_str());
+  receive(";OTP=123456");
+  TEST_ASSERT_EQUAL_STRING("123456", g_received.otp.c_str());
+  receive(";DATA_TIMEOUT 300");
+  TEST_ASSERT_EQUAL_STRING("300", g_received.timeout.c_str());
+}
+
+void test_announcements(void)
+{
+  receive(";MSG Bitcoin is up");
+  TEST_ASSERT_EQUAL_STRING("Bitcoin is up", g_received.announcement.c_str());
+  TEST_ASSERT_FALSE(g_received.announcement_static);
+
+  receive(";STATICMSG 15 Static text");
+  TEST_ASSERT_EQUAL_STRING("Static text", g_received.announcement.c_str());
+  TEST_ASSERT_TRUE(g_received.announcement_static);
+  TEST_ASSERT_EQUAL(15, g_received.announcement_time);
+
+  receive(";MSGSTATIC=7 Other");
+  TEST_ASSERT_EQUAL_STRING("Other", g_received.announcement.c_str());
+  TEST_ASSERT_EQUAL(7, g_received.announcement_time);
+
+  g_received.calls = 0;
+  receive(";STATICMSG 15"); // no text
+  TEST_ASSERT_EQUAL(0, g_received.calls);
+}
+
+void test_commands_without_arguments(void)
+{
+  receive(";UPDATE");
+  receive(";OTP_ACK");
+  receive(";NEW_SETTINGS_LOADED");
+  TEST_ASSERT_EQUAL(1, g_received.updates);
+  TEST_ASSERT_EQUAL(1, g_received.otp_acks);
+  TEST_ASSERT_EQUAL(1, g_received.new_settings);
+
+  const uint32_t restarts = Native::getRestarts();
+  receive(";RESET");
+  TEST_ASSERT_EQUAL(restarts + 1, Native::getRestarts());
+}
+
+void test_names_must_match_exactly(void)
+{
+  receive(";MSGX text");
+  receive(";OTP_ACKNOWLEDGE");
+  receive(";HBX");
+  receive(";ath=1");
+  receive("; Welcome to the ticker");
+  receive(";");
+  TEST_ASSERT_EQUAL(0, g_received.calls);
+}
+
+void test_parameter_update(void)
+{
+  receive(";PARAM brightness 5");
+  TEST_ASSERT_EQUAL(5, g_parameters.getInt(ParameterId::BRIGHTNESS));
+  receive(";PARAM=brightness 2");
+  TEST_ASSERT_EQUAL(2, g_parameters.getInt(ParameterId::BRIGHTNESS));
+  receive(";PARAM __device_uuid x"); // reserved, not settable by the server
+  TEST_ASSERT_EQUAL_STRING("", g_parameters.getString(ParameterId::DEVICE_UUID).c_str());
+}
+
+void test_dispatch_does_not_allocate(void)
+{
+  const uint32_t allocations = AllocCounter::count();
+  for (size_t i=0;i<c_mixed_stream_length;++i)
+    receive(c_mixed_stream[i]);
+  receive(";STATICMSG 15 Static text");
+  receive(";OTP 123456");
+  receive(";NO_SUCH_COMMAND 1 2 3");
+  TEST_ASSERT_EQUAL(0, AllocCounter::count() - allocations);
+}
+
+void test_benchmark_against_startswith_chain(void)
+{
+  g_data_source->setBenchmarkRunning(true); // no logging of received texts, as in the reference
+  size_t next = 0;
+  const auto table = NativeBenchmark::measure("dispatch table, mixed stream", [&]() {
+    receive(c_mixed_stream[next++ % c_mixed_stream_length]);
+  });
+  next = 0;
+  const auto chain = NativeBenchmark::measure("startsWith chain, mixed stream", [&]() {
+    legacyReceive(c_mixed_stream[next++ % c_mixed_stream_length]);
+  });
+  g_data_source->setBenchmarkRunning(false);
+
+  printf("msgs/s: table %.0f, chain %.0f; bytes allocated/msg: table %.1f, chain %.1f\n",
+    1e9 / table.ns_per_op, 1e9 / chain.ns_per_op, table.bytes_per_op, chain.bytes_per_op);
+  TEST_ASSERT_TRUE(table.allocations_per_op == 0);
+  TEST_ASSERT_TRUE(chain.allocations_per_op >= 1); // the frame copy
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setupParameters();
+  g_data_source = new DataSource;
+  setCallbacks(g_data_source);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_price_is_passed_as_view_into_frame);
+  RUN_TEST(test_non_numeric_text_is_ignored);
+  RUN_TEST(test_arguments_follow_space_or_equals);
+  RUN_TEST(test_announcements);
+  RUN_TEST(test_commands_without_arguments);
+  RUN_TEST(test_names_must_match_exactly);
+  RUN_TEST(test_parameter_update);
+  RUN_TEST(test_dispatch_does_not_allocate);
+  RUN_TEST(test_benchmark_against_startswith_chain);
+  return UNITY_END();
+}
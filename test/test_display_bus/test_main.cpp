@@ -0,0 +1,192 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  What the display sends over its bus, counted on the U8g2 byte callback of the model's
+  32x8 MAX7219 matrix: four daisy chained modules, one transfer per pixel row (digit register)
+  of a command and an argument byte for each module.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <SPI.h>
+#include <memory>
+#include <vector>
+#include "native.hpp"
+#include "setup.hpp"
+#include "display_action_text.hpp"
+
+extern DisplayT *g_display;
+
+using namespace Display;
+using std::make_shared;
+
+namespace {
+const uint32_t c_frame_us = 33000;
+const uint32_t c_rows = 8; // digit registers of a module
+const uint8_t c_max_frames_skipped = 30; // DisplayT::c_max_frames_skipped
+
+class RowsPrint : public Print
+{
+public:
+  size_t write(uint8_t c)
+  {
+    if (c == '\n')
+      m_rows.push_back(String());
+    else if (!m_rows.empty())
+      m_rows.back() += (char) c;
+    else
+      m_rows.push_back(String((char) c));
+    return 1;
+  }
+  std::vector<String> m_rows;
+};
+
+// pixel rows of the buffer, as dumped (without the PBM header)
+std::vector<String> frameRows()
+{
+  RowsPrint rows;
+  g_display->dumpFrame(rows);
+  return std::vector<String>(rows.m_rows.begin() + 2, rows.m_rows.begin() + 2 + c_rows);
+}
+
+uint32_t changedRows(const std::vector<String>& before, const std::vector<String>& after)
+{
+  uint32_t changed = 0;
+  for (size_t row=0;row<before.size();++row)
+    if (before[row] != after[row])
+      ++changed;
+  return changed;
+}
+
+void frame()
+{
+  Native::advanceMicros(c_frame_us);
+  g_display->step(c_frame_us);
+}
+
+std::shared_ptr<ActionT> text(const char *value)
+{
+  return make_shared<Action::StaticText>(value, 100.0);
+}
+
+void resetCounters()
+{
+  Native::getBusCounters() = Native::BusCounters{};
+}
+
+// a command and an argument byte for every module
+uint32_t transferBytes()
+{
+  return g_display->getDisplayWidth() / 8 * 2;
+}
+
+void checkSent(const uint32_t transfers, const uint32_t bytes)
+{
+  TEST_ASSERT_EQUAL_UINT32(transfers, Native::getBusCounters().transfers);
+  TEST_ASSERT_EQUAL_UINT32(bytes, Native::getBusCounters().bytes);
+}
+}
+
+void setUp(void)
+{
+  g_display->cleanQueue();
+  g_display->setRotation(false);
+  g_display->queueAction(text("543.21"));
+  frame(); // sends the whole frame, the next one starts counting skipped frames from zero
+  resetCounters();
+}
+
+void tearDown(void)
+{
+  g_display->cleanQueue();
+}
+
+void test_static_frame_sends_nothing(void)
+{
+  const uint32_t frames_sent = g_display->getFramesSent();
+  for (int i=0;i<10;++i)
+    frame();
+  checkSent(0, 0);
+  TEST_ASSERT_EQUAL_UINT32(frames_sent, g_display->getFramesSent());
+}
+
+void test_changed_digit_sends_changed_rows(void)
+{
+  const std::vector<String> before = frameRows();
+  g_display->replaceAction(text("543.22"));
+  frame();
+  const uint32_t changed = changedRows(before, frameRows());
+  TEST_ASSERT_TRUE(changed > 0);
+  TEST_ASSERT_TRUE(changed < c_rows); // the font leaves the top row empty
+  checkSent(changed, changed * transferBytes());
+
+  resetCounters();
+  frame();
+  checkSent(0, 0);
+}
+
+void test_rotation_resends_whole_frame(void)
+{
+  const uint32_t frames_sent = g_display->getFramesSent();
+  g_display->setRotation(false); // the same rotation, the frame doesn't change
+  frame();
+  checkSent(c_rows, c_rows * transferBytes());
+  TEST_ASSERT_EQUAL_UINT32(frames_sent + 1, g_display->getFramesSent());
+}
+
+void test_skipped_frames_are_resent(void)
+{
+  const uint32_t frames_sent = g_display->getFramesSent();
+  for (int i=0;i<c_max_frames_skipped;++i)
+    frame();
+  checkSent(0, 0);
+  TEST_ASSERT_EQUAL_UINT32(frames_sent, g_display->getFramesSent());
+
+  // the whole frame and the brightness, in case the display lost them
+  frame();
+  checkSent(c_rows + 1, (c_rows + 1) * transferBytes());
+  TEST_ASSERT_EQUAL_UINT32(frames_sent + 1, g_display->getFramesSent());
+
+  // and skipping starts over
+  resetCounters();
+  for (int i=0;i<c_max_frames_skipped;++i)
+    frame();
+  checkSent(0, 0);
+  frame();
+  checkSent(c_rows + 1, (c_rows + 1) * transferBytes());
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setMicros(0);
+  Native::setupParameters();
+  g_display = Native::createDisplay();
+  g_display->setDisplayBrightness(128);
+  Native::countDisplayBus();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_static_frame_sends_nothing);
+  RUN_TEST(test_changed_digit_sends_changed_rows);
+  RUN_TEST(test_rotation_resends_whole_frame);
+  RUN_TEST(test_skipped_frames_are_resent);
+  return UNITY_END();
+}
@@ -0,0 +1,172 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Easing tables: end points, shape against the analytic curves, slide offsets against the
+  sin() based slide function they replaced, and positions of long durations. Benchmarks
+  the table lookup against sin().
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include "native_benchmark.hpp"
+#include "easing.hpp"
+
+using Easing::Curve;
+
+namespace {
+const Curve c_curves[] = {
+  Curve::LINEAR, Curve::EASE_IN, Curve::EASE_OUT, Curve::EASE_IN_OUT, Curve::CUBIC_IN_OUT, Curve::BOUNCE_OUT
+};
+
+double bounceOut(double x)
+{
+  const double n = 7.5625, d = 2.75;
+  if (x < 1 / d)
+    return n * x * x;
+  if (x < 2 / d) {
+    x -= 1.5 / d;
+    return n * x * x + 0.75;
+  }
+  if (x < 2.5 / d) {
+    x -= 2.25 / d;
+    return n * x * x + 0.9375;
+  }
+  x -= 2.625 / d;
+  return n * x * x + 0.984375;
+}
+
+double analytic(const Curve curve, const double x)
+{
+  switch (curve) {
+    case Curve::EASE_IN: return 1 - cos(x * M_PI / 2);
+    case Curve::EASE_OUT: return sin(x * M_PI / 2);
+    case Curve::EASE_IN_OUT: return 0.5 - cos(x * M_PI) / 2;
+    case Curve::CUBIC_IN_OUT: return (x < 0.5) ? 4 * x * x * x : 1 - pow(-2 * x + 2, 3) / 2;
+    case Curve::BOUNCE_OUT: return bounceOut(x);
+    case Curve::LINEAR:
+    default:
+      return x;
+  }
+}
+
+// the slide curve of SlideTransition before the tables
+double slideFunction(double position)
+{
+  double s = 0.5 + sin((position-0.5)*M_PI)*0.5;
+  return std::max(std::min(s,1.0),0.0);
+}
+
+volatile int g_sink;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_curves_start_at_zero_and_end_at_one(void)
+{
+  for (const Curve curve : c_curves) {
+    TEST_ASSERT_EQUAL(0, Easing::value(curve, 0));
+    TEST_ASSERT_EQUAL(Easing::c_one, Easing::value(curve, Easing::c_one));
+    TEST_ASSERT_EQUAL(Easing::c_one, Easing::value(curve, Easing::c_one + 100));
+  }
+}
+
+/* tables are exact at their entries; between them, the interpolation of the smooth curves stays
+   within a few units, while the bounce cusps falling between entries are cut by up to 3% */
+void test_curves_follow_analytic_shape(void)
+{
+  for (const Curve curve : c_curves) {
+    const int tolerance = (curve == Curve::BOUNCE_OUT) ? Easing::c_one / 32 : 4;
+    uint16_t previous = 0;
+    for (int32_t position=0;position<=Easing::c_one;++position) {
+      const uint16_t value = Easing::value(curve, position);
+      const long expected = lround(analytic(curve, (double) position / Easing::c_one) * Easing::c_one);
+      TEST_ASSERT_INT_WITHIN((position % 64 == 0) ? 1 : tolerance, expected, value);
+      TEST_ASSERT_TRUE(value <= Easing::c_one);
+      if (curve != Curve::BOUNCE_OUT)
+        TEST_ASSERT_TRUE(value >= previous); // monotonic
+      previous = value;
+    }
+  }
+}
+
+void test_slide_offsets_match_sin_curve(void)
+{
+  const int distances[] = { 32, -32, 8, -8, 64, 128 };
+  const int32_t durations[] = { 500000, 1000000, 2500000 };
+  for (const int32_t duration : durations) {
+    for (int32_t elapsed=0;elapsed<=duration+33000;elapsed+=33000) {
+      const uint16_t position = Easing::position(elapsed, duration);
+      const double old_position = std::min((double) elapsed / duration, 1.0);
+      for (const int distance : distances) {
+        const int expected = round(slideFunction(old_position) * distance);
+        TEST_ASSERT_INT_WITHIN(1, expected, Easing::scale(Curve::EASE_IN_OUT, position, distance));
+      }
+    }
+  }
+}
+
+void test_scale_is_symmetric_in_direction(void)
+{
+  for (int32_t position=0;position<=Easing::c_one;position+=17)
+    TEST_ASSERT_EQUAL(-Easing::scale(Curve::EASE_OUT, position, 32), Easing::scale(Curve::EASE_OUT, position, -32));
+}
+
+void test_position_of_long_durations(void)
+{
+  TEST_ASSERT_EQUAL(Easing::c_one, Easing::position(10, 0));
+  TEST_ASSERT_EQUAL(Easing::c_one, Easing::position(10, -1));
+  TEST_ASSERT_EQUAL(Easing::c_one, Easing::position(1000, 1000));
+  TEST_ASSERT_EQUAL(Easing::c_one / 2, Easing::position(500000, 1000000));
+  TEST_ASSERT_INT_WITHIN(1, Easing::c_one / 2, Easing::position(INT32_MAX / 2, INT32_MAX));
+  TEST_ASSERT_INT_WITHIN(1, Easing::c_one / 4, Easing::position(INT32_MAX / 4, INT32_MAX));
+}
+
+void test_benchmark_against_sin(void)
+{
+  uint32_t elapsed = 0;
+  NativeBenchmark::measure("slide offset, sin()", [&]() {
+    elapsed = (elapsed + 33000) % 1000000;
+    g_sink = round(slideFunction(elapsed / 1000000.0) * 32);
+  });
+  NativeBenchmark::measure("slide offset, table", [&]() {
+    elapsed = (elapsed + 33000) % 1000000;
+    g_sink = Easing::scale(Curve::EASE_IN_OUT, Easing::position(elapsed, 1000000), 32);
+  });
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_curves_start_at_zero_and_end_at_one);
+  RUN_TEST(test_curves_follow_analytic_shape);
+  RUN_TEST(test_slide_offsets_match_sin_curve);
+  RUN_TEST(test_scale_is_symmetric_in_direction);
+  RUN_TEST(test_position_of_long_durations);
+  RUN_TEST(test_benchmark_against_sin);
+  return UNITY_END();
+}
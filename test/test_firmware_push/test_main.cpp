@@ -0,0 +1,271 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Firmware pushed over the WebSocket (see DataSource::commandFirmwareBegin()): the server's
+  side of the protocol is played through the fake WebSocketsClient, with binary chunks checked
+  by CRC and offset, resumed after a reconnect and abandoned after a stall.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <Updater.h>
+#include <MD5Builder.h>
+#include <vector>
+#include "native.hpp"
+#include "setup.hpp"
+#include "data_source.hpp"
+#include "utils.hpp"
+
+extern DataSource *g_data_source;
+
+namespace {
+typedef std::vector<uint8_t> Bytes;
+
+const size_t c_chunk = 1024;
+
+struct Received {
+  uint32_t progress;
+  int results;
+  bool success;
+};
+Received g_received;
+WebSocketsClient *g_server; // the data source's client, driven as the server
+Bytes g_image;
+String g_md5;
+
+Bytes image(const size_t size, uint32_t seed)
+{
+  Bytes data;
+  for (size_t i=0;i<size;++i) {
+    seed = seed * 1103515245 + 12345;
+    data.push_back((seed >> 16) & 0xFF);
+  }
+  return data;
+}
+
+void putU32(Bytes& data, const uint32_t value)
+{
+  for (int i=0;i<4;++i)
+    data.push_back(value >> (i*8));
+}
+
+// runs the data source for given time, in steps long enough to send one queued text each
+void run(const uint32_t ms = 0)
+{
+  g_data_source->loop();
+  for (uint32_t elapsed=0;elapsed<ms;elapsed+=200) {
+    Native::advanceMicros(200 * 1000);
+    g_data_source->loop();
+  }
+}
+
+void receiveText(const String& text)
+{
+  g_server->receiveText(text);
+  run();
+}
+
+// the image's chunk at given offset, with the CRC32 of data_crc instead of its own data if given
+void receiveChunk(const uint32_t offset, const Bytes *data_crc = nullptr)
+{
+  const size_t length = std::min(c_chunk, g_image.size() - offset);
+  const uint8_t *data = g_image.data() + offset;
+  Bytes frame;
+  putU32(frame, offset);
+  putU32(frame, data_crc ? Utils::crc32(data_crc->data(), data_crc->size()) : Utils::crc32(data, length));
+  frame.insert(frame.end(), data, data + length);
+  g_server->receive(WStype_BIN, frame.data(), frame.size());
+  run();
+}
+
+const String& lastSent()
+{
+  static const String none;
+  return g_server->getSent().empty() ? none : g_server->getSent().back();
+}
+
+bool sent(const String& text)
+{
+  for (const String& item : g_server->getSent())
+    if (item == text)
+      return true;
+  return false;
+}
+
+void connect()
+{
+  g_data_source->connect();
+  run();
+  receiveText("; Welcome");
+  run(5000); // HELLO and parameters, one queued text at a time
+  g_server->getSent().clear();
+}
+
+void begin()
+{
+  receiveText(";FW_BEGIN " + String((uint32_t) g_image.size()) + " " + g_md5 + " 0");
+}
+}
+
+void setUp(void)
+{
+  g_received = Received();
+  Native::setMicros(0);
+  g_data_source = new DataSource;
+  g_data_source->setOnFirmwareProgress([](const uint32_t received, const uint32_t total) {
+    g_received.progress = received;
+  });
+  g_data_source->setOnFirmwareReceived([](const bool success) {
+    ++g_received.results;
+    g_received.success = success;
+  });
+  g_server = WebSocketsClient::getLast();
+  connect();
+}
+
+void tearDown(void)
+{
+  delete g_data_source;
+  g_data_source = nullptr;
+  Update.end(); // resets an unfinished update
+}
+
+void test_begin_arguments(void)
+{
+  receiveText(";FW_BEGIN 3000");
+  receiveText(";FW_BEGIN 0 " + g_md5 + " 0");
+  run(1000);
+  TEST_ASSERT_EQUAL(2, (int) g_server->getSent().size());
+  TEST_ASSERT_EQUAL_STRING(";FW_ERROR arguments", g_server->getSent()[0].c_str());
+  TEST_ASSERT_EQUAL_STRING(";FW_ERROR arguments", g_server->getSent()[1].c_str());
+  TEST_ASSERT_FALSE(g_data_source->isReceivingFirmware());
+
+  receiveText(";FW_BEGIN=3000 " + g_md5 + " 0");
+  TEST_ASSERT_EQUAL_STRING((";FW_READY " + g_md5 + " 0").c_str(), lastSent().c_str());
+  TEST_ASSERT_TRUE(g_data_source->isReceivingFirmware());
+}
+
+void test_transfer_completes(void)
+{
+  begin();
+  for (uint32_t offset=0;offset<g_image.size();offset+=c_chunk) {
+    receiveChunk(offset);
+    if (offset + c_chunk < g_image.size())
+      TEST_ASSERT_EQUAL_STRING((";FW_ACK " + String(offset + c_chunk)).c_str(), lastSent().c_str());
+  }
+  TEST_ASSERT_EQUAL_STRING(";FW_DONE 1", lastSent().c_str());
+  TEST_ASSERT_EQUAL(1, g_received.results);
+  TEST_ASSERT_TRUE(g_received.success);
+  TEST_ASSERT_EQUAL_UINT32(g_image.size(), g_received.progress);
+  TEST_ASSERT_TRUE(Update.getImage() == g_image);
+  TEST_ASSERT_FALSE(g_data_source->isReceivingFirmware());
+}
+
+void test_crc_mismatch_is_nacked(void)
+{
+  begin();
+  receiveChunk(0);
+  const Bytes other = image(c_chunk, 7);
+  receiveChunk(c_chunk, &other);
+  TEST_ASSERT_EQUAL_STRING((";FW_NAK " + String(c_chunk)).c_str(), lastSent().c_str());
+
+  receiveChunk(c_chunk); // resent
+  TEST_ASSERT_EQUAL_STRING((";FW_ACK " + String(2 * c_chunk)).c_str(), lastSent().c_str());
+  TEST_ASSERT_EQUAL(0, g_received.results);
+}
+
+void test_offset_mismatch_is_nacked(void)
+{
+  begin();
+  receiveChunk(c_chunk); // the first chunk was lost
+  TEST_ASSERT_EQUAL_STRING(";FW_NAK 0", lastSent().c_str());
+  receiveChunk(0);
+  receiveChunk(0); // duplicate
+  TEST_ASSERT_EQUAL_STRING((";FW_NAK " + String(c_chunk)).c_str(), lastSent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(c_chunk, g_received.progress);
+  TEST_ASSERT_TRUE(g_data_source->isReceivingFirmware());
+}
+
+void test_resumes_after_reconnect(void)
+{
+  begin();
+  receiveChunk(0);
+  receiveChunk(c_chunk);
+  g_server->dropConnection();
+  run();
+  TEST_ASSERT_FALSE(g_data_source->isConnected());
+  receiveChunk(2 * c_chunk); // lost with the connection
+  TEST_ASSERT_TRUE(g_data_source->isReceivingFirmware());
+
+  g_data_source->reconnect();
+  run();
+  g_server->getSent().clear();
+  receiveText("; Welcome");
+  run(5000);
+  TEST_ASSERT_TRUE(sent(";FW_READY " + g_md5 + " " + String(2 * c_chunk)));
+
+  receiveChunk(2 * c_chunk);
+  TEST_ASSERT_EQUAL_STRING(";FW_DONE 1", lastSent().c_str());
+  TEST_ASSERT_TRUE(g_received.success);
+  TEST_ASSERT_TRUE(Update.getImage() == g_image);
+}
+
+void test_stalled_transfer_is_abandoned(void)
+{
+  begin();
+  receiveChunk(0);
+  run(50 * 1000);
+  receiveChunk(c_chunk); // data keeps the transfer going
+  run(50 * 1000);
+  TEST_ASSERT_TRUE(g_data_source->isReceivingFirmware());
+  TEST_ASSERT_EQUAL(0, g_received.results);
+
+  run(15 * 1000);
+  TEST_ASSERT_FALSE(g_data_source->isReceivingFirmware());
+  TEST_ASSERT_TRUE(sent(";FW_DONE 0"));
+  TEST_ASSERT_EQUAL(1, g_received.results);
+  TEST_ASSERT_FALSE(g_received.success);
+  TEST_ASSERT_FALSE(Update.isRunning());
+
+  begin(); // starts over
+  TEST_ASSERT_EQUAL_STRING((";FW_READY " + g_md5 + " 0").c_str(), lastSent().c_str());
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setupParameters();
+  g_image = image(3 * c_chunk - 100, 1);
+  MD5Builder md5;
+  md5.begin();
+  md5.add(g_image.data(), g_image.size());
+  md5.calculate();
+  g_md5 = md5.toString();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_begin_arguments);
+  RUN_TEST(test_transfer_completes);
+  RUN_TEST(test_crc_mismatch_is_nacked);
+  RUN_TEST(test_offset_mismatch_is_nacked);
+  RUN_TEST(test_resumes_after_reconnect);
+  RUN_TEST(test_stalled_transfer_is_abandoned);
+  return UNITY_END();
+}
@@ -0,0 +1,176 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "frame_font.hpp"
+#include <string.h>
+#include <vector>
+
+namespace FrameFont {
+namespace {
+struct Glyph {
+  char encoding;
+  const char *rows[5]; // '#' is a set pixel, all rows of a glyph have its width
+};
+
+const Glyph c_glyphs[] = { // sorted by encoding
+  {' ', {"", "", "", "", ""}},
+  {'-', {"...", "...", "###", "...", "..."}},
+  {'.', {".", ".", ".", ".", "#"}},
+  {'0', {"###", "#.#", "#.#", "#.#", "###"}},
+  {'1', {".#.", "##.", ".#.", ".#.", "###"}},
+  {'2', {"###", "..#", "###", "#..", "###"}},
+  {'3', {"###", "..#", ".##", "..#", "###"}},
+  {'4', {"#.#", "#.#", "###", "..#", "..#"}},
+  {'5', {"###", "#..", "###", "..#", "###"}},
+  {'6', {"###", "#..", "###", "#.#", "###"}},
+  {'7', {"###", "..#", ".#.", ".#.", ".#."}},
+  {'8', {"###", "#.#", "###", "#.#", "###"}},
+  {'9', {"###", "#.#", "###", "..#", "###"}},
+  {':', {".", "#", ".", "#", "."}},
+  {'A', {".#.", "#.#", "###", "#.#", "#.#"}},
+  {'B', {"##.", "#.#", "##.", "#.#", "##."}},
+  {'C', {".##", "#..", "#..", "#..", ".##"}},
+  {'D', {"##.", "#.#", "#.#", "#.#", "##."}},
+  {'E', {"###", "#..", "##.", "#..", "###"}},
+  {'F', {"###", "#..", "##.", "#..", "#.."}},
+  {'G', {".##", "#..", "#.#", "#.#", ".##"}},
+  {'H', {"#.#", "#.#", "###", "#.#", "#.#"}},
+  {'I', {"###", ".#.", ".#.", ".#.", "###"}},
+  {'J', {"..#", "..#", "..#", "#.#", ".#."}},
+  {'K', {"#.#", "#.#", "##.", "#.#", "#.#"}},
+  {'L', {"#..", "#..", "#..", "#..", "###"}},
+  {'M', {"#.#", "###", "###", "#.#", "#.#"}},
+  {'N', {"##.", "#.#", "#.#", "#.#", "#.#"}},
+  {'O', {".#.", "#.#", "#.#", "#.#", ".#."}},
+  {'P', {"##.", "#.#", "##.", "#..", "#.."}},
+  {'Q', {".#.", "#.#", "#.#", "##.", ".##"}},
+  {'R', {"##.", "#.#", "##.", "#.#", "#.#"}},
+  {'S', {".##", "#..", ".#.", "..#", "##."}},
+  {'T', {"###", ".#.", ".#.", ".#.", ".#."}},
+  {'U', {"#.#", "#.#", "#.#", "#.#", "###"}},
+  {'V', {"#.#", "#.#", "#.#", "#.#", ".#."}},
+  {'W', {"#.#", "#.#", "###", "###", "#.#"}},
+  {'X', {"#.#", "#.#", ".#.", "#.#", "#.#"}},
+  {'Y', {"#.#", "#.#", ".#.", ".#.", ".#."}},
+  {'Z', {"###", "..#", ".#.", "#..", "###"}},
+};
+const uint8_t c_height = 5;
+
+// U8g2 glyph bit stream, least significant bit first
+class BitWriter
+{
+public:
+  BitWriter(std::vector<uint8_t>& out) : m_out(out), m_bits(0) {}
+  void put(const uint8_t value, const uint8_t count)
+  {
+    for (uint8_t i=0;i<count;++i) {
+      if (m_bits % 8 == 0)
+        m_out.push_back(0);
+      if ((value >> i) & 1)
+        m_out.back() |= 1 << (m_bits % 8);
+      ++m_bits;
+    }
+  }
+private:
+  std::vector<uint8_t>& m_out;
+  uint32_t m_bits;
+};
+
+// run length parameters in bits, see u8g2_font.c
+const uint8_t c_bits_per_0 = 4;
+const uint8_t c_bits_per_1 = 4;
+const uint8_t c_bits_per_size = 4;
+const uint8_t c_bits_per_x = 2;
+const uint8_t c_bits_per_y = 4;
+const uint8_t c_bits_per_dx = 4;
+const uint8_t c_max_run = (1 << c_bits_per_0) - 1;
+
+void encodeGlyph(std::vector<uint8_t>& font, const Glyph& glyph)
+{
+  const uint8_t width = (uint8_t) strlen(glyph.rows[0]);
+  const uint8_t height = width ? c_height : 0;
+  std::vector<uint8_t> data;
+  BitWriter bits(data);
+  bits.put(width, c_bits_per_size);
+  bits.put(height, c_bits_per_size);
+  bits.put(0 + (1 << (c_bits_per_x-1)), c_bits_per_x); // x offset, signed
+  bits.put(0 + (1 << (c_bits_per_y-1)), c_bits_per_y); // y offset, glyphs sit on the baseline
+  bits.put(width + 1 + (1 << (c_bits_per_dx-1)), c_bits_per_dx); // advance, one pixel spacing
+
+  // alternating runs of background and foreground pixels, row by row
+  std::vector<bool> pixels;
+  for (uint8_t y=0;y<height;++y)
+    for (uint8_t x=0;x<width;++x)
+      pixels.push_back(glyph.rows[y][x] == '#');
+  size_t i = 0;
+  while (i < pixels.size()) {
+    uint8_t zeros = 0, ones = 0;
+    while (i < pixels.size() && !pixels[i] && zeros < c_max_run) { ++zeros; ++i; }
+    while (i < pixels.size() && pixels[i] && ones < c_max_run) { ++ones; ++i; }
+    bits.put(zeros, c_bits_per_0);
+    bits.put(ones, c_bits_per_1);
+    bits.put(0, 1); // no repetition
+  }
+
+  font.push_back(glyph.encoding);
+  font.push_back(data.size() + 2);
+  font.insert(font.end(), data.begin(), data.end());
+}
+
+std::vector<uint8_t> build()
+{
+  const size_t header_size = 23;
+  std::vector<uint8_t> font = {
+    sizeof(c_glyphs) / sizeof(c_glyphs[0]), 0, c_bits_per_0, c_bits_per_1,
+    c_bits_per_size, c_bits_per_size, c_bits_per_x, c_bits_per_y, c_bits_per_dx,
+    3, c_height, 0, 0, // max width and height, x and y offset
+    c_height, 0, c_height, 0, // ascent of 'A', descent of 'g', ascent of '(', descent of ')'
+    0, 0, 0, 0, 0, 0, // start of 'A', 'a' and of the unicode table
+  };
+
+  size_t upper_start = 0;
+  for (const Glyph& glyph : c_glyphs) {
+    if (glyph.encoding >= 'A' && upper_start == 0)
+      upper_start = font.size() - header_size;
+    encodeGlyph(font, glyph);
+  }
+  const size_t end = font.size() - header_size; // no lower case letters, lookups stop here
+  font.push_back(0);
+  font.push_back(0);
+  font.push_back(0); // unicode table, empty
+  font.push_back(4);
+  font.push_back(0xff);
+  font.push_back(0xff);
+
+  font[17] = upper_start >> 8;
+  font[18] = upper_start & 0xff;
+  font[19] = end >> 8;
+  font[20] = end & 0xff;
+  font[21] = (end + 2) >> 8;
+  font[22] = (end + 2) & 0xff;
+  return font;
+}
+}
+
+const uint8_t* get()
+{
+  static const std::vector<uint8_t> font = build();
+  return font.data();
+}
+}
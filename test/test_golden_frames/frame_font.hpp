@@ -0,0 +1,31 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  3x5 pixel font for the golden frames, built in U8g2's font format at run time, so that the
+  frames depend only on the firmware's rendering and not on the U8g2 font data.
+  Covers ' ', '-', '.', ':', digits and capital letters.
+*/
+
+#pragma once
+#include <stdint.h>
+
+namespace FrameFont {
+const uint8_t* get();
+}
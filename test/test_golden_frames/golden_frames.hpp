@@ -0,0 +1,195 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Recorded frame hashes of the golden frame timelines, see test_main.cpp for how to re-record them.
+*/
+
+#pragma once
+
+const uint32_t c_golden_price[] = {
+  0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0x03d60907, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x03d60907,
+  0xa489b7a4, 0xa489b7a4, 0xef8241ac, 0xef8241ac, 0x5d54aafa, 0x5d54aafa, 0xded15cfa, 0xded15cfa,
+  0x9297e6b6, 0x9297e6b6, 0xe1cb939e, 0x4daabc0c, 0xb4a0b42c, 0xb4a0b42c, 0xf114a964, 0x34ea8250,
+  0xe1ccc1ff, 0x131e7877, 0x1b35a7ab, 0x78914ac1, 0x9314ee11, 0x68e00a55, 0x0774b0c9, 0x792422ed,
+  0x2e71bde1, 0x67d82635, 0xa39a37fb, 0xc3bea4f3, 0x5b6e4887, 0x9de892eb, 0x57238e6e, 0x1fb69689,
+  0x81fef230, 0x77c60a20, 0x3fd38938, 0xa5c6c8c8, 0xa5c6c8c8, 0x67a3361c, 0xe7c6e7c8, 0x68a337af,
+  0xa5c6c8c8, 0xa5c6c8c8, 0x3fd38938, 0x3fd38938, 0x77c60a20, 0x81fef230, 0x1fb69689, 0x57238e6e,
+  0x9de892eb, 0x5b6e4887, 0xc3bea4f3, 0xc6196693, 0x093b3e0e, 0x7fd0d16c, 0xc6f22615, 0xb12436fd,
+  0xdf279989, 0x9314ee11, 0x78914ac1, 0x131e7877, 0x34ea8250, 0xb4a0b42c, 0x9297e6b6, 0xef8241ac,
+  0x02d60774, 0x883c6191, 0x4d2b7d55, 0xf26dac31, 0xf42ed555, 0x337d8abb, 0x6be47cd6, 0xd40950b8,
+  0x593f4430, 0x39340440, 0xf3a26054, 0x0cb2101c, 0x0cb2101c, 0xc37bf6af, 0xdff52524, 0xc27bf51c,
+  0xc37bf6af, 0x0cb2101c, 0xf3a26054, 0x39340440, 0x39340440, 0x593f4430, 0xd40950b8, 0x6be47cd6,
+  0x337d8abb, 0x603e4af5, 0xa21c0cfd, 0xaf7c89c9, 0xc45deca1, 0x9389c6cc, 0xa489b7a4, 0x5d54aafa,
+  0xe1cb939e, 0xf114a964, 0x3feb1eba, 0x1b35a7ab, 0xc381f699, 0x58b86a6d, 0x0774b0c9, 0xb12436fd,
+  0x2e71bde1, 0x093b3e0e, 0xc6196693, 0x5b6e4887, 0x1fb69689, 0x77c60a20, 0x67a3361c, 0x8567d824,
+  0xf5aec60c, 0x4ae16d28, 0x4174b182, 0xaa3ea28a, 0xcce7b033, 0xc2b7a47f, 0xc0750f90, 0x49000ec5,
+  0xc8026aab, 0x0e859ecd, 0xf8668cc5, 0x575c9221, 0x2ec59e84, 0x9cd310ea, 0x099aa026, 0xfb20893c,
+  0xb22cb5c0, 0xe2ab19a7, 0x3309ad91, 0x3b192f81, 0x96a44db9, 0x561e9b8d, 0x6bff5785, 0x2699d945,
+  0x0786fbe3, 0x96cf8c23, 0xea7b94fe,
+};
+
+const uint32_t c_golden_price_decimals[] = {
+  0xd903fb40, 0xda03fcd3, 0xda03fcd3, 0xda03fcd3, 0xda03fcd3, 0xda03fcd3, 0xda03fcd3, 0xda03fcd3,
+  0xda03fcd3, 0xda03fcd3, 0xd903fb40, 0xd7997f53, 0xfcf28793, 0xfcf28793, 0x1fe47e93, 0xa012c713,
+  0xa012c713, 0xb9de5c93, 0x8ed939d3, 0x95098bd3, 0x8271a753, 0x03eefcd3, 0x68d8bd13, 0x99dfdc73,
+  0x6825b4f3, 0x62b14a93, 0x7de450d3, 0xa79362f3, 0xa8bf6eb3, 0x19df12f3, 0x1c5f43b3, 0xc2de9cf3,
+  0xbb074125, 0x86d59fd9, 0xba8249d9, 0x8ef6b559, 0xf2127b59, 0xfbe3a039, 0x96e14f39, 0x9f487039,
+  0x22e897d9, 0x4d414659, 0xa8b2a499, 0xcfb94fd9, 0x9d630419, 0x41bad6f9, 0x24520039, 0xd74efa79,
+  0x2df6a9b9, 0xe35f5fb9, 0xe8e47d56, 0x67b83718, 0x3d10fb71, 0x07aec350, 0x495afa21, 0x34cc6d2d,
+  0xe4b37096, 0x73520fc3, 0xd3fd670f, 0x9da5af29, 0x007db011, 0x7b39dd9d, 0x83140ba5, 0x8125c43f,
+  0xc7d8153e, 0xfad9fa73, 0x46dd6c61, 0x52d1508c, 0x7bbda6f7, 0xa072741d, 0x78e75615, 0xa0602a19,
+  0xbb670aa5, 0x4f443e7d, 0x292c739f, 0xfd946212, 0xbc222a17, 0x36ecbcd9, 0x6cf3952f, 0xb7bc4b5b,
+  0x8e695050, 0x1c66beb9, 0x77d0ddba, 0x3484bbe6, 0x7328f153, 0x0ca008ad, 0x6ac64ad5, 0x70ae89be,
+  0x0d1f5032, 0xc47fb442, 0xc2f48e8d, 0xd6cf73da, 0xded5999a, 0x6076a8a9, 0xf7d853e9, 0x6ca63f95,
+  0x63d85ac5, 0xa7b7c681, 0xdcccb152, 0x35a41e9d, 0x4ad21d38, 0x3462fd5b, 0x72506938, 0x11094b2f,
+  0x5c449e1d, 0x62e92a39, 0x104793e7, 0x904c9503, 0xecfa5e6c, 0xa0ef85ba, 0xc4e7a145, 0x5d63ea5a,
+  0xe4158378, 0x63d68201, 0x06224da9, 0xf2df3f9e, 0xf8e70f6e, 0x9e5afa20, 0x6e55cd04, 0xe4a76f99,
+};
+
+const uint32_t c_golden_price_timeout[] = {
+  0x03d60907, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0xdb0489ae, 0xdb0489ae,
+  0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae,
+  0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0xdb0489ae, 0x03d60907, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+};
+
+const uint32_t c_golden_clock[] = {
+  0xd1ad29d8, 0xd1ad29d8, 0xd1ad29d8, 0xd1ad29d8, 0xd1ad29d8, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8,
+  0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8,
+  0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8,
+  0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8, 0x5edc3ea8,
+};
+
+const uint32_t c_golden_static_text[] = {
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xd4030e96,
+  0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96,
+  0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96,
+  0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96, 0xd4030e96,
+};
+
+const uint32_t c_golden_rotating_text[] = {
+  0x21edace9, 0xbc808ab3, 0xbc808ab3, 0xb5071d96, 0x3d884e5e, 0x3d884e5e, 0x96ad762d, 0x06cef384,
+  0x06cef384, 0xec2a7b53, 0x85328734, 0x85328734, 0xd4c3c9aa, 0x00e4da99, 0x00e4da99, 0xb30401c0,
+  0xbcb299bc, 0xbcb299bc, 0x633d72d5, 0xc0ec1056, 0xc0ec1056, 0x1616be63, 0xf6090d15, 0xf6090d15,
+  0x209aa1c6, 0xeac35ae1, 0xeac35ae1, 0x45575121, 0xbffb0444, 0xbffb0444, 0x3cadaddd, 0xa11ce723,
+  0xa11ce723, 0xe198759d, 0x8bb95b82, 0x8bb95b82, 0xa28fb285, 0x567dd0a8, 0x567dd0a8, 0x25b6b660,
+  0xb3f2adbf, 0xb3f2adbf, 0x24c605fc, 0x0c67ac8d, 0x0c67ac8d, 0x97d2c4ed, 0xb2541390, 0xb2541390,
+  0x44ddac11, 0x84782c12, 0x84782c12, 0x256b11fa, 0x256b11fa, 0xbd32c51c, 0x9465a0fc, 0x9465a0fc,
+  0x08125701, 0x7716b741, 0x7716b741, 0x807ae6a2, 0x21edace9, 0x21edace9, 0xbc808ab3, 0xb5071d96,
+  0xb5071d96, 0x3d884e5e, 0x96ad762d, 0x96ad762d, 0x06cef384, 0xec2a7b53, 0xec2a7b53, 0x85328734,
+  0xd4c3c9aa, 0xd4c3c9aa, 0x00e4da99, 0xb30401c0, 0xb30401c0, 0xbcb299bc, 0x633d72d5, 0x633d72d5,
+  0xc0ec1056, 0x1616be63, 0x1616be63, 0xf6090d15, 0x209aa1c6, 0x209aa1c6, 0xeac35ae1, 0x45575121,
+  0x45575121, 0xbffb0444, 0x3cadaddd, 0x3cadaddd, 0xa11ce723, 0xe198759d, 0xe198759d, 0x8bb95b82,
+  0xa28fb285, 0xa28fb285, 0x567dd0a8, 0x25b6b660, 0x25b6b660, 0xb3f2adbf, 0xb3f2adbf, 0x24c605fc,
+  0x0c67ac8d, 0x0c67ac8d, 0x97d2c4ed, 0xb2541390, 0xb2541390, 0x44ddac11, 0x84782c12, 0x84782c12,
+  0x256b11fa, 0xbd32c51c, 0xbd32c51c, 0x9465a0fc, 0x08125701, 0x08125701, 0x7716b741, 0x807ae6a2,
+};
+
+const uint32_t c_golden_rotating_text_once[] = {
+  0x0b2ae445, 0x5a8a8e22, 0xa8aef97c, 0xf5982653, 0xea0aca91, 0xd16f048a, 0x0181714c, 0xd45622d3,
+  0x2943af91, 0x470ce43f, 0xd7ef11a4, 0x7d2db0e0, 0x34751b3b, 0x36c0b268, 0xfceb0d3e, 0x400db3cb,
+  0xcd05899d, 0xfd9d268b, 0x4c37c995, 0x93904c13, 0x6d5c060a, 0x8edbdfb4, 0xc58f6be3, 0x876a144e,
+  0x7c8cf880, 0x2a1ef961, 0xee83c801, 0x6984ec54, 0x5a773875, 0x7130f4a0, 0x67234f63, 0xf391bfbc,
+  0x9264afcd, 0x376ca92c, 0x189ae810, 0xe0637713, 0xb0e03b88, 0xc1e35963, 0xc0fef6c6, 0x4b27b338,
+  0x4a9faabe, 0xef5992a8, 0x4b8d7a1e, 0xe51bdb74, 0x721414f8, 0x32ef049f, 0xac1b3d8c, 0xb704d61a,
+  0x18c0a3e0, 0xa318cbba, 0x2e4c8f03, 0x2b456753, 0x9b0ee4f7, 0x568a29e1, 0x7594e5ad, 0x5592bf7d,
+  0x7d3d35b3, 0x5caca6a6, 0x19496bf7, 0x2efa5908, 0xdc1b775e, 0xbd0a3d43, 0x3e380b09, 0x5dd837ad,
+  0xd800d774, 0xa3467ba6, 0x8cbab443, 0xeef84ea9, 0xee8056dd, 0x3b603e35, 0xc4b1f165, 0xa2a37d05,
+  0x5a7b53c5, 0x0b2ae445, 0x0b2ae445, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6,
+  0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6,
+  0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6,
+  0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6,
+  0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6,
+  0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6, 0x2145f6d6,
+};
+
+const uint32_t c_golden_multi_repeat[] = {
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x1be1ada6, 0x1be1ada6, 0x5b886758, 0x7716b5d4, 0x6fd9e5c1, 0x6fd9e5c1, 0x8583817d,
+  0x670d8892, 0x1fb86242, 0x1fb86242, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xa3b32822, 0xa3b32822, 0xd7aaad04, 0x47a5a7b8, 0x53d5898d, 0x53d5898d, 0x389f9f41, 0x20d472f6,
+  0xe4a33206, 0xe4a33206, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x1be1ada6,
+  0x1be1ada6, 0x5b886758, 0x7716b5d4, 0x6fd9e5c1, 0x6fd9e5c1, 0x8583817d, 0x670d8892, 0x1fb86242,
+  0x1fb86242, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572,
+  0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xc1a7f572, 0xa3b32822, 0xa3b32822,
+  0xd7aaad04, 0x47a5a7b8, 0x53d5898d, 0x53d5898d, 0x389f9f41, 0x20d472f6, 0xe4a33206, 0xe4a33206,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+  0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16, 0x4534ce16,
+};
+
+const uint32_t c_golden_slide_transition[] = {
+  0x37132067, 0x37132067, 0xe47ba769, 0xe47ba769, 0xf55d5abb, 0x08bf9002, 0xded1a6b9, 0x4e5837eb,
+  0xb43d5350, 0x0a671ebe, 0x3f47a521, 0x5c53ec93, 0xe7bb92cc, 0xb161d9cf, 0x29e89183, 0x8ccd66e4,
+  0x0e972c7f, 0x46c8ac7f, 0xf1a50ae4, 0x9862ab6f, 0xc1237112, 0xd1b30831, 0x20e9cfde, 0x53492414,
+  0x93cb0e0d, 0x93cb0e0d, 0xb2c86ea1, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95,
+  0x21aabd09, 0x21aabd09, 0xcf4f632e, 0xcf4f632e, 0x0843a2d9, 0xaf544902, 0x227908ea, 0xe11314f0,
+  0x02d60774, 0xe11314f0, 0xe11314f0, 0x66d9a07d, 0x66d9a07d, 0x66d9a07d, 0x66d9a07d, 0x66d9a07d,
+  0x66d9a07d, 0xe11314f0, 0xe11314f0, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+  0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774, 0x02d60774,
+};
+
+const uint32_t c_golden_static_bitmap[] = {
+  0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067,
+  0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067, 0x37132067, 0xec814b95,
+  0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95,
+  0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95,
+  0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95, 0xec814b95,
+};
+
+const GoldenFrames c_golden_frames[] = {
+  {"price", c_golden_price, sizeof(c_golden_price) / sizeof(uint32_t)},
+  {"price_decimals", c_golden_price_decimals, sizeof(c_golden_price_decimals) / sizeof(uint32_t)},
+  {"price_timeout", c_golden_price_timeout, sizeof(c_golden_price_timeout) / sizeof(uint32_t)},
+  {"clock", c_golden_clock, sizeof(c_golden_clock) / sizeof(uint32_t)},
+  {"static_text", c_golden_static_text, sizeof(c_golden_static_text) / sizeof(uint32_t)},
+  {"rotating_text", c_golden_rotating_text, sizeof(c_golden_rotating_text) / sizeof(uint32_t)},
+  {"rotating_text_once", c_golden_rotating_text_once, sizeof(c_golden_rotating_text_once) / sizeof(uint32_t)},
+  {"multi_repeat", c_golden_multi_repeat, sizeof(c_golden_multi_repeat) / sizeof(uint32_t)},
+  {"slide_transition", c_golden_slide_transition, sizeof(c_golden_slide_transition) / sizeof(uint32_t)},
+  {"static_bitmap", c_golden_static_bitmap, sizeof(c_golden_static_bitmap) / sizeof(uint32_t)},
+};
@@ -0,0 +1,267 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Golden frame regression suite: drives each display action through a scripted timeline with
+  a fixed frame step, hashes every rendered frame and compares the hashes with the recorded
+  ones in golden_frames.hpp, so that changes of the render path can be proven pixel-identical.
+  Texts use the suite's own font (frame_font.hpp).
+
+  After an intended change of the output, record new hashes with
+    PLATFORMIO_BUILD_FLAGS=-DGOLDEN_RECORD pio test -e native -f test_golden_frames -v
+  and replace golden_frames.hpp with the printed table.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <TimeLib.h>
+#include <memory>
+#include <queue>
+#include <vector>
+#include "native.hpp"
+#include "setup.hpp"
+#include "frame_font.hpp"
+#include "bitmaps.hpp"
+#include "display_action_price.hpp"
+#include "display_action_clock.hpp"
+#include "display_action_text.hpp"
+#include "display_action_multi.hpp"
+#include "display_action_bitmap.hpp"
+#include "data_source.hpp"
+
+struct GoldenFrames {
+  const char *timeline;
+  const uint32_t *hashes;
+  size_t count;
+};
+#include "golden_frames.hpp"
+
+extern DisplayT *g_display;
+extern DataSource *g_data_source;
+
+using namespace Display;
+using std::make_shared;
+
+namespace {
+const uint32_t c_frame_us = 33000;
+
+TextView view(const char *text)
+{
+  return TextView{text, strlen(text)};
+}
+
+// renders frames of the queued actions, moving the clock along
+class Timeline
+{
+public:
+  void frames(const int count, const uint32_t step_us = c_frame_us)
+  {
+    for (int i=0;i<count;++i) {
+      Native::advanceMicros(step_us);
+      g_display->step(step_us);
+      m_hashes.push_back(g_display->getFrameHash());
+    }
+  }
+  const std::vector<uint32_t>& hashes() { return m_hashes; }
+private:
+  std::vector<uint32_t> m_hashes;
+};
+
+#if defined(GOLDEN_RECORD)
+void check(const char *name, Timeline& timeline)
+{
+  printf("const uint32_t c_golden_%s[] = {", name);
+  for (size_t i=0;i<timeline.hashes().size();++i)
+    printf("%s0x%08x,", (i % 8 == 0) ? "\n  " : " ", timeline.hashes()[i]);
+  printf("\n};\n");
+}
+#else
+void check(const char *name, Timeline& timeline)
+{
+  const GoldenFrames *golden = nullptr;
+  for (const GoldenFrames& frames : c_golden_frames)
+    if (strcmp(frames.timeline, name) == 0)
+      golden = &frames;
+  TEST_ASSERT_NOT_NULL(golden);
+
+  const std::vector<uint32_t>& hashes = timeline.hashes();
+  TEST_ASSERT_EQUAL_UINT32(golden->count, hashes.size());
+  for (size_t i=0;i<hashes.size();++i) {
+    char message[48];
+    snprintf(message, sizeof(message), "%s, frame %u", name, (unsigned) i);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(golden->hashes[i], hashes[i], message);
+  }
+}
+#endif
+
+std::shared_ptr<ActionT> text(const char *value, const double duration)
+{
+  return make_shared<Action::StaticText>(value, duration);
+}
+}
+
+void setUp(void)
+{
+  g_display->cleanQueue();
+  g_display->setFont(0);
+  Native::setMicros(0);
+}
+
+void tearDown(void)
+{
+  g_display->cleanQueue();
+}
+
+void test_price(void)
+{
+  Timeline timeline;
+  auto price = make_shared<PriceAction>(10);
+  g_display->queueAction(price);
+  timeline.frames(5); // no price yet
+
+  price->updatePrice(view("6543.21"));
+  timeline.frames(10);
+  price->updatePrice(view("6549.87")); // animates up
+  timeline.frames(40);
+  price->updatePrice(view("6540.00")); // and down
+  timeline.frames(40);
+  price->setATHPrice(view("6560"));
+  price->updatePrice(view("6561")); // blinks at the all time high
+  timeline.frames(60);
+  check("price", timeline);
+}
+
+void test_price_decimals(void)
+{
+  Timeline timeline;
+  auto price = make_shared<PriceAction>(10);
+  g_display->queueAction(price);
+  price->updatePrice(view("0.12345"));
+  timeline.frames(10);
+  price->updatePrice(view("0.12399")); // digits roll over
+  timeline.frames(40);
+  price->updatePrice(view("99.95"));
+  timeline.frames(10);
+  price->updatePrice(view("100.2")); // one decimal less
+  timeline.frames(40);
+  price->updatePrice(view("-12.5"));
+  timeline.frames(20);
+  check("price_decimals", timeline);
+}
+
+void test_price_timeout(void)
+{
+  Timeline timeline;
+  auto price = make_shared<PriceAction>(10);
+  price->setPriceTimeout(1.0);
+  g_display->queueAction(price);
+  price->updatePrice(view("6543.21"));
+  timeline.frames(45); // "-----" after a second
+  price->updatePrice(view("6543.25"));
+  timeline.frames(10);
+  check("price_timeout", timeline);
+}
+
+void test_clock(void)
+{
+  Timeline timeline;
+  g_display->queueAction(make_shared<Action::Clock>(-1));
+  timeline.frames(5); // "--:--"
+  setTime(12*3600 + 34*60 + 58);
+  timeline.frames(90); // 12:34, then 12:35
+  check("clock", timeline);
+}
+
+void test_static_text(void)
+{
+  Timeline timeline;
+  g_display->queueAction(text("BTC", 0.5));
+  g_display->queueAction(text("12.34", 0.5));
+  timeline.frames(40);
+  check("static_text", timeline);
+}
+
+void test_rotating_text(void)
+{
+  Timeline timeline;
+  g_display->queueAction(make_shared<Action::RotatingText>("HELLO WORLD", -1, 20));
+  timeline.frames(120);
+  check("rotating_text", timeline);
+}
+
+void test_rotating_text_once(void)
+{
+  Timeline timeline;
+  g_display->queueAction(make_shared<Action::RotatingTextOnce>("NEW ATH 6561", 30));
+  g_display->queueAction(text("END", -1));
+  timeline.frames(120); // until the text has left the display
+  check("rotating_text_once", timeline);
+}
+
+void test_multi_repeat(void)
+{
+  Timeline timeline;
+  g_display->queueAction(Action::createRepeatedSlide(Coords{0,1}, -1, 0.5, text("12:34", 1.0), text("BTC", 1.0)));
+  timeline.frames(200); // two rounds
+  check("multi_repeat", timeline);
+}
+
+void test_slide_transition(void)
+{
+  Timeline timeline;
+  auto top = make_shared<Action::StaticBitmap>(s_crypto2_bits, 32, 8, -1);
+  auto bottom = make_shared<Action::StaticBitmap>(s_clock_inverted_bits, 32, 8, -1);
+  g_display->queueAction(make_shared<Action::SlideTransition>(top, 1, bottom, 0, 1.0, Coords{1,0}));
+  g_display->queueAction(make_shared<Action::SlideTransition>(bottom, 0, text("6543", -1), 1, 1.0, Coords{0,-1},
+    Coords{0,0}, Easing::Curve::BOUNCE_OUT));
+  timeline.frames(70);
+  check("slide_transition", timeline);
+}
+
+void test_static_bitmap(void)
+{
+  Timeline timeline;
+  g_display->queueAction(make_shared<Action::StaticBitmap>(s_crypto2_bits, 32, 8, 0.5));
+  g_display->queueAction(make_shared<Action::StaticBitmap>(s_clock_inverted_bits, 32, 8, 0.5));
+  timeline.frames(40);
+  check("static_bitmap", timeline);
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setMicros(0);
+  Native::setupParameters();
+  g_display = Native::createDisplay(FrameFont::get());
+  g_data_source = new DataSource; // receives the data timeout warning
+
+  UNITY_BEGIN();
+  RUN_TEST(test_price);
+  RUN_TEST(test_price_decimals);
+  RUN_TEST(test_price_timeout);
+  RUN_TEST(test_clock);
+  RUN_TEST(test_static_text);
+  RUN_TEST(test_rotating_text);
+  RUN_TEST(test_rotating_text_once);
+  RUN_TEST(test_multi_repeat);
+  RUN_TEST(test_slide_transition);
+  RUN_TEST(test_static_bitmap);
+  return UNITY_END();
+}
@@ -0,0 +1,465 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Tests of the parameter persistence: stores are coalesced until c_store_delay_ms after the last
+  change, unchanged contents are not written, and the flash log rotates over its sectors and
+  keeps the last good configuration through power losses and corrupted records. Configuration
+  images that are corrupted, truncated or of an unknown schema are rejected as a whole.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <EEPROM.h>
+#include <set>
+#include "native.hpp"
+#include "parameter_store.hpp"
+#include "parameter_schema.hpp"
+#include "flash_log.hpp"
+#include "utils.hpp"
+
+extern "C" uint32_t _SPIFFS_start;
+
+namespace {
+const uint32_t c_store_delay_ms = 3000; // ParameterStore::c_store_delay_ms
+const uint32_t c_flash_mapped_at = 0x40200000;
+
+// what the firmware does at boot
+void boot(ParameterStore& parameters)
+{
+  parameters.begin(c_parameter_schema);
+  Utils::eeprom_BEGIN();
+  parameters.load();
+  Utils::eeprom_END();
+}
+
+void advanceMillis(const uint32_t ms)
+{
+  Native::advanceMicros(ms * 1000);
+}
+
+// a record of the binary configuration image
+void addRecord(std::vector<uint8_t>& records, const ParameterId id, const char *value, const size_t length)
+{
+  records.push_back((uint8_t) id);
+  records.push_back(length);
+  records.insert(records.end(), value, value + std::min(strlen(value), length));
+}
+
+// header (magic, format version, schema version, length, CRC32) and the records, as store() writes it
+std::vector<uint8_t> configImage(const std::vector<uint8_t>& records, const uint8_t schema_version = 1,
+  const uint16_t length_delta = 0, const uint32_t crc_delta = 0)
+{
+  const uint32_t magic = 0x47464343;
+  const uint16_t length = records.size() + length_delta;
+  const uint32_t crc = Utils::crc32(records.data(), records.size()) + crc_delta;
+  std::vector<uint8_t> image((const uint8_t*) &magic, (const uint8_t*) &magic + 4);
+  image.push_back(1);
+  image.push_back(schema_version);
+  image.insert(image.end(), (const uint8_t*) &length, (const uint8_t*) &length + 2);
+  image.insert(image.end(), (const uint8_t*) &crc, (const uint8_t*) &crc + 4);
+  image.insert(image.end(), records.begin(), records.end());
+  return image;
+}
+
+// boots from an image written into the store's flash log
+void bootFromImage(ParameterStore& parameters, const std::vector<uint8_t>& image)
+{
+  FlashLog log(((uint32_t) (uintptr_t) &_SPIFFS_start - c_flash_mapped_at) / FlashLog::c_sector_size, 4);
+  log.open();
+  TEST_ASSERT_TRUE(log.append(image.data(), image.size()));
+  boot(parameters);
+}
+
+void storeClockInterval(ParameterStore& parameters, const int interval)
+{
+  parameters.setValue(ParameterId::CLOCK_INTERVAL, String(interval));
+  parameters.store();
+}
+
+/* Cuts the power after every possible number of flash bytes of a store that follows stores_before
+   others: the next boot has to find the previous configuration, until the whole record made it,
+   and storing has to work again. */
+void checkPowerLossDuringStore(const int stores_before)
+{
+  const int previous = 5 + stores_before - 1;
+  for (uint32_t cut=0;cut<2*FlashLog::c_sector_size;cut+=4) {
+    Native::eraseFlash();
+    ParameterStore parameters;
+    boot(parameters);
+    for (int i=0;i<stores_before;++i)
+      storeClockInterval(parameters, 5 + i);
+
+    Native::cutPowerAfterFlashBytes(cut);
+    storeClockInterval(parameters, 1000);
+    Native::powerOn();
+
+    ParameterStore loaded;
+    boot(loaded);
+    if (loaded.getInt(ParameterId::CLOCK_INTERVAL) == 1000) {
+      TEST_ASSERT_TRUE(cut > 0);
+      return;
+    }
+    TEST_ASSERT_EQUAL_INT32(previous, loaded.getInt(ParameterId::CLOCK_INTERVAL));
+
+    storeClockInterval(loaded, 2000);
+    ParameterStore reloaded;
+    boot(reloaded);
+    TEST_ASSERT_EQUAL_INT32(2000, reloaded.getInt(ParameterId::CLOCK_INTERVAL));
+  }
+  TEST_FAIL_MESSAGE("the store never completed");
+}
+}
+
+void setUp(void)
+{
+  Native::setMicros(0);
+  Native::eraseFlash();
+  EEPROM.erase();
+}
+
+void tearDown(void)
+{
+}
+
+void test_store_is_delayed_after_the_last_change(void)
+{
+  ParameterStore parameters;
+  boot(parameters);
+
+  parameters.setValue(ParameterId::BRIGHTNESS, "5");
+  parameters.scheduleStore();
+  advanceMillis(2000);
+  parameters.loop();
+  parameters.setValue(ParameterId::FONT, "2");
+  parameters.scheduleStore();
+  advanceMillis(2999);
+  parameters.loop();
+  TEST_ASSERT_EQUAL_UINT32(0, parameters.getCommits());
+
+  advanceMillis(1);
+  parameters.loop();
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getStoresCoalesced());
+
+  advanceMillis(c_store_delay_ms);
+  parameters.loop(); // nothing pending anymore
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+}
+
+void test_ten_settings_are_one_write(void)
+{
+  ParameterStore parameters;
+  boot(parameters);
+
+  const char *names[] = {"brightness", "font", "clock_mode", "clock_interval", "telemetry_interval",
+    "timezone", "rotate_display", "update_url", "ticker_url", "brightness"};
+  const char *values[] = {"4", "1", "2", "60", "600", "-3", "1", "update.example.com", "wss://ticker.example.com/", "2"};
+  for (size_t i=0;i<10;++i) {
+    TEST_ASSERT_TRUE(parameters.setValue(String(names[i]), String(values[i])));
+    parameters.scheduleStore();
+    advanceMillis(100);
+    parameters.loop();
+  }
+  advanceMillis(c_store_delay_ms);
+  parameters.loop();
+
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+  TEST_ASSERT_EQUAL_UINT32(9, parameters.getStoresCoalesced());
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getErases());
+
+  ParameterStore loaded;
+  boot(loaded);
+  TEST_ASSERT_EQUAL_INT32(2, loaded.getInt(ParameterId::BRIGHTNESS));
+  TEST_ASSERT_EQUAL_INT32(-3, loaded.getInt(ParameterId::TIMEZONE));
+  TEST_ASSERT_EQUAL_INT32(60, loaded.getInt(ParameterId::CLOCK_INTERVAL));
+  TEST_ASSERT_EQUAL_STRING("wss://ticker.example.com/", loaded.getString(ParameterId::TICKER_URL).c_str());
+}
+
+void test_unchanged_contents_are_not_written(void)
+{
+  ParameterStore parameters;
+  boot(parameters);
+  parameters.setValue(ParameterId::BRIGHTNESS, "4");
+  parameters.store();
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+
+  parameters.setValue(ParameterId::BRIGHTNESS, "4");
+  parameters.store();
+  parameters.flush(); // nothing scheduled
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommitsUnchanged());
+
+  // also across a reboot, the loaded image is what is stored
+  ParameterStore loaded;
+  boot(loaded);
+  loaded.store();
+  TEST_ASSERT_EQUAL_UINT32(0, loaded.getCommits());
+  TEST_ASSERT_EQUAL_UINT32(1, loaded.getCommitsUnchanged());
+  TEST_ASSERT_EQUAL_UINT32(0, loaded.getErases());
+}
+
+void test_flush_writes_a_pending_store(void)
+{
+  ParameterStore parameters;
+  boot(parameters);
+  parameters.setValue(ParameterId::CLOCK_MODE, "0");
+  parameters.scheduleStore();
+  parameters.flush(); // before a restart
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+
+  ParameterStore loaded;
+  boot(loaded);
+  TEST_ASSERT_EQUAL_INT32(0, loaded.getInt(ParameterId::CLOCK_MODE));
+}
+
+void test_log_rotates_over_its_sectors(void)
+{
+  ParameterStore parameters;
+  boot(parameters);
+
+  const int stores = 500;
+  for (int i=0;i<stores;++i) {
+    parameters.setValue(ParameterId::CLOCK_INTERVAL, String(5 + i));
+    parameters.store();
+  }
+  TEST_ASSERT_EQUAL_UINT32(stores, parameters.getCommits());
+  // many records per erase, where the EEPROM emulation erased on every commit
+  TEST_ASSERT_TRUE(parameters.getErases() < stores / 10);
+
+  ParameterStore loaded;
+  boot(loaded);
+  TEST_ASSERT_EQUAL_INT32(5 + stores - 1, loaded.getInt(ParameterId::CLOCK_INTERVAL));
+}
+
+void test_flash_log_wear_is_spread(void)
+{
+  const uint32_t first_sector = 0x300;
+  const uint8_t sectors = 4;
+  FlashLog log(first_sector, sectors);
+  TEST_ASSERT_FALSE(log.open());
+
+  std::vector<uint8_t> record(1000);
+  std::set<uint8_t> used;
+  for (uint32_t i=0;i<40;++i) {
+    memcpy(record.data(), &i, sizeof(i));
+    TEST_ASSERT_TRUE(log.append(record.data(), record.size()));
+    used.insert(log.getSector());
+  }
+  TEST_ASSERT_EQUAL_UINT32(sectors, used.size());
+  TEST_ASSERT_EQUAL_UINT32(10, log.getErases()); // 4 records per sector
+
+  FlashLog reopened(first_sector, sectors);
+  TEST_ASSERT_TRUE(reopened.open());
+  std::vector<uint8_t> data;
+  TEST_ASSERT_TRUE(reopened.read(data));
+  uint32_t newest;
+  memcpy(&newest, data.data(), sizeof(newest));
+  TEST_ASSERT_EQUAL_UINT32(39, newest);
+}
+
+void test_power_loss_during_a_store(void)
+{
+  checkPowerLossDuringStore(1);
+}
+
+void test_power_loss_while_moving_to_a_new_sector(void)
+{
+  // how many stores fill the first sector
+  ParameterStore parameters;
+  boot(parameters);
+  int stores = 0;
+  while (parameters.getErases() < 2)
+    storeClockInterval(parameters, 5 + stores++);
+
+  // the new sector is erased, then gets its header, then the record
+  checkPowerLossDuringStore(stores - 1);
+}
+
+void test_flash_log_skips_corrupted_records(void)
+{
+  const uint32_t first_sector = 0x300;
+  const uint32_t address = first_sector * FlashLog::c_sector_size;
+  FlashLog log(first_sector, 4);
+  for (uint32_t value=1;value<=2;++value)
+    TEST_ASSERT_TRUE(log.append((const uint8_t*) &value, sizeof(value)));
+
+  // the second record's data (sector header 8, records of 8 + 4 bytes) loses its bits: bad checksum
+  uint32_t zero = 0;
+  ESP.flashWrite(address + 8 + 12 + 8, &zero, sizeof(zero));
+  FlashLog reopened(first_sector, 4);
+  TEST_ASSERT_TRUE(reopened.open());
+  std::vector<uint8_t> data;
+  TEST_ASSERT_TRUE(reopened.read(data));
+  TEST_ASSERT_EQUAL_UINT32(1, *(const uint32_t*) data.data());
+
+  // garbage where the next record goes (length 16, marker 0x1234): the rest of the sector is skipped
+  uint32_t garbage[2] = { 0x12340010, 0xDEADBEEF };
+  ESP.flashWrite(address + 8 + 2*12, garbage, sizeof(garbage));
+  FlashLog garbled(first_sector, 4);
+  TEST_ASSERT_TRUE(garbled.open());
+  TEST_ASSERT_TRUE(garbled.read(data));
+  TEST_ASSERT_EQUAL_UINT32(1, *(const uint32_t*) data.data());
+
+  const uint32_t value = 3;
+  TEST_ASSERT_TRUE(garbled.append((const uint8_t*) &value, sizeof(value)));
+  TEST_ASSERT_EQUAL_UINT8(1, garbled.getSector());
+  FlashLog recovered(first_sector, 4);
+  TEST_ASSERT_TRUE(recovered.open());
+  TEST_ASSERT_TRUE(recovered.read(data));
+  TEST_ASSERT_EQUAL_UINT32(3, *(const uint32_t*) data.data());
+}
+
+void test_image_round_trip_keeps_every_value(void)
+{
+  ParameterStore parameters;
+  boot(parameters);
+  String padding;
+  for (int i=0;i<200;++i)
+    padding += 'x';
+  for (size_t i=0;i<(size_t) ParameterId::COUNT;++i) {
+    ParameterItem& item = parameters.item((ParameterId) i);
+    if (item.isLegacy())
+      continue;
+    if (item.getType() == ParameterType::INT) // the other end of the range than the default
+      parameters.setValue((ParameterId) i, String(item.int_value == item.schema->min_value ? item.schema->max_value : item.schema->min_value));
+    else
+      parameters.setValue((ParameterId) i, "value " + String((int) i) + " " + padding);
+  }
+  parameters.store();
+
+  ParameterStore loaded;
+  boot(loaded);
+  for (size_t i=0;i<(size_t) ParameterId::COUNT;++i) {
+    if (parameters.item((ParameterId) i).isLegacy())
+      continue;
+    TEST_ASSERT_EQUAL_STRING(parameters.item((ParameterId) i).value.c_str(), loaded.item((ParameterId) i).value.c_str());
+    TEST_ASSERT_EQUAL_INT32(parameters.item((ParameterId) i).int_value, loaded.item((ParameterId) i).int_value);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, loaded.getCommits());
+  loaded.store(); // the image read back is the one stored
+  TEST_ASSERT_EQUAL_UINT32(1, loaded.getCommitsUnchanged());
+}
+
+void test_image_is_read_as_written(void)
+{
+  std::vector<uint8_t> records;
+  addRecord(records, ParameterId::BRIGHTNESS, "5", 1);
+  addRecord(records, ParameterId::TIMEZONE, "-3", 2);
+  records.push_back(200); // id of a parameter of newer firmware, skipped
+  records.push_back(0);
+
+  ParameterStore parameters;
+  bootFromImage(parameters, configImage(records));
+  TEST_ASSERT_EQUAL_INT32(5, parameters.getInt(ParameterId::BRIGHTNESS));
+  TEST_ASSERT_EQUAL_INT32(-3, parameters.getInt(ParameterId::TIMEZONE));
+}
+
+void test_image_with_bad_crc_is_rejected(void)
+{
+  std::vector<uint8_t> records;
+  addRecord(records, ParameterId::BRIGHTNESS, "5", 1);
+
+  ParameterStore parameters;
+  bootFromImage(parameters, configImage(records, 1, 0, 1));
+  TEST_ASSERT_EQUAL_INT32(3, parameters.getInt(ParameterId::BRIGHTNESS)); // default
+}
+
+void test_image_with_overlong_length_is_rejected(void)
+{
+  std::vector<uint8_t> records;
+  addRecord(records, ParameterId::BRIGHTNESS, "5", 1);
+
+  ParameterStore parameters;
+  bootFromImage(parameters, configImage(records, 1, 10));
+  TEST_ASSERT_EQUAL_INT32(3, parameters.getInt(ParameterId::BRIGHTNESS));
+}
+
+void test_image_with_truncated_record_is_rejected(void)
+{
+  // CRC and length match, but the last record claims more bytes than there are
+  std::vector<uint8_t> records;
+  addRecord(records, ParameterId::BRIGHTNESS, "5", 1);
+  addRecord(records, ParameterId::TICKER_URL, "wss://", 20);
+
+  ParameterStore parameters;
+  bootFromImage(parameters, configImage(records));
+  TEST_ASSERT_EQUAL_INT32(3, parameters.getInt(ParameterId::BRIGHTNESS)); // nothing applied
+  TEST_ASSERT_EQUAL_STRING("wss://ticker.cryptoclock.net:443/", parameters.getString(ParameterId::TICKER_URL).c_str());
+}
+
+void test_image_of_a_newer_schema_is_rejected(void)
+{
+  std::vector<uint8_t> records;
+  addRecord(records, ParameterId::BRIGHTNESS, "5", 1);
+
+  ParameterStore parameters;
+  bootFromImage(parameters, configImage(records, 2));
+  TEST_ASSERT_EQUAL_INT32(3, parameters.getInt(ParameterId::BRIGHTNESS));
+}
+
+void test_text_configuration_is_migrated(void)
+{
+  // layout of older firmware at the store's EEPROM offset
+  Utils::eeprom_BEGIN();
+  int offset = 1024;
+  Utils::eeprom_WriteString(offset, "PARAMS");
+  Utils::eeprom_WriteString(offset, "brightness");
+  Utils::eeprom_WriteString(offset, "5");
+  Utils::eeprom_WriteString(offset, "ticker_server_host");
+  Utils::eeprom_WriteString(offset, "ticker.example.com");
+  Utils::eeprom_WriteString(offset, "ENDPARAMS");
+  Utils::eeprom_END();
+
+  ParameterStore parameters;
+  boot(parameters);
+  TEST_ASSERT_EQUAL_INT32(5, parameters.getInt(ParameterId::BRIGHTNESS));
+  TEST_ASSERT_EQUAL_STRING("ticker.example.com", parameters.getString(ParameterId::LEGACY_TICKER_SERVER_HOST).c_str());
+
+  parameters.store(); // moves to the flash log even though no value changed
+  TEST_ASSERT_EQUAL_UINT32(1, parameters.getCommits());
+  ParameterStore loaded;
+  boot(loaded);
+  TEST_ASSERT_EQUAL_INT32(5, loaded.getInt(ParameterId::BRIGHTNESS));
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_store_is_delayed_after_the_last_change);
+  RUN_TEST(test_ten_settings_are_one_write);
+  RUN_TEST(test_unchanged_contents_are_not_written);
+  RUN_TEST(test_flush_writes_a_pending_store);
+  RUN_TEST(test_log_rotates_over_its_sectors);
+  RUN_TEST(test_flash_log_wear_is_spread);
+  RUN_TEST(test_power_loss_during_a_store);
+  RUN_TEST(test_power_loss_while_moving_to_a_new_sector);
+  RUN_TEST(test_flash_log_skips_corrupted_records);
+  RUN_TEST(test_image_round_trip_keeps_every_value);
+  RUN_TEST(test_image_is_read_as_written);
+  RUN_TEST(test_image_with_bad_crc_is_rejected);
+  RUN_TEST(test_image_with_overlong_length_is_rejected);
+  RUN_TEST(test_image_with_truncated_record_is_rejected);
+  RUN_TEST(test_image_of_a_newer_schema_is_rejected);
+  RUN_TEST(test_text_configuration_is_migrated);
+  return UNITY_END();
+}
@@ -0,0 +1,234 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Fixed point Price against the double based Price it replaced: parsed prices, increments,
+  animation steps and deltas must come out the same as with the old toString() rules.
+  Benchmarks both.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include "native_benchmark.hpp"
+#include "price.hpp"
+
+namespace {
+// the double based Price (non-negative prices only, it didn't handle negative ones)
+class LegacyPrice
+{
+public:
+  LegacyPrice(const String& price) : m_price(0.0), m_display_decimals(6), m_display_float_part(false)
+  {
+    if (price.indexOf('.')!=-1)
+      m_display_float_part = true;
+    m_price = atof(price.c_str());
+    if (m_display_float_part)
+      m_price = atof(toString().c_str());
+  }
+
+  LegacyPrice(const double price, const bool display_float_part) :
+    m_price(price), m_display_decimals(6), m_display_float_part(display_float_part)
+  {}
+
+  String toString()
+  {
+    uint8_t l_digits = String((int) m_price).length();
+    uint8_t r_digits = m_display_decimals - l_digits - 1;
+
+    if (m_display_float_part && m_price >= 1.0)
+      r_digits = 3;
+    if (m_display_float_part && m_price >= 10.0)
+      r_digits = 2;
+    if (m_display_float_part && m_price >= 100.0)
+      r_digits = 1;
+    if (m_display_float_part && m_price >= 1000.0) {
+      m_display_float_part = false;
+      r_digits = 0;
+    }
+
+    if (m_display_float_part && (l_digits+1<m_display_decimals)) {
+      String str = String(m_price, r_digits+5);
+      if (m_price<1.0)
+        return str.substring(1,1 + 2 + r_digits);
+      else
+        return str.substring(0,l_digits+1+r_digits);
+    } else {
+      return String((int)m_price).substring(0,m_display_decimals);
+    }
+  }
+
+  int getIncrExponent()
+  {
+    if (!m_display_float_part)
+      return 1;
+    const String& s = toString();
+    int pos = s.indexOf('.');
+    if (pos==-1)
+      return 1;
+    return pow(10, s.length()-1 - pos);
+  }
+
+  LegacyPrice nextPrice()
+  {
+    return LegacyPrice(m_price + 1.0 / getIncrExponent(), m_display_float_part);
+  }
+
+  double delta(const LegacyPrice& other)
+  {
+    return ((m_price - other.m_price) * getIncrExponent());
+  }
+
+private:
+  double m_price;
+  uint8_t m_display_decimals;
+  bool m_display_float_part;
+};
+
+const char *c_prices[] = {
+  "0", "7", "42", "999", "1000", "6543", "123456", "1234567", "0.0", "0.1", "0.5", ".25",
+  "0.12345", "0.123456789", "0.00001234", "0.99999", "0.999999", "1.0", "1.5", "9.9999",
+  "9.999", "10.01", "12.345", "99.99", "99.999", "100.0", "123.456", "999.95", "999.9",
+  "1000.5", "6543.21", "12345.678", "1234567.8", "3.10", "0.010", "250.0000001",
+};
+
+// random decimal texts of all magnitudes the display handles, with up to 9 decimals
+String randomPrice()
+{
+  String price(random(0, 100000));
+  price.remove(random(1, price.length() + 1));
+  if (random(0, 4) != 0) {
+    price += '.';
+    for (long i=random(0, 10);i>0;--i)
+      price += (char) ('0' + random(0, 10));
+  }
+  return price;
+}
+
+volatile int64_t g_sink;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_parsed_prices_format_as_before(void)
+{
+  for (const char *text : c_prices) {
+    Price price{String(text)};
+    LegacyPrice legacy{String(text)};
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(legacy.toString().c_str(), price.toString().c_str(), text);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(legacy.getIncrExponent(), price.getIncrExponent(), text);
+  }
+}
+
+void test_random_prices_format_as_before(void)
+{
+  randomSeed(12345);
+  for (int i=0;i<20000;++i) {
+    const String text = randomPrice();
+    Price price(text);
+    LegacyPrice legacy(text);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(legacy.toString().c_str(), price.toString().c_str(), text.c_str());
+    TEST_ASSERT_EQUAL_INT_MESSAGE(legacy.getIncrExponent(), price.getIncrExponent(), text.c_str());
+  }
+}
+
+/* the animation walks through every displayed step, across the magnitudes where decimals change;
+   each step is compared with the old rules applied to the exact value, since the old double
+   steps drifted (e.g. 0.99999 + 0.00001 showed as ".00000" instead of "1.000") */
+void test_next_price_steps_as_before(void)
+{
+  const char *starts[] = { "0.99000", "9.990", "99.95", "999.5", "6543.21", "0.00001" };
+  for (const char *start : starts) {
+    Price price{String(start)};
+    for (int step=0;step<3000;++step) {
+      const int64_t raw = price.getRaw();
+      char exact[32];
+      snprintf(exact, sizeof(exact), "%ld.%09ld", (long) (raw / Price::c_unit), (long) (raw % Price::c_unit));
+      LegacyPrice legacy(price.displayFloatPart() ? LegacyPrice(String(exact)) : LegacyPrice(String(price.toInt())));
+      TEST_ASSERT_EQUAL_STRING_MESSAGE(legacy.toString().c_str(), price.toString().c_str(), exact);
+      price = price.nextPrice();
+    }
+  }
+}
+
+void test_next_price_does_not_drift(void)
+{
+  Price price{String("0.99999")};
+  TEST_ASSERT_EQUAL_STRING("1.000", price.nextPrice().toString().c_str());
+  Price cents{String("0.10")};
+  for (int i=0;i<20;++i)
+    cents = cents.nextPrice();
+  TEST_ASSERT_EQUAL_STRING(".10020", cents.toString().c_str());
+}
+
+void test_delta_matches_in_increments(void)
+{
+  const char *pairs[][2] = {
+    { "6543.21", "6500.00" }, { "12.34", "12.30" }, { "0.12345", "0.12000" }, { "100.5", "99.95" },
+    { "1.000", "2.500" }, { "42", "40" }, { "7.5", "7.5" },
+  };
+  for (const auto& pair : pairs) {
+    Price price{String(pair[0])}, other{String(pair[1])};
+    LegacyPrice legacy{String(pair[0])}, legacy_other{String(pair[1])};
+    const double expected = legacy.delta(legacy_other) * Price::c_delta_unit;
+    TEST_ASSERT_INT_WITHIN_MESSAGE(1, lround(expected), price.delta(other), pair[0]);
+  }
+}
+
+void test_negative_prices_keep_the_sign(void)
+{
+  TEST_ASSERT_EQUAL_STRING("-12.34", Price(String("-12.34")).toString().c_str());
+  TEST_ASSERT_EQUAL_STRING("-.12345", Price(String("-0.12345")).toString().c_str());
+  TEST_ASSERT_EQUAL_STRING("-6543", Price(String("-6543.21")).toString().c_str());
+  TEST_ASSERT_TRUE(Price(String("-2")) < Price(String("-1")));
+}
+
+void test_benchmark_against_double_price(void)
+{
+  const String text("6543.21"), small_text("0.12345");
+  NativeBenchmark::measure("fixed point parse + toString", [&]() { g_sink = Price(text).toString().length(); });
+  NativeBenchmark::measure("double parse + toString", [&]() { g_sink = LegacyPrice(text).toString().length(); });
+
+  Price price(small_text), target(String("0.13345"));
+  LegacyPrice legacy(small_text), legacy_target(String("0.13345"));
+  NativeBenchmark::measure("fixed point nextPrice + delta", [&]() { g_sink = price.nextPrice().delta(target); });
+  NativeBenchmark::measure("double nextPrice + delta", [&]() { g_sink = legacy.nextPrice().delta(legacy_target); });
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_parsed_prices_format_as_before);
+  RUN_TEST(test_random_prices_format_as_before);
+  RUN_TEST(test_next_price_steps_as_before);
+  RUN_TEST(test_next_price_does_not_drift);
+  RUN_TEST(test_delta_matches_in_increments);
+  RUN_TEST(test_negative_prices_keep_the_sign);
+  RUN_TEST(test_benchmark_against_double_price);
+  return UNITY_END();
+}
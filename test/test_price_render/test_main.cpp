@@ -0,0 +1,166 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  PriceAction rendering: no heap allocations in steady state or while animating, and the
+  price layout recomputed only when the displayed text or the font changes, and a price
+  reported as drawn only once it was shown.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <memory>
+#include "native.hpp"
+#include "setup.hpp"
+#include "display_action_price.hpp"
+#include "display_action_text.hpp"
+#include "data_source.hpp"
+#include "alloc_counter.hpp"
+
+extern DisplayT *g_display;
+extern DataSource *g_data_source;
+
+namespace {
+std::shared_ptr<Display::PriceAction> g_price_action;
+
+TextView view(const char *text)
+{
+  return TextView{text, strlen(text)};
+}
+
+void renderFrames(const int count)
+{
+  for (int i=0;i<count;++i) {
+    Native::advanceMicros(g_display->getMilisPerTick() * 1000);
+    g_display->tick();
+  }
+}
+}
+
+void setUp(void)
+{
+  g_display->cleanQueue();
+  g_display->setFont(0);
+  g_price_action = std::make_shared<Display::PriceAction>(10);
+  g_display->queueAction(g_price_action);
+}
+
+void tearDown(void)
+{
+  g_display->cleanQueue();
+  g_price_action.reset();
+}
+
+void test_static_price_frames_do_not_allocate(void)
+{
+  g_price_action->updatePrice(view("6543.21"));
+  renderFrames(1); // fills the glyph width cache
+
+  const uint32_t allocations = AllocCounter::count();
+  renderFrames(300);
+  TEST_ASSERT_EQUAL(0, AllocCounter::count() - allocations);
+  TEST_ASSERT_EQUAL(0, g_price_action->getDrawAllocations());
+}
+
+void test_animating_price_frames_do_not_allocate(void)
+{
+  // digit counts, decimals and sign change along the way
+  const char *prices[] = { "99.95", "100.2", "6543.21", "6549.87", "-12.5", "0.12345", "0.12399", "99.95" };
+  g_price_action->updatePrice(view(prices[0]));
+  renderFrames(1);
+
+  const uint32_t allocations = AllocCounter::count();
+  for (const char *price : prices) {
+    g_price_action->updatePrice(view(price));
+    renderFrames(60);
+  }
+  TEST_ASSERT_EQUAL(0, AllocCounter::count() - allocations);
+  TEST_ASSERT_EQUAL(0, g_price_action->getDrawAllocations());
+}
+
+void test_timed_out_price_does_not_allocate(void)
+{
+  g_price_action->setPriceTimeout(1.0);
+  g_price_action->updatePrice(view("6543.21"));
+  renderFrames(60); // past the timeout, "-----" is shown
+
+  const uint32_t allocations = AllocCounter::count();
+  renderFrames(60);
+  TEST_ASSERT_EQUAL(0, AllocCounter::count() - allocations);
+}
+
+void test_layout_is_updated_only_on_change(void)
+{
+  g_price_action->updatePrice(view("6543"));
+  renderFrames(1);
+  const uint32_t updates = g_price_action->getLayoutUpdates();
+
+  renderFrames(100);
+  TEST_ASSERT_EQUAL(updates, g_price_action->getLayoutUpdates());
+
+  g_display->setFont(1);
+  renderFrames(100);
+  TEST_ASSERT_EQUAL(updates + 1, g_price_action->getLayoutUpdates());
+
+  g_price_action->updatePrice(view("6543")); // same price, same text
+  renderFrames(100);
+  TEST_ASSERT_EQUAL(updates + 1, g_price_action->getLayoutUpdates());
+}
+
+// the boot profiler's first_price stage, the price has to reach the display
+void test_price_is_drawn_only_once_shown(void)
+{
+  renderFrames(10); // "-----"
+  TEST_ASSERT_FALSE(g_price_action->isPriceDrawn());
+
+  g_price_action->updatePrice(view("6543.21"));
+  TEST_ASSERT_FALSE(g_price_action->isPriceDrawn());
+  renderFrames(1);
+  TEST_ASSERT_TRUE(g_price_action->isPriceDrawn());
+}
+
+void test_price_queued_behind_text_is_not_drawn(void)
+{
+  g_display->prependAction(std::make_shared<Display::Action::StaticText>("hello", 1.0));
+  g_price_action->updatePrice(view("6543.21"));
+  renderFrames(10);
+  TEST_ASSERT_FALSE(g_price_action->isPriceDrawn());
+
+  renderFrames(40); // the text is done after a second
+  TEST_ASSERT_TRUE(g_price_action->isPriceDrawn());
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setMicros(0);
+  Native::setupParameters();
+  g_display = Native::createDisplay();
+  g_data_source = new DataSource; // receives the data timeout warning
+
+  UNITY_BEGIN();
+  RUN_TEST(test_static_price_frames_do_not_allocate);
+  RUN_TEST(test_animating_price_frames_do_not_allocate);
+  RUN_TEST(test_timed_out_price_does_not_allocate);
+  RUN_TEST(test_layout_is_updated_only_on_change);
+  RUN_TEST(test_price_is_drawn_only_once_shown);
+  RUN_TEST(test_price_queued_behind_text_is_not_drawn);
+  return UNITY_END();
+}
@@ -0,0 +1,248 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Integer microsecond timebase of display Actions: conversions, saturation, the same visible
+  timings across a micros() wraparound, and long running actions. Benchmarks the per-frame
+  cost of the actions, and the per-frame timing math against the double seconds it replaced.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include <memory>
+#include "native.hpp"
+#include "native_benchmark.hpp"
+#include "setup.hpp"
+#include "display_action_text.hpp"
+#include "display_action_price.hpp"
+#include "data_source.hpp"
+
+extern DisplayT *g_display;
+extern DataSource *g_data_source;
+
+using namespace Display;
+
+namespace {
+const uint32_t c_frame_us = 33000;
+
+TextView view(const char *text)
+{
+  return TextView{text, strlen(text)};
+}
+
+// number of display ticks, c_frame_us apart, until a StaticText of given duration has finished
+int ticksUntilFinished(const uint32_t start_us, const double duration)
+{
+  std::unique_ptr<DisplayT> display(Native::createDisplay());
+  Native::setMicros(start_us);
+  display->tick(); // nothing queued, takes the start time
+  auto text = std::make_shared<Action::StaticText>("12:34", duration);
+  display->queueAction(text);
+
+  int ticks = 0;
+  while (!text->isFinished() && ticks < 1000) {
+    Native::advanceMicros(c_frame_us);
+    display->tick();
+    ++ticks;
+  }
+  return ticks;
+}
+
+// renders a frame, elapsed_us after the previous one
+void frame(const uint32_t elapsed_us)
+{
+  Native::advanceMicros(elapsed_us);
+  g_display->tick();
+}
+
+/* per frame timing math of the old double timebase, for the benchmark: the tick's conversion
+   to seconds, elapsed time and duration check, rotating text offset, slide position and the
+   price animation step */
+struct DoubleTimebase {
+  double elapsed;
+  double duration;
+  int speed;
+  int width;
+
+  int frame(const uint32_t delta_us)
+  {
+    const double elapsed_time = delta_us / 1000000.0;
+    elapsed += elapsed_time;
+    const bool finished = elapsed > duration;
+    const int offset = (int) (elapsed * speed) % width;
+    const double position = fmod(elapsed, 1.0);
+    const double slide = std::max(std::min(0.5 + sin((position-0.5)*M_PI)*0.5, 1.0), 0.0);
+    const int slide_offset = round(slide * 32);
+    const double step = elapsed_time * 10 * 1.5 * 0.01;
+    return finished + offset + slide_offset + (int) (step * 1000);
+  }
+};
+
+// the same, as done by the actions now
+struct IntegerTimebase {
+  uint32_t elapsed;
+  uint32_t scroll_time;
+  duration_t duration;
+  int speed;
+  int width;
+
+  int frame(const uint32_t delta_us)
+  {
+    elapsed = addSaturating(elapsed, delta_us);
+    const bool finished = elapsed > (uint32_t) duration;
+    scroll_time = (scroll_time + delta_us) % ((uint32_t) width * 1000000 / speed);
+    const int offset = unitsInTime(scroll_time, speed) % width;
+    const uint16_t position = Easing::position(elapsed % 1000000, 1000000);
+    const int slide_offset = Easing::scale(Easing::Curve::EASE_IN_OUT, position, 32);
+    const int64_t step = (int64_t) delta_us * 10 * 1500 / 1000000 * 10000000 / Price::c_delta_unit;
+    return finished + offset + slide_offset + (int) (step / 10000);
+  }
+};
+
+volatile int g_sink;
+}
+
+void setUp(void)
+{
+  g_display->cleanQueue();
+  g_display->tick(); // nothing queued, takes the start time
+}
+
+void tearDown(void)
+{
+  g_display->cleanQueue();
+  Native::setMicros(0);
+}
+
+void test_durations_convert_to_microseconds(void)
+{
+  TEST_ASSERT_EQUAL(-1, toDuration(-1.0));
+  TEST_ASSERT_EQUAL(0, toDuration(0.0));
+  TEST_ASSERT_EQUAL(1500000, toDuration(1.5));
+  TEST_ASSERT_EQUAL(300000000, toDuration(300.0));
+  TEST_ASSERT_EQUAL(INT32_MAX, toDuration(3600.0));
+}
+
+void test_time_arithmetic_does_not_overflow(void)
+{
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, addSaturating(UINT32_MAX - 5, 10));
+  TEST_ASSERT_EQUAL_UINT32(15, addSaturating(5, 10));
+  TEST_ASSERT_EQUAL(4294967, unitsInTime(UINT32_MAX, 1000));
+  TEST_ASSERT_EQUAL(33, unitsInTime(c_frame_us, 1000));
+}
+
+void test_timings_are_the_same_across_micros_wraparound(void)
+{
+  const int ticks = ticksUntilFinished(1000000, 1.0);
+  TEST_ASSERT_EQUAL(31, ticks); // first tick past 1 s
+  TEST_ASSERT_EQUAL(ticks, ticksUntilFinished(UINT32_MAX - 500000, 1.0));
+  TEST_ASSERT_EQUAL(ticksUntilFinished(1000000, 2.5), ticksUntilFinished(UINT32_MAX - 1000, 2.5));
+}
+
+void test_rotating_text_keeps_scrolling(void)
+{
+  g_display->queueAction(std::make_shared<Action::RotatingText>("Bitcoin 6543.21", -1, 20));
+  for (int i=0;i<4;++i)
+    frame(UINT32_MAX); // far beyond the range of the elapsed time
+
+  frame(c_frame_us);
+  uint32_t hash = g_display->getFrameHash();
+  int changed = 0;
+  for (int i=0;i<30;++i) {
+    frame(c_frame_us * 2);
+    changed += (g_display->getFrameHash() != hash);
+    hash = g_display->getFrameHash();
+  }
+  TEST_ASSERT_GREATER_THAN(25, changed);
+}
+
+void test_price_stays_timed_out(void)
+{
+  auto price_action = std::make_shared<PriceAction>(10);
+  price_action->setPriceTimeout(300.0);
+  g_display->queueAction(price_action);
+  price_action->updatePrice(view("6543.21"));
+
+  frame(c_frame_us);
+  const uint32_t price_hash = g_display->getFrameHash();
+  frame(301 * 1000000);
+  const uint32_t timed_out_hash = g_display->getFrameHash();
+  TEST_ASSERT_NOT_EQUAL(price_hash, timed_out_hash);
+
+  for (int i=0;i<4;++i) // past 71 minutes, where a wrapping counter would show the price again
+    frame(3600u * 1000000);
+  TEST_ASSERT_EQUAL_HEX32(timed_out_hash, g_display->getFrameHash());
+}
+
+void test_benchmark_frame_cost(void)
+{
+  auto price_action = std::make_shared<PriceAction>(10);
+  g_display->queueAction(price_action);
+  price_action->updatePrice(view("6543.21"));
+  uint32_t frames = 0;
+  const char *prices[] = { "6543.21", "6549.87" };
+  NativeBenchmark::measure("frame, animating price", [&]() {
+    if (++frames % 8 == 0)
+      price_action->updatePrice(view(prices[(frames / 8) % 2]));
+    frame(c_frame_us);
+  });
+  g_display->cleanQueue();
+
+  g_display->queueAction(std::make_shared<Action::RotatingText>("Bitcoin 6543.21", -1, 20));
+  NativeBenchmark::measure("frame, rotating text", []() { frame(c_frame_us); });
+  g_display->cleanQueue();
+
+  auto slide = std::make_shared<Action::SlideTransition>(
+    std::make_shared<Action::StaticText>("12:34", -1), 1, std::make_shared<Action::StaticText>("6543", -1), 0,
+    1.0, Coords{0,1});
+  g_display->queueAction(slide);
+  NativeBenchmark::measure("frame, slide transition", [&]() {
+    if (slide->isFinished()) {
+      slide->reset();
+      g_display->queueAction(slide);
+    }
+    frame(c_frame_us);
+  });
+
+  DoubleTimebase before = { 0.0, 1000.0, 20, 90 };
+  IntegerTimebase after = { 0, 0, toDuration(1000.0), 20, 90 };
+  NativeBenchmark::measure("timing math, double (before)", [&]() { g_sink = before.frame(c_frame_us); });
+  NativeBenchmark::measure("timing math, integer (after)", [&]() { g_sink = after.frame(c_frame_us); });
+  TEST_MESSAGE("the host has an FPU; on the ESP8266 every double operation is a soft-float call");
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setMicros(0);
+  Native::setupParameters();
+  g_display = Native::createDisplay();
+  g_data_source = new DataSource; // receives the data timeout warning
+
+  UNITY_BEGIN();
+  RUN_TEST(test_durations_convert_to_microseconds);
+  RUN_TEST(test_time_arithmetic_does_not_overflow);
+  RUN_TEST(test_timings_are_the_same_across_micros_wraparound);
+  RUN_TEST(test_rotating_text_keeps_scrolling);
+  RUN_TEST(test_price_stays_timed_out);
+  RUN_TEST(test_benchmark_frame_cost);
+  return UNITY_END();
+}
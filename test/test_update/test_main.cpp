@@ -0,0 +1,210 @@
+/* 
+  Cryptoclock ESP8266
+  Copyright (C) 2018 www.cryptoclock.net <info@cryptoclock.net>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+  Firmware updates over HTTP against the fake server behind WiFiClient: the background check
+  (UpdateCheck) with its RTC cache, and the download (Firmware::update) with its fallback from
+  a delta patch to the full image.
+*/
+
+#include "config_common.hpp"
+#include <Arduino.h>
+#include <unity.h>
+#include <ESP8266WiFi.h>
+#include <Updater.h>
+#include <MD5Builder.h>
+#include <vector>
+#include "native.hpp"
+#include "setup.hpp"
+#include "firmware.hpp"
+#include "update_check.hpp"
+
+namespace {
+typedef std::vector<uint8_t> Bytes;
+
+const char *c_update_url = "update.example.com";
+Bytes g_sketch;
+
+Bytes image(const size_t size, uint32_t seed)
+{
+  Bytes data;
+  for (size_t i=0;i<size;++i) {
+    seed = seed * 1103515245 + 12345;
+    data.push_back((seed >> 16) & 0xFF);
+  }
+  return data;
+}
+
+String md5(const Bytes& data)
+{
+  MD5Builder md5;
+  md5.begin();
+  md5.add(data.data(), data.size());
+  md5.calculate();
+  return md5.toString();
+}
+
+// raw HTTP response, the Content-Length is the body's unless given
+void serve(const String& status, const String& headers, const Bytes& body = Bytes(), int length = -1)
+{
+  if (length == -1)
+    length = body.size();
+  const String head = "HTTP/1.1 " + status + "\r\n" + headers + "Content-Length: " + String(length) +
+    "\r\nConnection: close\r\n\r\n";
+  Bytes response(head.c_str(), head.c_str() + head.length());
+  response.insert(response.end(), body.begin(), body.end());
+  WiFiClient::serve(response);
+}
+
+Firmware::Check check()
+{
+  UpdateCheck check;
+  check.start(c_update_url);
+  for (int i=0;i<100 && !check.loop();++i)
+    ;
+  TEST_ASSERT_EQUAL(UpdateCheck::State::DONE, check.getState());
+  return check.getResult();
+}
+
+bool requested(const size_t index, const char *text)
+{
+  return index < WiFiClient::getRequests().size() && WiFiClient::getRequests()[index].indexOf(text) != -1;
+}
+}
+
+void setUp(void)
+{
+  WiFiClient::reset();
+  uint32_t cleared[3] = {}; // UpdateCheck's cache
+  ESP.rtcUserMemoryWrite(32, cleared, sizeof(cleared));
+}
+
+void tearDown(void)
+{
+}
+
+void test_check_asks_with_head(void)
+{
+  serve("304 Not Modified", "");
+  TEST_ASSERT_EQUAL(Firmware::Check::NO_UPDATE, check());
+  TEST_ASSERT_EQUAL(1, (int) WiFiClient::getRequests().size());
+  TEST_ASSERT_TRUE(requested(0, "update.example.com:80\nHEAD /esp/update?md5="));
+  TEST_ASSERT_TRUE(requested(0, ("x-ESP8266-sketch-md5: " + md5(g_sketch) + "\r\n").c_str()));
+}
+
+void test_check_caches_no_update(void)
+{
+  serve("304 Not Modified", "");
+  TEST_ASSERT_EQUAL(Firmware::Check::NO_UPDATE, check());
+  for (int boot=0;boot<8;++boot) // served from RTC memory
+    TEST_ASSERT_EQUAL(Firmware::Check::NO_UPDATE, check());
+  TEST_ASSERT_EQUAL(1, (int) WiFiClient::getRequests().size());
+
+  serve("200 OK", "");
+  TEST_ASSERT_EQUAL(Firmware::Check::AVAILABLE, check()); // the cache is good for 8 boots
+  TEST_ASSERT_EQUAL(2, (int) WiFiClient::getRequests().size());
+}
+
+void test_check_fails_without_server(void)
+{
+  TEST_ASSERT_EQUAL(Firmware::Check::FAILED, check());
+  serve("500 Internal Server Error", "");
+  TEST_ASSERT_EQUAL(Firmware::Check::FAILED, check());
+  serve("304 Not Modified", "");
+  TEST_ASSERT_EQUAL(Firmware::Check::NO_UPDATE, check()); // failures aren't cached
+}
+
+void test_update_downloads_image(void)
+{
+  const Bytes update = image(5000, 3);
+  serve("200 OK", "x-MD5: " + md5(update) + "\r\n", update);
+  uint32_t progress = 0;
+  const auto result = Firmware::update(c_update_url, [&progress](uint32_t written, uint32_t total) {
+    TEST_ASSERT_EQUAL_UINT32(5000, total);
+    progress = written;
+  });
+  TEST_ASSERT_EQUAL(Firmware::Status::UPDATED, result.status);
+  TEST_ASSERT_EQUAL_UINT32(5000, result.bytes);
+  TEST_ASSERT_EQUAL_UINT32(5000, progress);
+  TEST_ASSERT_FALSE(result.delta);
+  TEST_ASSERT_TRUE(Update.getImage() == update);
+  TEST_ASSERT_TRUE(requested(0, "\r\nx-ESP8266-delta: 1\r\n"));
+}
+
+void test_update_without_update(void)
+{
+  serve("304 Not Modified", "");
+  TEST_ASSERT_EQUAL(Firmware::Status::NO_UPDATE, Firmware::update(c_update_url).status);
+  TEST_ASSERT_EQUAL(Firmware::Status::NO_UPDATE, Firmware::update("").status);
+  TEST_ASSERT_EQUAL(1, (int) WiFiClient::getRequests().size());
+}
+
+void test_update_falls_back_to_full_image(void)
+{
+  const Bytes update = image(3000, 4);
+  serve("200 OK", "x-Delta: 1\r\n", image(200, 5)); // not a patch
+  serve("200 OK", "x-MD5: " + md5(update) + "\r\n", update);
+  const auto result = Firmware::update(c_update_url);
+  TEST_ASSERT_EQUAL(Firmware::Status::UPDATED, result.status);
+  TEST_ASSERT_FALSE(result.delta);
+  TEST_ASSERT_TRUE(Update.getImage() == update);
+  TEST_ASSERT_EQUAL(2, (int) WiFiClient::getRequests().size());
+  TEST_ASSERT_FALSE(requested(1, "x-ESP8266-delta"));
+}
+
+void test_update_rejects_truncated_image(void)
+{
+  const Bytes update = image(3000, 6);
+  serve("200 OK", "x-MD5: " + md5(update) + "\r\n", update, 4000); // connection lost
+  const auto result = Firmware::update(c_update_url);
+  TEST_ASSERT_EQUAL(Firmware::Status::FAILED, result.status);
+  TEST_ASSERT_FALSE(Update.isRunning());
+}
+
+void test_update_result_survives_restart(void)
+{
+  Firmware::Result result = { Firmware::Status::UPDATED, 1234, 56, true };
+  Firmware::saveResult(result);
+  result = Firmware::Result();
+  TEST_ASSERT_TRUE(Firmware::takeSavedResult(result));
+  TEST_ASSERT_EQUAL(Firmware::Status::UPDATED, result.status);
+  TEST_ASSERT_EQUAL_UINT32(1234, result.bytes);
+  TEST_ASSERT_EQUAL_UINT32(56, result.duration_ms);
+  TEST_ASSERT_TRUE(result.delta);
+  TEST_ASSERT_FALSE(Firmware::takeSavedResult(result)); // once
+}
+
+int main(int argc, char **argv)
+{
+  Serial.setOutput(false);
+  Native::setupParameters();
+  g_sketch = image(6000, 1);
+  Native::setSketch(g_sketch.data(), g_sketch.size());
+
+  UNITY_BEGIN();
+  RUN_TEST(test_check_asks_with_head);
+  RUN_TEST(test_check_caches_no_update);
+  RUN_TEST(test_check_fails_without_server);
+  RUN_TEST(test_update_downloads_image);
+  RUN_TEST(test_update_without_update);
+  RUN_TEST(test_update_falls_back_to_full_image);
+  RUN_TEST(test_update_rejects_truncated_image);
+  RUN_TEST(test_update_result_survives_restart);
+  return UNITY_END();
+}
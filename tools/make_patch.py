@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+#
+# Makes a delta patch between two firmware images, to be served by the update server to devices
+# running the old image (identified by its MD5). The device applies it with DeltaPatch, reading
+# COPY data from its running sketch. See src/delta_patch.hpp for the format.
+#
+#   make_patch.py old.bin new.bin patch.bin    makes a patch, and checks that it applies
+#   make_patch.py --apply old.bin patch.bin new.bin
+
+import hashlib
+import struct
+import sys
+
+MAGIC = b"CCDP"
+VERSION = 1
+HEADER = "<4sB3xII16s"
+OP_END = 0x00
+OP_COPY = 0x01
+OP_INSERT = 0x02
+BLOCK = 16 # shortest copy worth its 9 byte op
+ALIGN = 4 # old image is indexed at this granularity, code and data are mostly word aligned
+
+def make_patch(old, new):
+  index = {}
+  for offset in range(0, len(old) - BLOCK + 1, ALIGN):
+    index.setdefault(old[offset:offset+BLOCK], offset)
+
+  ops = []
+  literal = bytearray()
+  def flush_literal():
+    if literal:
+      ops.append(struct.pack("<BI", OP_INSERT, len(literal)) + bytes(literal))
+      del literal[:]
+
+  position = 0
+  while position < len(new):
+    match = index.get(new[position:position+BLOCK]) if position + BLOCK <= len(new) else None
+    if match is None:
+      literal.append(new[position])
+      position += 1
+      continue
+
+    length = BLOCK
+    while position + length < len(new) and match + length < len(old) and new[position+length] == old[match+length]:
+      length += 1
+    while literal and match > 0 and old[match-1] == literal[-1]:
+      literal.pop()
+      position -= 1
+      match -= 1
+      length += 1
+    flush_literal()
+    ops.append(struct.pack("<BII", OP_COPY, match, length))
+    position += length
+  flush_literal()
+  ops.append(struct.pack("<B", OP_END))
+
+  header = struct.pack(HEADER, MAGIC, VERSION, len(old), len(new), hashlib.md5(new).digest())
+  return header + b"".join(ops)
+
+def apply_patch(old, patch):
+  magic, version, old_size, new_size, md5 = struct.unpack_from(HEADER, patch)
+  if magic != MAGIC or version != VERSION:
+    raise ValueError("invalid patch header")
+  if old_size != len(old):
+    raise ValueError("patch is for an image of %d bytes, not %d" % (old_size, len(old)))
+
+  new = bytearray()
+  position = struct.calcsize(HEADER)
+  while True:
+    op = patch[position] if isinstance(patch[position], int) else ord(patch[position])
+    position += 1
+    if op == OP_END:
+      break
+    elif op == OP_COPY:
+      offset, length = struct.unpack_from("<II", patch, position)
+      position += 8
+      if offset + length > len(old):
+        raise ValueError("copy out of range")
+      new += old[offset:offset+length]
+    elif op == OP_INSERT:
+      length, = struct.unpack_from("<I", patch, position)
+      position += 4
+      new += patch[position:position+length]
+      position += length
+    else:
+      raise ValueError("unknown op %d" % op)
+
+  if position != len(patch):
+    raise ValueError("data after end")
+  if len(new) != new_size or hashlib.md5(new).digest() != md5:
+    raise ValueError("patched image doesn't match")
+  return bytes(new)
+
+def read(name):
+  with open(name, "rb") as f:
+    return f.read()
+
+def write(name, data):
+  with open(name, "wb") as f:
+    f.write(data)
+
+if __name__ == "__main__":
+  if len(sys.argv) == 5 and sys.argv[1] == "--apply":
+    write(sys.argv[4], apply_patch(read(sys.argv[2]), read(sys.argv[3])))
+  elif len(sys.argv) == 4:
+    old, new = read(sys.argv[1]), read(sys.argv[2])
+    patch = make_patch(old, new)
+    apply_patch(old, patch) # never serve a patch that doesn't reproduce the image
+    write(sys.argv[3], patch)
+    print("old md5 %s, new md5 %s, patch %d bytes (%d%% of image)" % (hashlib.md5(old).hexdigest(),
+      hashlib.md5(new).hexdigest(), len(patch), len(patch) * 100 // max(len(new), 1)))
+  else:
+    sys.stderr.write(__doc__ or "usage: make_patch.py old.bin new.bin patch.bin | --apply old.bin patch.bin new.bin\n")
+    sys.exit(1)
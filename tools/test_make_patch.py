@@ -0,0 +1,132 @@
+#!/usr/bin/env python
+#
+# Tests for make_patch.py, generating patches and applying them the way the device does.
+#
+#   python tools/test_make_patch.py
+
+import hashlib
+import os
+import random
+import struct
+import sys
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import make_patch
+
+def random_bytes(rng, length):
+  return bytes(bytearray(rng.getrandbits(8) for _ in range(length)))
+
+def ops(patch):
+  """(op, arguments) of a patch, to check what the generator emitted"""
+  result = []
+  position = struct.calcsize(make_patch.HEADER)
+  while True:
+    op = bytearray(patch[position:position+1])[0]
+    position += 1
+    if op == make_patch.OP_END:
+      return result
+    elif op == make_patch.OP_COPY:
+      result.append((op, struct.unpack_from("<II", patch, position)))
+      position += 8
+    else:
+      length, = struct.unpack_from("<I", patch, position)
+      result.append((op, (length,)))
+      position += 4 + length
+
+def build_patch(old, new, body):
+  header = struct.pack(make_patch.HEADER, make_patch.MAGIC, make_patch.VERSION, len(old), len(new),
+    hashlib.md5(new).digest())
+  return header + body + struct.pack("<B", make_patch.OP_END)
+
+class RoundTrip(unittest.TestCase):
+  def setUp(self):
+    self.rng = random.Random(20181)
+    self.old = random_bytes(self.rng, 64 * 1024)
+
+  def round_trip(self, new):
+    patch = make_patch.make_patch(self.old, new)
+    self.assertEqual(make_patch.apply_patch(self.old, patch), new)
+    return patch
+
+  def test_identical(self):
+    patch = self.round_trip(self.old)
+    self.assertEqual(ops(patch), [(make_patch.OP_COPY, (0, len(self.old)))])
+
+  def test_random_image(self):
+    patch = self.round_trip(random_bytes(self.rng, 50 * 1024))
+    self.assertTrue(all(op == make_patch.OP_INSERT for op, _ in ops(patch)))
+
+  def test_random_edits(self):
+    for _ in range(20):
+      new = bytearray(self.old)
+      for _ in range(self.rng.randint(1, 30)):
+        offset = self.rng.randrange(len(new))
+        kind = self.rng.randint(0, 2)
+        if kind == 0:
+          new[offset:offset+1] = random_bytes(self.rng, 1)
+        elif kind == 1:
+          new[offset:offset] = random_bytes(self.rng, self.rng.randint(1, 300))
+        else:
+          del new[offset:offset+self.rng.randint(1, 300)]
+      patch = self.round_trip(bytes(new))
+      self.assertLess(len(patch), len(new) // 4)
+
+  def test_shifted(self):
+    for shift in (1, 2, 3, 4, 4096 + 3):
+      patch = self.round_trip(random_bytes(self.rng, shift) + self.old)
+      self.assertLess(len(patch), 2 * shift + 200)
+
+  def test_inserted(self):
+    inserted = random_bytes(self.rng, 1000)
+    patch = self.round_trip(self.old[:30001] + inserted + self.old[30001:])
+    self.assertLess(len(patch), len(inserted) + 200)
+
+  def test_truncated_and_appended(self):
+    self.round_trip(self.old[:-777])
+    self.round_trip(self.old + random_bytes(self.rng, 777))
+    self.round_trip(self.old[:10]) # shorter than a block
+    self.round_trip(b"")
+
+class Rejection(unittest.TestCase):
+  def setUp(self):
+    rng = random.Random(7)
+    self.old = random_bytes(rng, 4096)
+    self.new = self.old[:1000] + random_bytes(rng, 100) + self.old[1000:]
+
+  def test_wrong_old_size(self):
+    patch = make_patch.make_patch(self.old, self.new)
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old[:-1], patch)
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old + b"\0", patch)
+
+  def test_copy_out_of_range(self):
+    for offset, length in ((len(self.old) - 10, 11), (len(self.old), 1), (0xFFFFFFFF, 2)):
+      body = struct.pack("<BII", make_patch.OP_COPY, offset, length)
+      self.assertRaises(ValueError, make_patch.apply_patch, self.old, build_patch(self.old, self.new, body))
+
+  def test_data_after_end(self):
+    patch = make_patch.make_patch(self.old, self.new)
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old, patch + b"\0")
+
+  def test_corrupted_data(self):
+    inserted = self.new[1000:1100]
+    body = struct.pack("<BII", make_patch.OP_COPY, 0, 1000)
+    body += struct.pack("<BI", make_patch.OP_INSERT, len(inserted)) + inserted
+    body += struct.pack("<BII", make_patch.OP_COPY, 1000, len(self.old) - 1000)
+    self.assertEqual(make_patch.apply_patch(self.old, build_patch(self.old, self.new, body)), self.new)
+
+    corrupted = bytearray(body)
+    corrupted[9 + 5 + 50] ^= 0xFF # in the inserted data
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old, build_patch(self.old, self.new, bytes(corrupted)))
+
+  def test_invalid_header(self):
+    patch = make_patch.make_patch(self.old, self.new)
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old, b"XXXX" + patch[4:])
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old, patch[:4] + b"\x02" + patch[5:])
+
+  def test_unknown_op(self):
+    body = struct.pack("<B", 0x7F)
+    self.assertRaises(ValueError, make_patch.apply_patch, self.old, build_patch(self.old, self.new, body))
+
+if __name__ == "__main__":
+  unittest.main()